@@ -0,0 +1,72 @@
+// Churn example: the renderer with a light, plus a producer thread that
+// creates and destroys small spheres through the thread-safe scene queue
+// (Renderer::createSphere / destroySphere). It churns for a few seconds,
+// then destroys everything it made and idles, so each idle phase shows the
+// scene back to the light alone. Runs until the window is closed.
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <random>
+#include <thread>
+
+#include "Renderer/renderer.h"
+
+// Spheres created (and as many destroyed) per batch, batches per second,
+// how many stay alive, and the length of the churn / idle phases
+static const int CHURN_BATCH = 20;
+static const int CHURN_BATCHES_PER_SECOND = 100;
+static const size_t CHURN_LIVE = 1000;
+static const int CHURN_SECONDS = 5;
+static const int IDLE_SECONDS = 3;
+
+// Small spheres at random spots around the origin, the oldest destroyed
+// once CHURN_LIVE exist (every one of them shares one mesh)
+static void churnLoop(Renderer& renderer, const std::atomic<bool>& running) {
+    using Clock = std::chrono::steady_clock;
+    Sphere proto;
+    proto.Name = "Churn";
+    proto.geometry = CubeSphere(0.05f, 4);
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<double> coord(-6.0, 6.0);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::deque<SceneId> live;
+
+    while (running) {
+        Clock::time_point phaseEnd = Clock::now() + std::chrono::seconds(CHURN_SECONDS);
+        while (running && Clock::now() < phaseEnd) {
+            for (int i = 0; i < CHURN_BATCH; ++i) {
+                proto.Color = glm::vec3(unit(rng), unit(rng), unit(rng));
+                live.push_back(renderer.createSphere(proto, glm::dvec3(coord(rng), coord(rng), coord(rng))));
+                if (live.size() > CHURN_LIVE) {
+                    renderer.destroySphere(live.front());
+                    live.pop_front();
+                }
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1000 / CHURN_BATCHES_PER_SECOND));
+        }
+
+        for (SceneId id : live) renderer.destroySphere(id);
+        live.clear();
+        phaseEnd = Clock::now() + std::chrono::seconds(IDLE_SECONDS);
+        while (running && Clock::now() < phaseEnd) std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+}
+
+int main() {
+    Renderer renderer;
+    renderer.init();
+
+    Sphere light;
+    light.Name   = "Light";
+    light.Color  = {1.0f, 1.0f, 1.0f};
+    light.source = true;
+    light.setRadius(0.3f);
+    renderer.drawSphere(light, {0.0f, 0.0f, -1.0f});
+
+    std::atomic<bool> running{true};
+    std::thread producer(churnLoop, std::ref(renderer), std::cref(running));
+    renderer.runRenderLoop();
+    running = false;
+    producer.join();
+    return 0;
+}
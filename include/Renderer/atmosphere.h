@@ -0,0 +1,97 @@
+#ifndef ATMOSPHERE_H
+#define ATMOSPHERE_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "shader.h"         // LUT / sky programs (via ShaderVariants)
+#include "glstate.h"        // Binds + counters
+
+// Scattering medium of a planet's atmosphere (Earth defaults: Rayleigh, Mie
+// and an ozone layer). Heights and coefficients are in planet radii, so the
+// same parameters fit a sphere of any size.
+struct AtmosphereParams {
+    float     thickness           = 0.01572f;                  // Top above the ground (100 km)
+    glm::vec3 rayleighScattering  = {36.90f, 86.23f, 210.5f};  // At ground level, per radius
+    float     rayleighScaleHeight = 0.001258f;                 // 8 km
+    float     mieScattering       = 25.41f;
+    float     mieAbsorption       = 27.98f;
+    float     mieScaleHeight      = 0.0001887f;                // 1.2 km
+    float     mieG                = 0.8f;                      // Cornette-Shanks asymmetry
+    glm::vec3 ozoneAbsorption     = {4.134f, 11.96f, 0.5406f}; // At the peak of the layer
+    float     ozoneCenter         = 0.003931f;                 // Tent profile peaking at 25 km...
+    float     ozoneWidth          = 0.002358f;                 // ...and gone 15 km either side
+    float     sunIntensity        = 4.0f;                      // Sun illuminance = light colour * this
+
+    // Stretch every height by `factor` keeping the optical depths (a visible shell on small spheres)
+    void exaggerate(float factor);
+    // True when the parameter-only LUTs differ between the two (sun intensity excluded)
+    bool scatteringDiffers(const AtmosphereParams& other) const;
+};
+
+// Precomputed atmospheric scattering for one planet sphere (after Hillaire,
+// "A Scalable and Production Ready Sky and Atmosphere Rendering Technique").
+// Compute passes fill three lookup tables:
+//   transmittance    - (height, zenith cosine) -> transmittance to the top
+//   multi-scattering - (height, sun cosine) -> isotropic multiple scattering
+//   sky-view         - view direction from the camera -> in-scattered light
+// The first two depend only on the parameters and ground albedo and are
+// rebuilt when those change; the sky-view table follows the camera and sun
+// and is refreshed every frame at 192x108. Surfaces and the sky then shade
+// with a handful of fetches instead of nested ray marches per pixel.
+class Atmosphere {
+public:
+    static const int TRANSMITTANCE_WIDTH   = 256;
+    static const int TRANSMITTANCE_HEIGHT  = 64;
+    static const int MULTI_SCATTERING_SIZE = 32;
+    static const int SKY_VIEW_WIDTH        = 192;
+    static const int SKY_VIEW_HEIGHT       = 108;
+
+    void init(ShaderVariants& shaders, GLState& state);    // LUT textures + programs
+
+    // Rebuild the parameter LUTs if needed, then the sky-view LUT for this frame
+    void update(const AtmosphereParams& params, const glm::vec3& groundAlbedo,
+                const glm::vec3& center, float radius,
+                const glm::vec3& sunPosition, const glm::vec3& sunColor,
+                const glm::vec3& viewPos);
+
+    // LUTs (units 0-2) + planet / sun / medium uniforms for a shading program
+    void bind(Shader& shader) const;
+
+    // Sky in-scattering over the bound scene target where nothing was drawn
+    // (full-screen at the far plane, additive)
+    void renderSky(const glm::mat4& inverseViewProjection, int width, int height);
+
+    unsigned int precomputeCount() const;   // Transmittance + multi-scattering rebuilds so far
+    void terminate();                       // Release GL objects
+
+private:
+    GLState*     state = nullptr;
+    Shader*      transmittanceShader = nullptr;
+    Shader*      multiScatteringShader = nullptr;
+    Shader*      skyViewShader = nullptr;
+    Shader*      skyShader = nullptr;
+
+    unsigned int transmittanceLut = 0;      // RGBA16F LUTs
+    unsigned int multiScatteringLut = 0;
+    unsigned int skyViewLut = 0;
+    unsigned int fullscreenVAO = 0;         // Attribute-less full-screen triangle
+
+    // Inputs of the current LUTs
+    AtmosphereParams params;
+    glm::vec3        albedo{0.0f};
+    bool             built = false;
+    unsigned int     rebuilds = 0;
+
+    // This frame's planet, sun and camera (world space)
+    glm::vec3        center{0.0f};
+    float            radius = 1.0f;
+    glm::vec3        sunDirection{0.0f, 1.0f, 0.0f};
+    glm::vec3        sunIlluminance{1.0f};
+    glm::vec3        viewPos{0.0f};
+
+    void setMedium(Shader& shader) const;                      // Parameter uniforms
+    void fill(Shader& shader, unsigned int lut, int groupsX, int groupsY);  // One LUT pass
+};
+
+#endif
@@ -25,7 +25,9 @@ const float SENSITIVITY = 0.1f;
 
 class Camera {
 public:
-    // Camera world-space position
+    // Camera world-space position (double: stays exact far from the origin)
+    glm::dvec3 WorldPosition;
+    // Position relative to the renderer's render origin (what the GPU sees)
     glm::vec3 Position;
     // Forward facing vector
     glm::vec3 Front;
@@ -53,6 +55,8 @@ public:
 
     // Return the view matrix based on current orientation
     glm::mat4 getViewMatrix();
+    // Re-express Position relative to a new render origin
+    void setRenderOrigin(const glm::dvec3& origin);
     // Apply keyboard movement for a direction and frame delta
     void processKeyboard(cameraMovement movement, float deltaTime);
     // Apply mouse movement offsets to yaw and pitch
@@ -63,4 +67,11 @@ private:
     void updateCameraVectors();
 };
 
+// Perspective projection with the far plane at infinity. Reversed maps the
+// near plane to depth 1 and infinity to 0 (for the [0, 1] clip range of
+// GLState::enableReversedDepth); otherwise the standard OpenGL mapping
+glm::mat4 infiniteProjection(float fovy, float aspect, float zNear, bool reversed);
+// Same with a finite far plane (reversed: far plane at depth 0)
+glm::mat4 perspectiveProjection(float fovy, float aspect, float zNear, float zFar, bool reversed);
+
 #endif
\ No newline at end of file
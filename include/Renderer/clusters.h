@@ -0,0 +1,62 @@
+#ifndef CLUSTERS_H
+#define CLUSTERS_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <string>
+#include <vector>
+
+#include "shader.h"         // Compute program (via ShaderVariants)
+#include "glstate.h"        // Binds + counters
+
+// One point light as stored in the light SSBO (std430)
+struct PointLight {
+    glm::vec4 positionRange;    // xyz world position, w range (light has no effect beyond it)
+    glm::vec4 color;            // rgb colour, a unused
+};
+
+// Clustered forward lighting.
+// The view frustum is split into GRID_X x GRID_Y screen tiles and GRID_Z
+// exponential depth slices ("froxels"). A compute pass tests every light
+// against every cluster's view-space AABB and writes a per-cluster light
+// index list; lit fragments then only loop over their own cluster's lights.
+class ClusteredLights {
+public:
+    static const unsigned int GRID_X = 16;
+    static const unsigned int GRID_Y = 9;
+    static const unsigned int GRID_Z = 24;
+    static const unsigned int MAX_LIGHTS_PER_CLUSTER = 128;
+
+    // SSBO binding points shared with shaders/clusters.glsl
+    static const unsigned int LIGHTS_BINDING  = 3;
+    static const unsigned int GRID_BINDING    = 4;
+    static const unsigned int INDICES_BINDING = 5;
+
+    void init(ShaderVariants& shaders, GLState& state);   // Buffers + cull program
+
+    // Defines every clustered shader variant must be built with
+    static std::vector<std::string> defines();
+
+    // Upload lights and rebuild the per-cluster lists for this camera
+    void update(const std::vector<PointLight>& lights,
+                const glm::mat4& view, const glm::mat4& projection,
+                int screenWidth, int screenHeight);
+
+    // Bind the light buffers + set the lookup uniforms on a shading program
+    void bind(Shader& shader);
+
+    unsigned int lightCount() const;                   // Lights in the last update
+    void terminate();                                  // Release GL objects
+
+private:
+    GLState*     state = nullptr;
+    Shader*      cullShader = nullptr;
+    unsigned int lightBuffer = 0;       // PointLight[]
+    unsigned int gridBuffer = 0;        // uint count per cluster
+    unsigned int indexBuffer = 0;       // uint[MAX_LIGHTS_PER_CLUSTER] per cluster
+    size_t       capacity = 0;          // Lights lightBuffer can hold
+    unsigned int count = 0;
+    glm::vec2    screenSize{1.0f};
+};
+
+#endif
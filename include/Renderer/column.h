@@ -0,0 +1,119 @@
+#ifndef COLUMN_H
+#define COLUMN_H
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+// Storage for Column (64-byte aligned; blocks of 2 MB and up are advised to use huge pages)
+void* allocateColumn(size_t bytes);
+void releaseColumn(void* data);
+
+// Growable array of trivially copyable values: the storage behind the
+// entity and transform columns. It has the std::vector operations those
+// use, plus two ways for bulk loads to skip first-touch work (which
+// dominates loading millions of rows): resizeUninitialized() leaves the
+// new elements unwritten, so their pages stay untouched until first use,
+// and adopt() turns the column into a view of memory owned elsewhere (a
+// private, copy-on-write file mapping) that `owner` keeps alive. An adopted
+// column moves to the heap the first time it has to grow.
+template <typename T>
+class Column {
+    static_assert(std::is_trivially_copyable<T>::value, "columns are copied with memcpy");
+
+public:
+    Column() = default;
+    Column(const Column& other) { append(other.items, other.count); }
+    Column(Column&& other) noexcept { swap(other); }
+    Column& operator=(Column other) noexcept { swap(other); return *this; }
+    ~Column() { release(); }
+
+    // View `size` elements at `data` (writable, valid as long as `owner` is)
+    void adopt(T* data, size_t size, std::shared_ptr<void> owner) {
+        release();
+        items = data;
+        count = allocated = size;
+        keepAlive = std::move(owner);
+    }
+    bool adopted() const { return keepAlive != nullptr; }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    size_t capacity() const { return allocated; }
+    T* data() { return items; }
+    const T* data() const { return items; }
+    T& operator[](size_t i) { return items[i]; }
+    const T& operator[](size_t i) const { return items[i]; }
+    T* begin() { return items; }
+    T* end() { return items + count; }
+    const T* begin() const { return items; }
+    const T* end() const { return items + count; }
+    T& back() { return items[count - 1]; }
+    const T& back() const { return items[count - 1]; }
+
+    void reserve(size_t n) {
+        if (n > allocated) reallocate(n);
+    }
+    void resizeUninitialized(size_t n) {        // New elements hold garbage until written
+        if (n > allocated) reallocate(grown(n));
+        count = n;
+    }
+    void resize(size_t n, const T& value = T()) {
+        size_t old = count;
+        T fill = value;                         // May live in this column
+        resizeUninitialized(n);
+        for (size_t i = old; i < n; ++i) items[i] = fill;
+    }
+    void push_back(const T& value) {
+        T copy = value;
+        if (count == allocated) reallocate(grown(count + 1));
+        items[count++] = copy;
+    }
+    void pop_back() { --count; }
+    void append(const T* values, size_t n) {   // `values` must not point into this column
+        if (n == 0) return;
+        size_t old = count;
+        resizeUninitialized(count + n);
+        std::memcpy(items + old, values, n * sizeof(T));
+    }
+    void clear() {                              // Keeps heap capacity, drops an adopted view
+        if (keepAlive) release();
+        count = 0;
+    }
+    void swap(Column& other) noexcept {
+        std::swap(items, other.items);
+        std::swap(count, other.count);
+        std::swap(allocated, other.allocated);
+        keepAlive.swap(other.keepAlive);
+    }
+
+private:
+    T*     items = nullptr;
+    size_t count = 0;
+    size_t allocated = 0;
+    std::shared_ptr<void> keepAlive;            // Owner of adopted memory (null = heap)
+
+    size_t grown(size_t n) const {
+        size_t doubled = allocated * 2 > 16 ? allocated * 2 : 16;
+        return n > doubled ? n : doubled;
+    }
+    void reallocate(size_t n) {
+        T* fresh = static_cast<T*>(allocateColumn(n * sizeof(T)));
+        if (count) std::memcpy(fresh, items, count * sizeof(T));
+        size_t kept = count;
+        release();
+        items = fresh;
+        count = kept;
+        allocated = n;
+    }
+    void release() {
+        if (items && !keepAlive) releaseColumn(items);
+        keepAlive.reset();
+        items = nullptr;
+        count = allocated = 0;
+    }
+};
+
+#endif
@@ -25,6 +25,10 @@ public:
     const unsigned int getSubdivisions() const; // Returns current subdivision count
     const float getRadius() const;              // Returns current radius
 
+    // Unit direction through (u, v) in [0,1]^2 of face 0-5 (+X -X +Y -Y +Z -Z),
+    // u along the face's columns, v down its rows (the layout of buildFaceVertices)
+    static void faceDirection(unsigned int face, float u, float v, float dir[3]);
+
 private:
     // Face axis identifiers
     typedef enum face {
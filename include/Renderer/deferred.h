@@ -0,0 +1,61 @@
+#ifndef DEFERRED_H
+#define DEFERRED_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "shader.h"         // Light / ambient programs (via ShaderVariants)
+#include "glstate.h"        // Binds + counters
+#include "cubesphere.h"     // Low-subdivision light volume mesh
+#include "clusters.h"       // PointLight layout
+
+// Deferred shading path.
+// Geometry pass fills a compact G-buffer (RGBA8 albedo + RG16_SNORM
+// octahedral normal + depth/stencil; position is reconstructed from depth),
+// then every light is accumulated into an RGBA16F target by rasterising a
+// low-subdivision CubeSphere volume: a stencil pass marks pixels whose
+// surface lies inside the volume, a lighting pass shades only those.
+class DeferredRenderer {
+public:
+    void init(ShaderVariants& shaders, GLState& state);   // Programs + light volume mesh
+    void resize(int width, int height);                   // Render size (targets grow when needed)
+
+    void beginGeometry();           // Bind + clear the G-buffer (caller draws with a GBUFFER program)
+    void endGeometry();             // Snapshot depth for sampling during the light passes
+
+    // Ambient + one stencil-tested volume per light into the accumulation target
+    void lightPass(const std::vector<PointLight>& lights,
+                   const glm::mat4& view, const glm::mat4& projection,
+                   const glm::vec3& viewPos);
+
+    void bindAccumulation();        // Forward draws (emissive markers) on top, depth-tested
+    void present(unsigned int target);  // Copy colour + depth to the scene framebuffer
+
+    void terminate();               // Release GL objects
+
+private:
+    GLState*     state = nullptr;
+    Shader*      ambientShader = nullptr;   // Full-screen ambient term
+    Shader*      lightShader = nullptr;     // Per-light volume shading
+    Shader*      stencilShader = nullptr;   // Light volume, no colour
+
+    int          width = 0, height = 0;             // Render size
+    int          allocWidth = 0, allocHeight = 0;   // Target size
+    unsigned int gbuffer = 0;               // FBO: albedo + normal + depthStencil
+    unsigned int accumulation = 0;          // FBO: light + depthStencil
+    unsigned int albedoTexture = 0;         // RGBA8
+    unsigned int normalTexture = 0;         // RG16_SNORM octahedral
+    unsigned int depthStencil = 0;          // DEPTH24_STENCIL8 (tested / stencil-marked)
+    unsigned int depthCopy = 0;             // DEPTH24_STENCIL8 (sampled; avoids a feedback loop)
+    unsigned int depthCopyFbo = 0;
+    unsigned int lightTexture = 0;          // RGBA16F accumulation
+
+    CubeSphere   volume{1.0f, 4};           // Unit light volume (coarse)
+    unsigned int volumeVAO = 0, volumeVBO = 0, volumeEBO = 0;
+    unsigned int fullscreenVAO = 0;         // Attribute-less full-screen triangle
+
+    void releaseTargets();
+};
+
+#endif
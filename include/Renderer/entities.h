@@ -0,0 +1,97 @@
+#ifndef ENTITIES_H
+#define ENTITIES_H
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+#include "column.h"         // Column storage
+#include "pool.h"           // Generational handles
+
+struct Sphere;              // Cold data (geometry, name, atmosphere), in the renderer's sphere pool
+
+// GL buffer object (renderer's buffer pool); size lets a same-size refill skip reallocation
+struct GpuBuffer {
+    unsigned int name = 0;
+    size_t       size = 0;              // Bytes allocated
+};
+
+// GPU mesh (renderer's mesh pool): one VAO over a vertex + index buffer,
+// shared by every entity with the same geometry
+struct Mesh {
+    unsigned int VAO = 0;
+    uint64_t     key = 0;               // Geometry (subdivisions, radius bits) in the renderer's mesh cache
+    uint32_t     users = 0;             // Entities drawing it
+    PoolHandle<GpuBuffer> vertices;
+    PoolHandle<GpuBuffer> indices;
+    int          indexCount = 0;
+    unsigned int poolFirstIndex = 0;   // Offsets in the pooled visibility-buffer geometry
+    int          poolBaseVertex = 0;
+};
+
+// Per-entity flag bits
+enum EntityFlag : uint32_t {
+    ENTITY_SOURCE          = 1u << 0,   // Light source: emissive marker + point light (lightRange)
+    ENTITY_DYNAMIC         = 1u << 1,   // Moves every frame: redrawn into the shadow map each frame
+    ENTITY_ATMOSPHERE      = 1u << 2,   // Planet shaded through Sphere::atmosphere
+    ENTITY_VIRTUAL_TEXTURE = 1u << 3,   // Planet albedo from the virtual texture
+    ENTITY_REMESH          = 1u << 4,   // Geometry changed: mesh re-uploaded before the next draw
+    ENTITY_SHARED          = 1u << 5    // Cold data shared with other entities (loaded scene): freed with the scene
+};
+
+// Reference to an entity that survives other entities being added or
+// removed; stale once its entity is destroyed (the slot's generation moves on)
+struct EntityHandle {
+    uint32_t slot = ~0u;
+    uint32_t generation = 0;
+};
+
+// Entity-component store of the per-frame sphere state.
+// Every hot field lives in its own dense array (structure of arrays), one
+// row per entity, so a per-frame pass streams just the columns it reads
+// instead of chasing a pointer per sphere into objects that also hold
+// names and CPU geometry. Rows are only valid within a frame: destroy()
+// moves the last row into the hole (O(1)). Outside references use handles,
+// resolved through a slot table with a generation per slot.
+class EntityStore {
+public:
+    // Columns, indexed by row (0 .. size() - 1)
+    Column<glm::dvec3> worldPosition;       // World position (double), from the transform hierarchy
+    Column<glm::vec3>  position;            // worldPosition relative to the render origin
+    Column<float>      radius;              // Geometry radius
+    Column<float>      scale;               // Largest world axis scale (bounds = radius * scale)
+    Column<uint32_t>   transform;           // Node in the renderer's TransformHierarchy
+    Column<glm::vec3>  color;               // Albedo / emitted light colour
+    Column<float>      opacity;             // < 1 = translucent (lit spheres only)
+    Column<float>      lightRange;          // Light influence radius (sources)
+    Column<uint32_t>   flags;               // EntityFlag bits
+    Column<PoolHandle<Mesh>>   mesh;
+    Column<PoolHandle<Sphere>> sphere;      // Cold data
+
+    // New row with default columns (position 0, radius 1, unit scale, white, opaque, no transform)
+    EntityHandle create(PoolHandle<Sphere> cold);
+    void destroy(EntityHandle handle);          // Swap-remove; the handle goes stale
+    // `count` rows at once (a loaded scene), free slots first; returns the
+    // first row. Columns the caller already filled past the last row keep
+    // those values; the rest get the defaults (no cold data), except the
+    // derived worldPosition, position and scale, left for the next
+    // transform update to write.
+    uint32_t append(size_t count);
+    void clear();                               // Destroy every entity (every handle goes stale)
+
+    bool alive(EntityHandle handle) const;
+    uint32_t row(EntityHandle handle) const;    // Current row of a live handle
+    EntityHandle handle(uint32_t row) const;
+    size_t size() const;
+
+    bool isSource(uint32_t row) const;
+    bool translucent(uint32_t row) const;       // Lit and opacity < 1
+
+private:
+    std::vector<uint32_t> slotRow;              // Slot -> row
+    std::vector<uint32_t> slotGeneration;       // Bumped on destroy
+    std::vector<uint32_t> freeSlots;
+    std::vector<uint32_t> rowSlot;              // Row -> slot (fixed up by swap-remove)
+};
+
+#endif
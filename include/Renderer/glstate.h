@@ -0,0 +1,121 @@
+#ifndef GLSTATE_H
+#define GLSTATE_H
+
+#include <glad/glad.h>
+#include <cstdint>
+#include <ostream>
+#include <unordered_map>
+
+// Per-frame GL work counters
+struct GLFrameStats {
+    unsigned int draws          = 0;    // Draw calls issued
+    uint64_t     triangles      = 0;    // Triangles submitted (GL_TRIANGLES draws, upper bound for indirect)
+    unsigned int dispatches     = 0;    // Compute dispatches
+    unsigned int programBinds   = 0;    // glUseProgram calls that reached the driver
+    unsigned int vaoBinds       = 0;    // glBindVertexArray calls that reached the driver
+    unsigned int bufferBinds    = 0;    // glBindBuffer / glBindBufferBase calls
+    unsigned int textureBinds   = 0;    // glBindTexture calls
+    unsigned int framebufferBinds = 0;  // glBindFramebuffer calls
+    unsigned int stateChanges   = 0;    // Depth / blend / cull / stencil state changes
+    unsigned int uniformUploads = 0;    // glUniform* calls
+    uint64_t     bytesUploaded  = 0;    // Uniform + buffer bytes sent to the GL
+    unsigned int redundant      = 0;    // Calls dropped because the state already matched
+};
+
+// Thin shadow of the GL state the renderer touches.
+// Redundant binds/enables are dropped before reaching the driver, and every
+// call that does go through is counted. Anything that changes GL state behind
+// this object's back must call invalidate().
+class GLState {
+public:
+    // --- Frame bookkeeping ---
+    void beginFrame();                          // Reset the running counters
+    void endFrame();                            // Publish this frame's counters
+    const GLFrameStats& frameStats() const;     // Counters of the last completed frame
+    const GLFrameStats& currentStats() const;   // Counters of the frame in progress
+    void dump(std::ostream& out) const;         // One-line summary of the last frame
+    void invalidate();                          // Forget every cached binding/state
+
+    // --- Bindings ---
+    void useProgram(unsigned int program);
+    void bindVertexArray(unsigned int vao);
+    void bindBuffer(GLenum target, unsigned int buffer);
+    void bindBufferBase(GLenum target, unsigned int index, unsigned int buffer);
+    void bindTexture(unsigned int unit, GLenum target, unsigned int texture);
+    void bindFramebuffer(GLenum target, unsigned int framebuffer);
+
+    // --- Fixed-function state ---
+    void setColorWrite(bool enabled);
+    void setDepthTest(bool enabled);
+    void setDepthWrite(bool enabled);
+    void setDepthFunc(GLenum func);
+    void setBlend(bool enabled);
+    void setBlendFunc(GLenum src, GLenum dst);
+    void setBlendFunci(unsigned int buffer, GLenum src, GLenum dst);
+    void setCull(bool enabled);
+    void setCullFace(GLenum face);
+    void setStencilTest(bool enabled);
+
+    // --- Depth convention ---
+    // Reversed depth (GL 4.5 / ARB_clip_control): [0, 1] clip range with the
+    // near plane at 1 and infinity at 0, so a float depth buffer keeps its
+    // precision at any distance. Depth functions are always given in standard
+    // terms (GL_LESS = nearer passes) and mirrored here while reversed; the
+    // depth clear value follows the convention too.
+    bool enableReversedDepth();                 // Load glClipControl and switch; false = unsupported (standard kept)
+    bool reversedDepth() const;                 // Context convention (projections, shader REVERSE_Z)
+    void setStandardDepth(bool standard);       // Back to [-1, 1] and unmirrored for passes with their own projection
+    GLenum depthStencilFormat() const;          // Offscreen depth-stencil attachments (float when reversed)
+
+    // --- Counted work ---
+    void drawElements(GLenum mode, int count, GLenum type, const void* offset);
+    void drawElementsInstanced(GLenum mode, int count, GLenum type, const void* offset, int instances);
+    void drawArrays(GLenum mode, int first, int count);
+    void drawElementsIndirect(GLenum mode, GLenum type, const void* offset,
+                              int count);       // `count` = index count in the command (for stats)
+    void dispatchCompute(unsigned int x, unsigned int y, unsigned int z);
+    void bufferData(GLenum target, size_t size, const void* data, GLenum usage);
+    void bufferSubData(GLenum target, size_t offset, size_t size, const void* data);
+    void countUniform(size_t bytes);            // Called by Shader uniform setters
+
+    // Whether to print dump() at the end of every frame
+    bool dumpEachFrame = false;
+
+private:
+    GLFrameStats current;
+    GLFrameStats last;
+
+    // Cached bindings (~0u = unknown)
+    unsigned int program = ~0u;
+    unsigned int vao = ~0u;
+    unsigned int activeUnit = ~0u;
+    unsigned int drawFramebuffer = ~0u;
+    unsigned int readFramebuffer = ~0u;
+    std::unordered_map<GLenum, unsigned int>   buffers;       // target -> buffer
+    std::unordered_map<uint64_t, unsigned int> bufferBases;   // (target, index) -> buffer
+    std::unordered_map<uint64_t, unsigned int> textures;      // (unit, target) -> texture
+
+    // Cached fixed-function state (-1 = unknown)
+    int    colorWrite = -1;
+    int    depthTest = -1;
+    int    depthWrite = -1;
+    GLenum depthFunc = 0;
+    int    blend = -1;
+    GLenum blendSrc = 0, blendDst = 0;
+    int    cull = -1;
+    GLenum cullFace = 0;
+    int    stencilTest = -1;
+
+    // Depth convention (not affected by invalidate(): only this object changes it)
+    typedef void (APIENTRYP ClipControlProc)(GLenum origin, GLenum depth);
+    ClipControlProc clipControl = nullptr;
+    bool   reversed = false;                    // Context convention
+    bool   standardOverride = false;            // setStandardDepth(true) in effect
+
+    bool depthMirrored() const;                 // Reversed and not overridden
+    void applyDepthConvention();                // Clip range, clear value and depth function
+
+    void setCap(GLenum cap, bool enabled, int& cached); // glEnable/glDisable through the cache
+};
+
+#endif
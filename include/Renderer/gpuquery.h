@@ -0,0 +1,30 @@
+#ifndef GPUQUERY_H
+#define GPUQUERY_H
+
+#include <glad/glad.h>
+#include <cstdint>
+
+// Ring of GL query objects for one measurement per frame (e.g. GL_TIME_ELAPSED,
+// GL_SAMPLES_PASSED). Results are read back a few frames later, only once
+// available, so the CPU never waits on the GPU.
+class GpuQuery {
+public:
+    static const int RING = 3;                  // Frames in flight
+
+    void init(GLenum target);                   // Create the query objects
+    void begin();                               // glBeginQuery on the current slot
+    void end();                                 // glEndQuery and advance the ring
+    bool poll(uint64_t& result);                // Newest available result (false if none yet)
+    uint64_t last() const;                      // Most recent result seen by poll()
+    void terminate();                           // Delete the query objects
+
+private:
+    GLenum       target = 0;
+    unsigned int ids[RING] = {};
+    bool         issued[RING] = {};             // Slot holds a query that has not been read
+    int          head = 0;                      // Next slot to begin
+    bool         active = false;                // Between begin() and end()
+    uint64_t     value = 0;                     // Last result read
+};
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef HIZ_H
+#define HIZ_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "shader.h"         // Compute programs (via ShaderVariants)
+#include "glstate.h"        // Binds + counters
+
+// Layout of one glDrawElementsIndirect command (std430 compatible)
+struct DrawCommand {
+    unsigned int count;             // Index count
+    unsigned int instanceCount;     // 0 = culled, 1 = drawn
+    unsigned int firstIndex;
+    int          baseVertex;
+    unsigned int baseInstance;
+};
+
+// Culling results of the last frame whose counters have been read back
+struct CullStats {
+    unsigned int tested        = 0; // Spheres submitted to the cull pass
+    unsigned int drawn         = 0; // Passed frustum + occlusion tests
+    unsigned int occluded      = 0; // Rejected by the Hi-Z test
+    unsigned int frustumCulled = 0; // Rejected by the frustum test
+};
+
+// Hierarchical-Z occlusion culling.
+// The largest occluders are drawn depth-only into a private depth buffer, a
+// compute pass reduces it into a min/max depth pyramid (RG32F: r = farthest,
+// g = nearest), and a second compute pass projects each sphere's bounds,
+// picks the mip level where the bounds cover at most 2x2 texels, and writes
+// instanceCount 0/1 into an indirect draw command per sphere.
+class HiZCuller {
+public:
+    // Create depth target, pyramid, buffers and compute programs
+    void init(unsigned int width, unsigned int height, ShaderVariants& shaders, GLState& state);
+
+    void beginOccluders();          // Bind + clear the occluder depth target (caller draws depth-only)
+    void endOccluders();            // Build the depth pyramid from the occluder depth
+
+    // Upload per-sphere bounds (xyz centre, w radius) + base commands and run the cull pass.
+    // occlusion == false keeps only the frustum test.
+    void cull(const std::vector<glm::vec4>& bounds,
+              const std::vector<DrawCommand>& commands,
+              const glm::mat4& viewProjection, bool occlusion);
+
+    void bindCommands();            // Bind the culled commands as GL_DRAW_INDIRECT_BUFFER
+    const CullStats& getStats();    // Latest stats (read back without stalling)
+    void terminate();               // Release GL objects
+
+private:
+    static const int STATS_RING = 3;
+
+    GLState*     state = nullptr;
+    Shader*      copyShader = nullptr;      // Level 0: depth texture -> pyramid
+    Shader*      reduceShader = nullptr;    // Level n-1 -> level n
+    Shader*      cullShader = nullptr;      // Bounds test -> indirect commands
+
+    unsigned int width = 0, height = 0, levels = 0;
+    unsigned int fbo = 0;
+    unsigned int depthTexture = 0;          // Occluder depth (GL_DEPTH_COMPONENT32F)
+    unsigned int pyramid = 0;               // RG32F mip chain
+    unsigned int boundsBuffer = 0;          // SSBO: vec4 per sphere
+    unsigned int commandBuffer = 0;         // SSBO / indirect buffer: DrawCommand per sphere
+    size_t       capacity = 0;              // Spheres the buffers can hold
+
+    // Stats counters: one buffer + fence per frame in flight
+    unsigned int statsBuffers[STATS_RING] = {};
+    GLsync       statsFences[STATS_RING] = {};
+    unsigned int statsTested[STATS_RING] = {};
+    int          statsHead = 0;
+    CullStats    stats;
+
+    void reserve(size_t count);             // Grow bounds/command buffers
+};
+
+#endif
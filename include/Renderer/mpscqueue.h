@@ -0,0 +1,72 @@
+#ifndef MPSCQUEUE_H
+#define MPSCQUEUE_H
+
+#include <atomic>
+#include <utility>
+
+// Unbounded multi-producer / single-consumer FIFO (intrusive linked list
+// with a stub node, after D. Vyukov). push() allocates its node with new
+// (the allocator may lock), then links it with one atomic exchange plus a
+// store, which never blocks and never retries (producers never wait on the
+// consumer). pop() runs on one consumer thread only. Items from one
+// producer come out in push order. A producer preempted between its two
+// link steps hides the items behind its own until it resumes: pop() then
+// reports empty rather than waiting.
+template <typename T>
+class MpscQueue {
+public:
+    MpscQueue() : head(&stub), tail(&stub) {}
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+    ~MpscQueue() {
+        T item;
+        while (pop(item)) {}
+    }
+
+    // Any thread
+    void push(T item) {
+        Node* node = new Node();
+        node->item = std::move(item);
+        enqueue(node);
+    }
+
+    // Consumer thread only; false when empty (or a push is half done)
+    bool pop(T& item) {
+        Node* first = tail;
+        Node* next = first->next.load(std::memory_order_acquire);
+        if (first == &stub) {
+            if (!next) return false;
+            tail = next;
+            first = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+        if (!next) {
+            if (first != head.load(std::memory_order_acquire)) return false;   // Push in flight
+            enqueue(&stub);                                                     // Keep one node behind `first`
+            next = first->next.load(std::memory_order_acquire);
+            if (!next) return false;
+        }
+        tail = next;
+        item = std::move(first->item);
+        delete first;
+        return true;
+    }
+
+private:
+    struct Node {
+        std::atomic<Node*> next{nullptr};
+        T                  item{};
+    };
+
+    Node               stub;
+    std::atomic<Node*> head;        // Last pushed (producers)
+    Node*              tail;        // Next to pop (consumer)
+
+    void enqueue(Node* node) {
+        node->next.store(nullptr, std::memory_order_relaxed);
+        Node* previous = head.exchange(node, std::memory_order_acq_rel);
+        previous->next.store(node, std::memory_order_release);
+    }
+};
+
+#endif
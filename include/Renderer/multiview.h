@@ -0,0 +1,75 @@
+#ifndef MULTIVIEW_H
+#define MULTIVIEW_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <string>
+#include <vector>
+
+#include "glstate.h"        // Binds + counters
+#include "camera.h"         // Views derived from the main camera
+
+// What the multi-view pass renders
+enum MultiViewMode {
+    MULTIVIEW_OFF = 0,
+    MULTIVIEW_STEREO,       // Left / right eye side by side
+    MULTIVIEW_SPLIT,        // Camera + top / front / side monitor views in quadrants
+    MULTIVIEW_CUBEMAP,      // Six faces around the camera into a cube map
+    MULTIVIEW_MODE_COUNT
+};
+
+// Single-pass multi-view rendering.
+// Every view's view-projection and eye live in one uniform block; each sphere
+// is submitted once as an instanced draw with one instance per view. The
+// vertex shader projects instance i with view i and a pass-through geometry
+// shader routes the copy to viewport i (stereo / split) or layer i (cube
+// faces), dropping triangles outside that view's frustum. CPU submission,
+// state changes and uniform uploads are paid once however many views there
+// are; only vertex work grows with the view count.
+class MultiView {
+public:
+    static const int MAX_VIEWS = 6;
+    static const unsigned int VIEWS_BINDING = 0;    // Uniform block binding point
+    static const int CAPTURE_SIZE = 512;            // Cube face resolution
+
+    void init(GLState& state);                      // View block + capture cube map
+
+    // Defines of every program drawn through the multi-view pass
+    static std::vector<std::string> defines();
+
+    // Views of this frame for `mode` (not MULTIVIEW_OFF). The monitor views of
+    // MULTIVIEW_SPLIT look at the sphere centred on sceneCenter.
+    void setup(MultiViewMode mode, Camera& camera, int width, int height,
+               const glm::vec3& sceneCenter, float sceneRadius);
+
+    void begin();                                   // Bind the target, viewports and view block
+    void end();                                     // Cube capture: preview the faces; restore the viewport
+
+    int viewCount() const;
+    unsigned int captureMap() const;                // RGBA8 cube of the last MULTIVIEW_CUBEMAP frame
+    void terminate();                               // Release GL objects
+
+    float eyeSeparation = 0.1f;                     // Stereo interocular distance (world units)
+
+private:
+    // std140 element of the view block
+    struct ViewData {
+        glm::mat4 viewProjection;
+        glm::vec4 eye;                              // xyz eye position
+    };
+
+    GLState*     state = nullptr;
+    unsigned int viewBuffer = 0;                    // Uniform buffer, MAX_VIEWS entries
+    unsigned int captureColor = 0;                  // Cube maps of the capture target
+    unsigned int captureDepth = 0;
+    unsigned int captureFbo = 0;                    // Layered (layer = face)
+    unsigned int previewFbo = 0;                    // One face at a time, for the preview blit
+
+    MultiViewMode mode = MULTIVIEW_OFF;
+    int           count = 0;
+    int           outputWidth = 0, outputHeight = 0;
+    ViewData      views[MAX_VIEWS];
+    glm::vec4     viewports[MAX_VIEWS];             // x, y, width, height
+};
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef OCCLUDERS_H
+#define OCCLUDERS_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <string>
+#include <vector>
+
+#include "shader.h"         // Compute program (via ShaderVariants)
+#include "glstate.h"        // Binds + counters
+
+// Analytic sphere occlusion.
+// Every occluder in the scene is a sphere, so soft shadows (overlap of the
+// spherical light's cone with each occluder's cone) and ambient occlusion
+// (cosine-weighted solid angle of each occluder) are evaluated in closed form
+// while shading. A compute pass gathers, per screen tile, the occluders whose
+// AO reach or shadow cone can touch the tile, so fragments only loop over
+// nearby spheres.
+class SphereOccluders {
+public:
+    static const unsigned int TILES_X = 16;
+    static const unsigned int TILES_Y = 9;
+    static const unsigned int MAX_PER_TILE = 64;
+
+    // SSBO binding points shared with shaders/sphereocclusion.glsl. GL 4.3 only
+    // guarantees 8 bindings, so these reuse the Hi-Z slots (its compute passes
+    // finish before shading); 3-5 stay free for the cluster lists.
+    static const unsigned int OCCLUDERS_BINDING = 0;
+    static const unsigned int COUNT_BINDING     = 1;
+    static const unsigned int INDICES_BINDING   = 2;
+
+    void init(ShaderVariants& shaders, GLState& state);   // Buffers + gather program
+
+    // Defines every program reading the tile lists must be built with
+    static std::vector<std::string> defines();
+
+    // Upload occluders (xyz centre, w radius) and rebuild the per-tile lists.
+    // light = xyz position, w range: bounds the shadow cones of the shadowed light.
+    void update(const std::vector<glm::vec4>& occluders,
+                const glm::vec4& light, float lightRadius,
+                const glm::mat4& view, const glm::mat4& projection,
+                int screenWidth, int screenHeight);
+
+    // Bind the lists + set the lookup uniforms on a shading program
+    void bind(Shader& shader);
+
+    unsigned int occluderCount() const;                 // Occluders in the last update
+    void terminate();                                   // Release GL objects
+
+    float aoReach = 4.0f;       // AO influence distance in occluder radii
+
+private:
+    GLState*     state = nullptr;
+    Shader*      gatherShader = nullptr;
+    unsigned int occluderBuffer = 0;    // vec4 per occluder
+    unsigned int countBuffer = 0;       // uint per tile
+    unsigned int indexBuffer = 0;       // uint[MAX_PER_TILE] per tile
+    size_t       capacity = 0;
+    unsigned int count = 0;
+    float        lightRadius = 0.0f;    // Shadowed light's sphere radius (last update)
+    glm::vec2    screenSize{1.0f};
+};
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef OIT_H
+#define OIT_H
+
+#include <glad/glad.h>
+#include <string>
+#include <vector>
+
+#include "shader.h"         // Translucent + composite programs (via ShaderVariants)
+#include "glstate.h"        // Binds + counters
+
+// Weighted blended order-independent transparency.
+// Translucent surfaces are drawn once, in any order, into an RGBA16F
+// accumulation target (additive, weighted premultiplied colour) and an R8
+// revealage target (multiplicative, product of 1 - alpha), depth-tested
+// against a copy of the opaque scene depth without writing it. A full-screen
+// composite then blends the weighted average colour over the scene. No sort.
+class WeightedOIT {
+public:
+    // Programs; clusteredDefines builds the clustered-lighting translucent variant
+    void init(ShaderVariants& shaders, GLState& state, const std::vector<std::string>& clusteredDefines);
+    void resize(int width, int height);     // Render size (targets grow when needed)
+
+    // Copy the scene's depth, bind + clear the targets, set up blending.
+    // Returns the translucent program (caller draws both faces of each surface).
+    Shader& begin(unsigned int scene, bool clustered);
+    void composite(unsigned int scene);     // Blend the result over the scene target
+
+    void terminate();                       // Release GL objects
+
+private:
+    GLState*     state = nullptr;
+    Shader*      translucentShader = nullptr;
+    Shader*      translucentClusteredShader = nullptr;
+    Shader*      compositeShader = nullptr;
+
+    int          width = 0, height = 0;             // Render size
+    int          allocWidth = 0, allocHeight = 0;   // Target size
+    unsigned int fbo = 0;                   // accum + revealage + depth
+    unsigned int accumTexture = 0;          // RGBA16F
+    unsigned int revealageTexture = 0;      // R8
+    unsigned int depthStencil = 0;          // DEPTH24_STENCIL8, copied from the scene
+    unsigned int fullscreenVAO = 0;         // Attribute-less full-screen triangle
+
+    void releaseTargets();
+};
+
+#endif
@@ -0,0 +1,136 @@
+#ifndef POOL_H
+#define POOL_H
+
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Reference into a Pool<T>: slot index + the slot's generation when it was
+// created. Stale (get() returns null) once the object is destroyed, even if
+// the slot has been reused since.
+template <typename T>
+struct PoolHandle {
+    uint32_t index = ~0u;
+    uint32_t generation = 0;
+
+    bool operator==(const PoolHandle& other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(const PoolHandle& other) const { return !(*this == other); }
+};
+
+// Fixed-block pool allocator. Objects live in blocks of BLOCK_SIZE slots
+// that are allocated as the pool grows and never move or shrink, so growing
+// never invalidates a handle or a pointer from get(). Free slots form an
+// intrusive list: create() and destroy() are O(1) and never touch the
+// system allocator once a block exists. Each block keeps its objects
+// contiguous, with the bookkeeping (generation, free link, live flag) in
+// separate arrays so forEach() streams through the objects alone.
+template <typename T, uint32_t BLOCK_SIZE = 256>
+class Pool {
+public:
+    Pool() = default;
+    Pool(const Pool&) = delete;
+    Pool& operator=(const Pool&) = delete;
+    ~Pool() { clear(); }
+
+    // Construct an object in a free slot (a new block when there is none)
+    template <typename... Args>
+    PoolHandle<T> create(Args&&... args) {
+        if (freeHead == NONE) grow();
+        uint32_t index = freeHead;
+        Block& block = *blocks[index / BLOCK_SIZE];
+        uint32_t slot = index % BLOCK_SIZE;
+        new (&block.storage[slot]) T(std::forward<Args>(args)...);
+        freeHead = block.nextFree[slot];
+        block.live[slot] = true;
+        ++count;
+        return {index, block.generation[slot]};
+    }
+
+    // Destroy the object and retire the handle; stale handles are ignored
+    void destroy(PoolHandle<T> handle) {
+        if (!alive(handle)) return;
+        Block& block = *blocks[handle.index / BLOCK_SIZE];
+        uint32_t slot = handle.index % BLOCK_SIZE;
+        object(block, slot)->~T();
+        block.live[slot] = false;
+        ++block.generation[slot];
+        block.nextFree[slot] = freeHead;
+        freeHead = handle.index;
+        --count;
+    }
+
+    bool alive(PoolHandle<T> handle) const {
+        if (handle.index / BLOCK_SIZE >= blocks.size()) return false;
+        const Block& block = *blocks[handle.index / BLOCK_SIZE];
+        uint32_t slot = handle.index % BLOCK_SIZE;
+        return block.live[slot] && block.generation[slot] == handle.generation;
+    }
+
+    // Object of a live handle, null when stale
+    T* get(PoolHandle<T> handle) {
+        return alive(handle) ? object(*blocks[handle.index / BLOCK_SIZE], handle.index % BLOCK_SIZE) : nullptr;
+    }
+    const T* get(PoolHandle<T> handle) const {
+        return const_cast<Pool*>(this)->get(handle);
+    }
+
+    size_t size() const { return count; }                           // Live objects
+    size_t capacity() const { return blocks.size() * BLOCK_SIZE; }  // Slots allocated
+
+    // Visit every live object (handle, object) in slot order
+    template <typename F>
+    void forEach(F visit) {
+        for (uint32_t b = 0; b < blocks.size(); ++b) {
+            Block& block = *blocks[b];
+            for (uint32_t slot = 0; slot < BLOCK_SIZE; ++slot) {
+                if (!block.live[slot]) continue;
+                visit(PoolHandle<T>{b * BLOCK_SIZE + slot, block.generation[slot]}, *object(block, slot));
+            }
+        }
+    }
+
+    // Destroy every object (blocks are kept; every outstanding handle goes stale)
+    void clear() {
+        for (uint32_t b = 0; b < blocks.size(); ++b) {
+            Block& block = *blocks[b];
+            for (uint32_t slot = 0; slot < BLOCK_SIZE; ++slot)
+                if (block.live[slot]) destroy({b * BLOCK_SIZE + slot, block.generation[slot]});
+        }
+    }
+
+private:
+    static const uint32_t NONE = ~0u;
+
+    struct Block {
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage[BLOCK_SIZE];
+        uint32_t generation[BLOCK_SIZE];
+        uint32_t nextFree[BLOCK_SIZE];      // Free list link (valid while not live)
+        bool     live[BLOCK_SIZE];
+    };
+
+    std::vector<std::unique_ptr<Block>> blocks;
+    uint32_t freeHead = NONE;
+    size_t   count = 0;
+
+    static T* object(Block& block, uint32_t slot) {
+        return std::launder(reinterpret_cast<T*>(&block.storage[slot]));
+    }
+
+    // Append a block and thread its slots onto the free list (lowest first)
+    void grow() {
+        uint32_t first = (uint32_t)blocks.size() * BLOCK_SIZE;
+        blocks.emplace_back(new Block());
+        Block& block = *blocks.back();
+        for (uint32_t slot = 0; slot < BLOCK_SIZE; ++slot) {
+            block.generation[slot] = 1;     // Generation 0 is never live: default handles are stale
+            block.nextFree[slot] = slot + 1 < BLOCK_SIZE ? first + slot + 1 : freeHead;
+            block.live[slot] = false;
+        }
+        freeHead = first;
+    }
+};
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef POSTPROCESS_H
+#define POSTPROCESS_H
+
+#include <glad/glad.h>
+
+#include "shader.h"         // Bloom / tonemap programs (via ShaderVariants)
+#include "glstate.h"        // Binds + counters
+#include "gpuquery.h"       // Per-pass GPU timers
+
+// GPU time of each post-processing stage (GL_TIME_ELAPSED, last measured frame)
+struct PostTimings {
+    float downsampleMs = 0.0f;  // Bright-pass + bloom downsample chain
+    float upsampleMs   = 0.0f;  // Bloom upsample chain
+    float compositeMs  = 0.0f;  // Fused bloom + exposure + tonemap, blit to the window
+    float totalMs() const { return downsampleMs + upsampleMs + compositeMs; }
+};
+
+// HDR scene target and compute post-processing chain.
+// The scene renders into an RGBA16F target. Bloom runs at half resolution
+// with the dual filter (Bjorge, "Bandwidth-Efficient Rendering"): a soft-knee
+// bright pass folded into the first 5-tap downsample, LEVELS - 1 more
+// downsamples, then 8-tap upsamples that add each level back on the way up,
+// all in R11F_G11F_B10F mip chains. One fused pass then reads the scene and
+// the bloom, applies exposure, ACES tonemapping and gamma, and writes an LDR
+// image that is blitted (and upscaled under dynamic resolution) to the
+// window. Like the resolution target, the scene target is sized to the
+// window and only the lower-left render area is used.
+class PostProcess {
+public:
+    static const int LEVELS = 5;                // Bloom mips below the half-resolution level
+
+    void init(ShaderVariants& shaders, GLState& state);
+
+    // Grow the targets for the window size and set this frame's render area
+    void resize(int outputWidth, int outputHeight, int renderWidth, int renderHeight);
+
+    unsigned int framebuffer() const;           // HDR scene target (RGBA16F + DEPTH24_STENCIL8)
+
+    // Bloom, tonemap and present to the default framebuffer (viewport = window)
+    void run();
+
+    const PostTimings& getTimings() const;
+    void terminate();                           // Release GL objects
+
+    float exposure = 1.0f;
+    float bloomThreshold = 1.0f;                // Luminance where bloom starts...
+    float bloomKnee = 0.5f;                     // ...eased in over this range
+    float bloomIntensity = 0.6f;
+    float emissiveIntensity = 4.0f;             // Light marker brightness in the HDR target
+    float budgetMs = 0.5f;                      // Target GPU time of the whole chain
+    unsigned int samples = 0;                   // Measured frames...
+    unsigned int misses = 0;                    // ... of which exceeded the budget
+
+private:
+    GLState*     state = nullptr;
+    Shader*      downsampleShader = nullptr;
+    Shader*      upsampleShader = nullptr;
+    Shader*      compositeShader = nullptr;
+
+    int          outputWidth = 0, outputHeight = 0;
+    int          width = 0, height = 0;             // Render area this frame
+    int          allocWidth = 0, allocHeight = 0;   // Scene target size
+    unsigned int fbo = 0;
+    unsigned int sceneTexture = 0;                  // RGBA16F
+    unsigned int depthStencil = 0;                  // DEPTH24_STENCIL8 renderbuffer
+    unsigned int bloomDown = 0;                     // R11F_G11F_B10F, LEVELS mips from half size
+    unsigned int bloomUp = 0;
+    unsigned int ldrTexture = 0;                    // RGBA8 tonemapped image
+    unsigned int ldrFbo = 0;                        // Blit source
+
+    GpuQuery     downsampleTimer;
+    GpuQuery     upsampleTimer;
+    GpuQuery     compositeTimer;
+    PostTimings  timings;
+
+    void allocate(int w, int h);
+    void releaseTargets();
+    void updateTimings();                           // Read back finished timers
+};
+
+#endif
@@ -0,0 +1,83 @@
+#ifndef PROBES_H
+#define PROBES_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <string>
+#include <vector>
+
+#include "shader.h"         // Bake program (via ShaderVariants)
+#include "glstate.h"        // Binds + counters
+#include "clusters.h"       // PointLight
+
+// Irradiance probe grid replacing the flat ambient term.
+// A regular grid of probes over the lit spheres stores incoming light as L2
+// spherical harmonics (9 RGB coefficients): a uniform ambient sky, minus what
+// each sphere hides of it, plus one bounce of every point light off each
+// sphere's visible side. A compute pass bakes one probe per invocation. Only
+// the probes a change can reach are re-baked: a moved light dirties the reach
+// of the spheres inside its range; a changed grid, sphere set or light count
+// re-bakes everything. Shading reads the 27 coefficients with 7 trilinear
+// fetches from one RGBA16F 3D texture (7 blocks stacked along z).
+class IrradianceProbes {
+public:
+    static const int GRID_X = 16;           // Probes per axis
+    static const int GRID_Y = 8;
+    static const int GRID_Z = 16;
+    static const int BLOCKS = 7;            // vec4 blocks holding 9 x RGB coefficients
+
+    // SSBO binding points of the bake pass (above the cluster lists' 3-5)
+    static const unsigned int LIGHTS_BINDING  = 6;
+    static const unsigned int SPHERES_BINDING = 7;
+
+    void init(ShaderVariants& shaders, GLState& state);   // Grid texture + bake program
+
+    // Defines of the bake pass and of every program sampling the grid
+    static std::vector<std::string> defines();
+
+    // Re-bake what changed since the last call. spheres = xyz centre, w radius
+    // (lit spheres; they block the ambient and bounce the lights), albedos
+    // in the same order; the grid spans [boundsMin, boundsMax].
+    void update(const std::vector<PointLight>& lights,
+                const std::vector<glm::vec4>& spheres,
+                const std::vector<glm::vec3>& albedos,
+                const glm::vec3& boundsMin, const glm::vec3& boundsMax);
+
+    void bind(Shader& shader, unsigned int unit) const;  // Grid texture + lookup uniforms
+
+    unsigned int bakedProbes() const;       // Probes re-baked by the last update
+    unsigned int fullBakes() const;         // Whole-grid bakes so far
+    void terminate();                       // Release GL objects
+
+    float ambient = 0.12f;                  // Sky radiance (matches phong.glsl's ambientStrength)
+    float bounceReach = 8.0f;               // Bounce / occlusion range in sphere radii
+
+private:
+    // Per-sphere data of the bake pass (std430)
+    struct ProbeSphere {
+        glm::vec4 bounds;                   // xyz centre, w radius
+        glm::vec4 albedo;                   // rgb, a unused
+    };
+
+    GLState*     state = nullptr;
+    Shader*      bakeShader = nullptr;
+    unsigned int gridTexture = 0;           // RGBA16F, GRID_X x GRID_Y x GRID_Z * BLOCKS
+    unsigned int lightBuffer = 0;
+    unsigned int sphereBuffer = 0;
+    size_t       lightCapacity = 0;
+    size_t       sphereCapacity = 0;
+
+    // Inputs of the current bake
+    bool                     baked = false;
+    std::vector<PointLight>  bakedLights;
+    std::vector<ProbeSphere> bakedSpheres;
+    glm::vec3                gridMin{0.0f};
+    glm::vec3                gridMax{0.0f};
+    unsigned int             lastBaked = 0;
+    unsigned int             fullCount = 0;
+
+    glm::vec3 cellSize() const;
+    void bake(const glm::ivec3& first, const glm::ivec3& last);    // Inclusive probe range
+};
+
+#endif
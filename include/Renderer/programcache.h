@@ -0,0 +1,51 @@
+#ifndef PROGRAMCACHE_H
+#define PROGRAMCACHE_H
+
+#include <glad/glad.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// KHR_parallel_shader_compile tokens (not part of the generated GLAD 4.3 loader)
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+typedef void (APIENTRYP PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)(GLuint count);
+
+// Persistent on-disk cache of linked program binaries.
+// Entries are keyed by a hash of the shader sources and the driver identity
+// (vendor / renderer / version strings), so a driver update simply misses and
+// the program is rebuilt from source and re-stored.
+class ProgramCache {
+public:
+    // Query driver identity + binary format support (needs a current GL context)
+    void init(const char* directory);
+
+    // True when the driver exposes at least one program binary format
+    bool isEnabled() const;
+    // True when non-blocking compiles can be polled with GL_COMPLETION_STATUS_KHR
+    bool hasParallelCompile() const;
+
+    // Builds a cache key from the given shader sources (driver identity mixed in)
+    uint64_t makeKey(const std::vector<std::string>& sources) const;
+
+    // Tries to create the program from a stored binary; false on miss or driver rejection
+    bool load(uint64_t key, unsigned int program);
+    // Stores the binary of a successfully linked program
+    void store(uint64_t key, unsigned int program);
+
+    unsigned int hits   = 0;    // Programs restored from binary
+    unsigned int misses = 0;    // Programs compiled from source
+
+private:
+    std::string directory;          // Cache directory (created on first store)
+    std::string driverId;           // Vendor | renderer | version
+    uint64_t    driverHash = 0;     // Hash of driverId stored in every entry
+    bool        enabled = false;    // Binary formats available
+    bool        parallel = false;   // KHR/ARB_parallel_shader_compile available
+
+    std::string entryPath(uint64_t key) const;                         // Cache file for a key
+    static uint64_t hash(const void* data, size_t size, uint64_t seed); // FNV-1a 64
+};
+
+#endif
@@ -3,33 +3,55 @@
 
 #include <glad/glad.h>      // OpenGL function loader
 #include <GLFW/glfw3.h>     // Window / input
+#include <atomic>
 #include <iostream>
+#include <memory>
 #include <string>
 #include <sstream>
+#include <unordered_map>
 
 #include "shader.h"         // Shader wrapper (compile / link / uniform helpers)
+#include "programcache.h"   // Persistent program binaries
+#include "glstate.h"        // GL state cache + per-frame counters
+#include "gpuquery.h"       // Non-blocking GPU queries
+#include "hiz.h"            // Hi-Z occlusion culling
+#include "softcull.h"       // CPU occlusion culling
+#include "clusters.h"       // Clustered forward lighting
+#include "deferred.h"       // Deferred shading path
+#include "visibility.h"     // Visibility-buffer shading path
+#include "shadows.h"        // Point light cube shadow map
+#include "occluders.h"      // Analytic sphere shadows + AO
+#include "resolution.h"     // Dynamic resolution scaling
+#include "oit.h"            // Weighted blended transparency
+#include "gpuprimitives.h"  // GPU scan / compaction / radix sort
+#include "atmosphere.h"     // Precomputed atmospheric scattering
+#include "probes.h"         // SH irradiance probe grid
+#include "multiview.h"      // Single-pass stereo / split / cube views
+#include "postprocess.h"    // HDR target, bloom + tonemap chain
+#include "virtualtexture.h" // Streamed cube-face imagery
+#include "entities.h"       // SoA entity store + handles
+#include "transforms.h"     // Parent-child transforms, parallel world matrices
+#include "mpscqueue.h"      // Lock-free scene command queue
+#include "scene.h"          // Binary scene files (memory mapped)
 #include "camera.h"         // FPS style camera
 #include "cubesphere.h"     // CPU sphere (cube → sphere) geometry generator
 #include "settings.h"       // Global settings (screen size, FOV, etc.)
 #include "config.h"         // CMake‑generated (paths, if any)
 
-// Simple GPU mesh container (one VAO/VBO/EBO + index count)
-struct Mesh {
-    unsigned int VBO = 0;
-    unsigned int VAO = 0;
-    unsigned int EBO = 0;
-    int          indexCount = 0;
-};
-
-// Sphere instance: owns CPU geometry + its GPU mesh + render properties
+// Sphere description + cold data. drawSphere() copies it into the renderer's
+// sphere pool (the caller's object can go away) and its render properties
+// into the entity store, where the per-frame state lives.
 struct Sphere {
     CubeSphere   geometry;          // Procedural vertex/index data (CPU side)
-    Mesh         mesh;              // Uploaded GPU buffers (lazy created)
     glm::vec3    Color{1.0f};       // Base albedo / emissive tint
-    glm::vec3    Position{0.0f};    // World position (no rotation/scale here)
     std::string  Name;              // Debug name
     bool         source = false;    // True = treated as light/emissive
-    bool         remake = true;     // True = geometry changed, needs re-upload
+    float        LightRange = 10.0f; // Light influence radius when source == true
+    bool         dynamic = false;   // Moves every frame: redrawn into the shadow map each frame
+    float        Opacity = 1.0f;    // < 1 = translucent (order-independent, casts no shadow)
+    bool         hasAtmosphere = false;  // Planet: surface + sky shaded through `atmosphere`
+    AtmosphereParams atmosphere;    // Scattering medium (planet radii), used when hasAtmosphere
+    bool         virtualTextured = false;  // Planet albedo from the renderer's virtual texture (Color until streamed)
 
     // Default: unit radius sphere
     Sphere() : geometry(1.0f) {}
@@ -37,20 +59,80 @@ struct Sphere {
     Sphere(std::string& name, float radius, glm::vec3 color)
         : geometry(radius), Name(name), Color(color) {}
 
-    Sphere(std::string& name, float radius, glm::vec3 color, glm::vec3 lighting)
-        : geometry(radius), Name(name), Color(color), Position(lighting) {}
-
-    // Mark geometry dirty when parameters change
+    // Geometry parameters (before drawSphere(); afterwards through the renderer)
     void setRadius(float radius) {
         geometry.setRadius(radius);
-        remake = true;
     }
     void setSubdivisions(unsigned int subs) {
         geometry.setSubdivisions(subs);
-        remake = true;
     }
 };
 
+// Sphere id of the thread-safe scene API (0 = none); never reused
+typedef uint64_t SceneId;
+
+// Scene edit queued by any thread, applied by the render thread at the next frame start
+enum SceneCommandType : uint8_t {
+    SCENE_CREATE = 0,
+    SCENE_DESTROY,
+    SCENE_MOVE,
+    SCENE_RECOLOR
+};
+struct SceneCommand {
+    SceneCommandType        type = SCENE_DESTROY;
+    SceneId                 id = 0;
+    SceneId                 parent = 0;         // CREATE: parent sphere (0 = root)
+    glm::dvec3              position{0.0};      // CREATE, MOVE (relative to the parent)
+    glm::vec4               color{1.0f};        // RECOLOR: rgb + opacity
+    std::unique_ptr<Sphere> sphere;             // CREATE: copied on the caller's thread
+};
+
+// Shader permutations used by sphere draws (one specialised program each)
+enum ShaderVariant {
+    VARIANT_LIT = 0,        // Phong lit surface
+    VARIANT_ATMOSPHERE,     // Planet surface lit by the sun through its atmosphere
+    VARIANT_EMISSIVE,       // Light marker (flat emissive colour)
+    VARIANT_COUNT
+};
+
+// Draws sharing one shader variant (rebuilt every frame)
+struct DrawBucket {
+    Shader*               shader = nullptr;
+    std::vector<uint32_t> rows;         // Entity rows
+    size_t                first = 0;    // Offset of rows[0] in the frame's draw order
+};
+
+// Fragment shading work of the last measured frame (GL_SAMPLES_PASSED)
+struct OverdrawStats {
+    uint64_t shadedFragments  = 0;     // Fragments that passed the depth test in the shading pass
+    uint64_t prepassFragments = 0;     // Fragments that passed the depth test in the prepass
+    float    shadedPerPixel   = 0.0f;  // shadedFragments / framebuffer pixels
+    float    overdraw         = 0.0f;  // Prepass on: prepassFragments / shadedFragments
+                                       // (shading work the prepass removed), else 0
+};
+
+// How the animated light's shadows are computed (forward path)
+enum ShadowMode {
+    SHADOW_NONE = 0,
+    SHADOW_MAP,             // Cached cube shadow map
+    SHADOW_ANALYTIC,        // Sphere-occluder soft shadows + AO from per-tile lists
+    SHADOW_MODE_COUNT
+};
+
+// How lit geometry is shaded
+enum ShadingPath {
+    SHADING_FORWARD = 0,    // Per-bucket programs (optional prepass)
+    SHADING_DEFERRED,       // G-buffer + stencil-tested light volumes
+    SHADING_VISIBILITY      // ID raster + one full-screen resolve
+};
+
+// GPU time of the scene passes per shading path (GL_TIME_ELAPSED, last measured frame)
+struct ShadingTimings {
+    float forwardMs    = 0.0f;  // Prepass + forward shading pass
+    float deferredMs   = 0.0f;  // Geometry + light volumes + emissive + present
+    float visibilityMs = 0.0f;  // ID raster + resolve
+};
+
 // Renderer: owns window, GL context, shader, camera, and sphere registry
 class Renderer {
 public:
@@ -59,8 +141,43 @@ public:
     // Initialize context, load GL functions, compile shaders
     void init();
 
-    // Register a sphere instance at a position (uploads mesh if needed)
-    void drawSphere(Sphere& sphere, glm::vec3 position);
+    // Register a sphere instance at a world position, or relative to a live
+    // parent (uploads its mesh); the handle finds its entity row later
+    EntityHandle drawSphere(const Sphere& sphere, const glm::dvec3& position, EntityHandle parent = EntityHandle());
+
+    // Thread-safe scene edits, callable from any thread: queued without locks
+    // and applied on the render thread at the start of the next frame, in
+    // push order per calling thread. createSphere() returns the id at once;
+    // edits of destroyed or unknown ids are ignored.
+    SceneId createSphere(const Sphere& sphere, const glm::dvec3& position, SceneId parent = 0);
+    void destroySphere(SceneId id);
+    void moveSphere(SceneId id, const glm::dvec3& position);
+    void recolorSphere(SceneId id, const glm::vec3& color, float opacity = 1.0f);
+
+    // Entity of a created sphere (render thread; stale before it is applied and after destroy)
+    EntityHandle findSphere(SceneId id) const;
+
+    // Remove an entity now (render thread, between frames): O(1) swap-remove of
+    // its row; its children become roots; its mesh goes with its last user.
+    // A created sphere's id goes stale as if destroySphere() had been applied.
+    void removeSphere(EntityHandle handle);
+
+    // Scene files (render thread). loadScene() replaces every entity with the
+    // file's spheres (false, scene unchanged, if it is missing or corrupt);
+    // saveScene() snapshots every entity. clearScene() removes everything.
+    bool loadScene(const std::string& path);
+    bool saveScene(const std::string& path);
+    void clearScene();
+
+    // Per-frame sphere state (columns may be edited between frames; positions
+    // come from the transforms)
+    EntityStore& getEntities();
+
+    // Local position / rotation / scale of every entity (node = entities.transform[row])
+    TransformHierarchy& getTransforms();
+
+    // World position the GPU-side (float) positions are relative to this frame
+    const glm::dvec3& getRenderOrigin() const;
 
     // Main loop (poll events, render, swap buffers)
     void runRenderLoop();
@@ -68,23 +185,222 @@ public:
     // Access underlying GLFW window (e.g., for additional user logic)
     GLFWwindow* getWindow();
 
+    // GL work counters of the last completed frame
+    const GLFrameStats& getFrameStats() const;
+
+    // Depth-only prepass (shading pass then runs with GL_EQUAL, depth writes off)
+    void setDepthPrepass(bool enabled);
+    bool getDepthPrepass() const;
+    const OverdrawStats& getOverdrawStats() const;
+
+    // Hi-Z occlusion + frustum culling of spheres (GPU, indirect draws)
+    void setOcclusionCulling(bool enabled);
+    bool getOcclusionCulling() const;
+    const CullStats& getCullStats();
+
+    // Software occlusion + frustum culling of spheres (CPU, skips submission)
+    void setCpuOcclusionCulling(bool enabled);
+    bool getCpuOcclusionCulling() const;
+    const SoftCullStats& getCpuCullStats() const;
+
+    // Clustered lighting (all source spheres) vs. the single-light forward path
+    void setClusteredLighting(bool enabled);
+    bool getClusteredLighting() const;
+
+    // Forward, deferred or visibility-buffer shading
+    void setShadingPath(ShadingPath path);
+    ShadingPath getShadingPath() const;
+    const ShadingTimings& getShadingTimings() const;
+
+    // Shadowing of the animated light (forward path)
+    void setShadowMode(ShadowMode mode);
+    ShadowMode getShadowMode() const;
+
+    // Freeze / resume the light animation (a still light lets the static shadow cache hit)
+    void setLightAnimation(bool enabled);
+    bool getLightAnimation() const;
+
+    // Offscreen rendering at a GPU-time-driven scale, upscaled to the window
+    void setDynamicResolution(bool enabled);
+    bool getDynamicResolution() const;
+    void setFrameBudget(float milliseconds);
+    const DynamicResolution& getResolution() const;
+
+    // Atmosphere of the first sphere that has one (surface, sky, LUT passes)
+    void setAtmosphere(bool enabled);
+    bool getAtmosphere() const;
+
+    // Ambient + one light bounce from the irradiance probe grid (forward path)
+    void setProbeLighting(bool enabled);
+    bool getProbeLighting() const;
+
+    // HDR scene target with compute bloom + tonemapping (off = LDR straight to the window)
+    void setPostProcessing(bool enabled);
+    bool getPostProcessing() const;
+    const PostTimings& getPostTimings() const;
+
+    // Streamed cube-face imagery on the atmosphere planet (off = flat Color)
+    void setVirtualTexturing(bool enabled);
+    bool getVirtualTexturing() const;
+    const VirtualTextureStats& getVirtualTextureStats() const;
+
+    // Stereo, split-screen or cube-capture views in one instanced pass (off = normal paths)
+    void setMultiView(MultiViewMode mode);
+    MultiViewMode getMultiView() const;
+
+    // Set the subdivision level of every non-source sphere (triangle density benchmark)
+    void setSubdivisions(unsigned int subdivisions);
+
 private:
     // --- Core state ---
     GLFWwindow* window = nullptr;
     Camera      camera;
-    Shader      ourShader;
+    ShaderVariants shaderVariants;
+    ProgramCache   programCache;
+    GLState        glState;
+
+    // Per-variant draw lists
+    DrawBucket buckets[VARIANT_COUNT];
+    // Lit programs: [0] single light (lightPos / lightColor), [1] per-cluster
+    // light lists; each with flat or probe ambient, and with no shadows,
+    // SHADOWS and SPHERE_OCCLUSION
+    Shader*    litShaders[2][2][SHADOW_MODE_COUNT] = {};
+
+    // Lighting
+    bool                    clusteredLighting = true;
+    ClusteredLights         clusters;
+    std::vector<PointLight> frameLights;        // Lights gathered this frame
+    bool                    lightAnimation = true;
+
+    // Shadow state
+    ShadowMode             shadowMode = SHADOW_MAP;
+    ShadowMode             frameShadowMode = SHADOW_NONE;  // Mode in effect this frame
+    PointShadowMap         shadowMap;
+    SphereOccluders        occluders;
+    std::vector<glm::vec4> occluderBounds;         // Every non-source sphere this frame
+    int                    shadowLightIndex = -1;  // lightRow's slot in frameLights
+    std::vector<glm::vec4> staticCasterBounds;     // Cache key of the static shadow map
+    std::vector<uint32_t>  dynamicCasters;         // Rows
+
+    // Shading path state
+    ShadingPath      shadingPath = SHADING_FORWARD;
+    DeferredRenderer deferred;
+    Shader*          gbufferShader = nullptr;   // Albedo + normal output, no lighting
+    VisibilityBuffer visibility;
+    bool             poolDirty = true;          // Sphere meshes changed since the last pool upload
+    std::vector<VisInstance> visInstances;      // Per-draw resolve data in draw order
+    GpuQuery         forwardTimer;              // GL_TIME_ELAPSED of the forward path
+    GpuQuery         deferredTimer;             // GL_TIME_ELAPSED of the deferred path
+    GpuQuery         visibilityTimer;           // GL_TIME_ELAPSED of the visibility path
+    ShadingTimings   shadingTimings;
+
+    // Depth prepass state
+    bool          depthPrepass = false;
+    Shader*       depthShader = nullptr;    // Position-only program
+    GpuQuery      prepassQuery;             // GL_SAMPLES_PASSED in the prepass
+    GpuQuery      shadedQuery;              // GL_SAMPLES_PASSED in the shading pass
+    OverdrawStats overdrawStats;
+
+    // Occlusion culling state
+    bool                     occlusionCulling = false;
+    unsigned int             maxOccluders = 16;  // Largest on-screen spheres used as occluders
+    HiZCuller                hiz;
+    std::vector<uint32_t>    drawOrder;          // Rows of all buckets back to back (indexes the cull arrays)
+    std::vector<glm::vec4>   cullBounds;         // Bounding sphere per draw
+    std::vector<DrawCommand> cullCommands;       // Indirect command per draw
+    bool                     cpuOcclusionCulling = false;
+    SoftwareOcclusion        softCull;           // CPU depth rasteriser + bounds tests
+    std::vector<uint32_t>    occluderSpheres;    // Rows of the occluders picked this frame (largest on screen)
+    std::vector<glm::vec4>   cullOccluders;      // Their bounds (xyz centre, w radius)
 
-    // All spheres submitted for rendering (stored as pointers; lifetime managed by caller)
-    std::vector<Sphere*> spheres;
+    // Translucent spheres (weighted blended OIT over every shading path)
+    WeightedOIT           oit;
+    std::vector<uint32_t> translucentSpheres;   // Rows, rebuilt every frame, unsorted
 
-    // Pointer to the sphere acting as light source
-    Sphere* lightSphere = nullptr;
+    // Compute scan / compaction / sort shared by GPU-side passes
+    GpuPrimitives primitives;
+
+    // Planet atmosphere (one planet per frame: its LUTs are per planet)
+    bool       atmosphereEnabled = true;
+    Atmosphere atmosphere;
+    int        atmosphereRow = -1;              // Row of the planet picked this frame, or -1
+    Shader*    atmosphereShaders[2] = {};       // [0] flat albedo, [1] VIRTUAL_TEXTURE
+
+    // Virtual texture of the planet surface (feedback pass + tile streaming)
+    bool           virtualTexturing = true;
+    VirtualTexture virtualTexture;
+    bool           frameVirtualTexture = false;  // Planet textured this frame
+
+    // Irradiance probes (forward lit bucket)
+    bool             probeLighting = true;
+    IrradianceProbes probes;
+    std::vector<glm::vec4> probeSpheres;        // Lit opaque spheres this frame
+    std::vector<glm::vec3> probeAlbedos;
+
+    // HDR post-processing (every shading path; multi-view draws LDR to the window)
+    bool        postProcessing = true;
+    PostProcess post;
+
+    // Multi-view pass (forward, single light; replaces the shading paths while on)
+    MultiViewMode multiViewMode = MULTIVIEW_OFF;
+    MultiView     multiView;
+    Shader*       multiViewLit[2] = {};         // [0] flat, [1] SHADOWS
+    Shader*       multiViewEmissive = nullptr;
+
+    // Camera-relative rendering: every float position handed to the GPU is
+    // worldPosition - renderOrigin, rebuilt each frame; the origin follows the
+    // camera in originSnap steps (0 = exactly at the camera)
+    glm::dvec3 renderOrigin{0.0};
+    double     originSnap = 64.0;
+
+    // Current framebuffer size (tracked through the resize callback)
+    int fbWidth  = SCR_WIDTH;
+    int fbHeight = SCR_HEIGHT;
+
+    // Size the scene is rendered at this frame (fb size, or scaled offscreen)
+    bool              dynamicResolution = false;
+    DynamicResolution resolution;
+    int               renderWidth  = SCR_WIDTH;
+    int               renderHeight = SCR_HEIGHT;
+
+    // Startup timing (seconds since glfwInit)
+    bool  firstFrameDrawn = false;
+
+    // Every registered sphere, one row each; cold data, meshes and their GL
+    // buffers in pools referenced by generational handles
+    EntityStore       entities;
+    Pool<Sphere>      spheres;
+    Pool<Mesh>        meshes;
+    Pool<GpuBuffer>   buffers;
+
+    // Transform of every entity; recomputed nodes are copied back into the
+    // entity columns once per frame
+    TransformHierarchy        transforms;
+    std::vector<EntityHandle> transformEntity;   // Node id -> entity
+
+    // Spheres with the same geometry (radius, subdivisions) share one mesh;
+    // Mesh::users counts them
+    std::unordered_map<uint64_t, PoolHandle<Mesh>> meshCache;
+
+    // Thread-safe scene edits: any thread pushes, the render thread drains
+    // the queue at frame start (applySceneCommands)
+    MpscQueue<SceneCommand>                  sceneCommands;
+    std::atomic<SceneId>                     nextSceneId{1};
+    std::unordered_map<SceneId, EntityHandle> sceneSpheres;     // Applied creates (render thread)
+    std::vector<SceneId>                     slotSceneId;       // Entity slot -> its id in sceneSpheres (0 = none)
+
+    // Sphere acting as the light source, and its row this frame (-1 = none)
+    EntityHandle lightEntity;
+    int          lightRow = -1;
 
     // Mouse state
     float lastX = SCR_WIDTH / 2.0f;
     float lastY = SCR_HEIGHT / 2.0f;
     bool  firstMouse = true;
 
+    // Keyboard state for edge-triggered toggles
+    bool  keyDown[GLFW_KEY_LAST + 1] = {};
+
     // Frame timing
     float deltaTime = 0.0f;
     float lastFrame = 0.0f;
@@ -94,15 +410,64 @@ private:
     void createGlfwWindow(unsigned int width, unsigned int height,
                           const char* name);                      // Create + bind context + callbacks
     void loadGLAD();                                              // Load GL function pointers
-    void generateCameraView();                                    // Upload view/projection matrices
-    void setupSphereVertexBuffer(Sphere& sphere);                 // Lazy (re)upload sphere mesh
+    void generateCameraView(Shader& shader);                      // Upload view/projection matrices
+    unsigned int sceneFramebuffer() const;                        // HDR / offscreen target or default framebuffer
+    bool resolutionTarget() const;                                // Scene rendered through the DynamicResolution target
+    float emissiveScale() const;                                  // Light marker brightness in the scene target
+    void bindSceneTarget();                                       // Scene framebuffer + render-size viewport
+    glm::mat4 projectionMatrix() const;                           // Camera projection (reversed-Z when the context is)
+    glm::mat4 projectionMatrix(bool reversed) const;              // Camera projection in either depth convention
+    void loadShaderVariants();                                    // Build every sphere shader permutation
+    void applySceneCommands();                                    // Drain the scene queue (frame start)
+    EntityHandle addSphere(PoolHandle<Sphere> cold, const glm::dvec3& position,
+                           EntityHandle parent);                  // New entity + node (mesh on the next bucketSpheres)
+    void bucketSpheres();                                         // Sort spheres into per-variant draw lists
+    void animateLight();                                          // Move / recolour the animated light sphere
+    void updateRenderOrigin();                                    // Re-centre render space, update dirty transforms
+    void gatherLights();                                          // Every source sphere -> PointLight
+    const glm::mat4& sphereModel(uint32_t row) const;            // Model matrix of an entity (render space)
+    float sphereRadius(uint32_t row) const;                       // World-space bounding radius
+    void submitSphere(size_t drawIndex, uint32_t row);            // Direct or culled indirect draw
+    void updateAtmosphere(const glm::vec3& lightPos,
+                          const glm::vec3& lightColor);           // Planet LUTs for this frame's sun + camera
+    void updateProbes();                                          // Re-bake the probes this frame's changes reach
+    void updateVirtualTexture();                                  // Stream tiles, planet feedback pass
+    void renderMultiView(const glm::vec3& lightPos,
+                         const glm::vec3& lightColor);            // Every sphere once, instanced across the views
+    void drawBucket(ShaderVariant variant);                       // Unlit-path forward draw (emissive / planet)
+    void renderTranslucent(const glm::vec3& lightPos,
+                           const glm::vec3& lightColor);          // OIT accumulate + composite
+    void gatherCullBounds();                                      // Bounds of every draw + largest occluders
+    void cullSpheres();                                           // Hi-Z occluder pass + GPU cull
+    void cullSpheresCpu();                                        // Software occluder raster + CPU cull
+    void renderDepthPrepass();                                    // Depth-only pass over every sphere
+    void renderShadows();                                         // Static cache (if stale) + dynamic casters
+    void gatherOccluders();                                       // Per-tile sphere lists for analytic shadows
+    void renderForward(const glm::vec3& lightPos,
+                       const glm::vec3& lightColor);              // Optional prepass + per-bucket shading
+    void renderDeferred();                                        // G-buffer, light volumes, emissive markers
+    void renderVisibility(const glm::vec3& lightPos,
+                          const glm::vec3& lightColor);           // ID raster + full-screen resolve
+    void uploadGeometryPool();                                    // Every mesh into the visibility pools
+    void updateShadingTimings();                                  // Read back finished path timers
+    void updateOverdrawStats();                                   // Read back finished sample queries
+    void setupSphereVertexBuffer(uint32_t row);                   // Lazy (re)upload an entity's mesh
+    PoolHandle<Mesh> acquireMesh(const CubeSphere& geometry);     // Shared mesh of a geometry (+1 user), uploaded if new
+    void releaseMesh(PoolHandle<Mesh> handle);                    // Drop one user; delete with the last
+    void fillBuffer(GLenum target, PoolHandle<GpuBuffer> buffer,
+                    const void* data, size_t size);               // Pooled buffer upload (in place if same size)
+    Sphere& sphereOf(uint32_t row);                               // Cold data of an entity
+    const Mesh& meshOf(uint32_t row) const;                       // Mesh of an entity
+    void releaseMeshes();                                         // Delete every pooled mesh + buffer
     static void frameBufferSizeCallback(GLFWwindow* window,
                                         int width, int height);   // Resize viewport
-    void processKeyboardInput(GLFWwindow* window);                // WASD / vertical movement
+    void processKeyboardInput(GLFWwindow* window);                // WASD / vertical movement / toggles
+    bool keyPressed(int key);                                     // True once per key press
     static void mouseCallback(GLFWwindow* window,
                               double xpos, double ypos);          // Static → instance redirect
     void handleMouse(double xpos, double ypos);                   // Apply mouse delta to camera
-    void displayFrameRate(float deltaTime) const;                 // Title bar FPS update
+    void displayFrameRate(float deltaTime);                       // Title bar FPS update
+    void reportFirstFrame();                                      // Print time to first frame
     void cleanup();                                               // Release GL + GLFW resources
 };
 
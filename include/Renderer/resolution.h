@@ -0,0 +1,50 @@
+#ifndef RESOLUTION_H
+#define RESOLUTION_H
+
+#include <glad/glad.h>
+
+#include "glstate.h"        // Binds + counters
+
+// Dynamic resolution scaling.
+// The scene is rendered into the lower-left part of an offscreen target
+// (allocated at output size, grown only when the window grows) and upscaled
+// to the default framebuffer. After every finished GPU time measurement the
+// controller rescales the render area to hold the frame-time budget:
+// fragment cost ~ pixel count ~ scale^2, so the next scale is
+// scale * sqrt(budget / measured), dropping fast and recovering slowly.
+class DynamicResolution {
+public:
+    void init(GLState& state);
+
+    void begin(int outputWidth, int outputHeight,
+               bool scaled = true);                 // Pick this frame's render size (output size unless scaled), grow the target
+    void bindTarget();                              // Offscreen framebuffer + viewport at render size
+    void present();                                 // Bilinear upscale to the default framebuffer
+    void update(float gpuMs);                       // Feed one finished GPU time into the controller
+
+    int   renderWidth() const;
+    int   renderHeight() const;
+    float getScale() const;
+    unsigned int framebuffer() const;
+    void terminate();                               // Release GL objects
+
+    float budgetMs = 1000.0f / 60.0f;   // Target GPU time per frame
+    float minScale = 0.5f;              // Per-axis scale limits
+    float maxScale = 1.0f;
+    unsigned int samples = 0;           // Measurements fed to the controller
+    unsigned int misses = 0;            // ... of which exceeded the budget
+
+private:
+    GLState*     state = nullptr;
+    float        scale = 1.0f;
+    int          outputWidth = 0, outputHeight = 0;
+    int          width = 0, height = 0;             // Render size this frame
+    int          allocWidth = 0, allocHeight = 0;   // Target size
+    unsigned int fbo = 0;
+    unsigned int colorTexture = 0;                  // RGBA8
+    unsigned int depthStencil = 0;                  // DEPTH24_STENCIL8 renderbuffer
+
+    void allocate(int w, int h);
+};
+
+#endif
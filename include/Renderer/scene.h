@@ -0,0 +1,100 @@
+#ifndef SCENE_H
+#define SCENE_H
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "atmosphere.h"     // AtmosphereParams (prototype records)
+#include "entities.h"       // EntityStore, EntityFlag
+#include "transforms.h"     // TransformHierarchy
+
+// Sections of a scene file, in file order
+enum SceneSection : uint32_t {
+    SCENE_PROTOTYPES = 0,   // ScenePrototype[prototypeCount]
+    SCENE_POSITIONS,        // dvec3 per sphere, relative to its parent
+    SCENE_ROTATIONS,        // quat per sphere, relative to its parent
+    SCENE_SCALES,           // vec3 per sphere (local axis scale)
+    SCENE_PARENTS,          // uint32 per sphere: an earlier sphere, or SceneFile::NONE
+    SCENE_PROTOTYPE_INDEX,  // uint32 per sphere
+    SCENE_COLORS,           // vec3 per sphere
+    SCENE_OPACITY,          // float per sphere
+    SCENE_LIGHT_RANGE,      // float per sphere
+    SCENE_FLAGS,            // uint32 per sphere (SceneFile::FLAGS bits of EntityFlag)
+    SCENE_SECTION_COUNT
+};
+
+// Geometry + cold data shared by the spheres that reference it
+struct ScenePrototype {
+    float            radius = 1.0f;
+    uint32_t         subdivisions = 16;
+    uint32_t         hasAtmosphere = 0;
+    char             name[36] = {};         // Zero padded, not always terminated
+    AtmosphereParams atmosphere;
+};
+static_assert(std::is_trivially_copyable<ScenePrototype>::value, "ScenePrototype is stored as raw bytes");
+
+// One array per sphere field (a scene to save, or views into a mapped file)
+struct SceneColumns {
+    size_t            count = 0;
+    const glm::dvec3* positions = nullptr;
+    const glm::quat*  rotations = nullptr;
+    const glm::vec3*  scales = nullptr;
+    const uint32_t*   parents = nullptr;
+    const uint32_t*   prototypes = nullptr;
+    const glm::vec3*  colors = nullptr;
+    const float*      opacity = nullptr;
+    const float*      lightRange = nullptr;
+    const uint32_t*   flags = nullptr;
+};
+
+// Versioned binary scene: a 64-byte header, a section table, then one
+// section per column, each at a 64-byte aligned offset and checksummed.
+// open() maps the file privately (copy-on-write) and validates it;
+// columns() then points straight into the mapping, and instantiate() into an
+// empty scene adopts the stored columns as entity and transform storage, so
+// loading copies nothing but the pages later edited. Parents come before their children, which lets the
+// hierarchy be built in one pass. Files are host byte order (little endian).
+class SceneFile {
+public:
+    static constexpr uint32_t NONE = ~0u;
+    static constexpr uint32_t VERSION = 2;      // 2: local rotation + scale sections
+    static constexpr size_t   ALIGNMENT = 64;
+    static constexpr uint32_t FLAGS = ENTITY_SOURCE | ENTITY_DYNAMIC | ENTITY_ATMOSPHERE | ENTITY_VIRTUAL_TEXTURE;
+
+    SceneFile() = default;
+    SceneFile(const SceneFile&) = delete;
+    SceneFile& operator=(const SceneFile&) = delete;
+    ~SceneFile();
+
+    bool open(const std::string& path);         // Map + validate; false (ERROR printed) if missing or corrupt
+    void close();                               // Release the mapping (kept alive by columns adopted from it)
+
+    // Views into the mapping (valid until close())
+    const SceneColumns& columns() const;
+    const ScenePrototype* prototypes() const;
+    uint32_t prototypeCount() const;
+    uint32_t lightSphere() const;               // Sphere driving the animated light, or NONE
+
+    // Append every sphere to the store and the hierarchy in bulk (rows get
+    // no cold data or mesh; nodeEntity maps node id -> entity). First row.
+    // An empty store / hierarchy keeps its stored columns in the mapping.
+    uint32_t instantiate(EntityStore& entities, TransformHierarchy& transforms,
+                         std::vector<EntityHandle>& nodeEntity) const;
+
+    // Write a scene (through a temporary file, renamed once complete)
+    static bool save(const std::string& path, const SceneColumns& columns,
+                     const ScenePrototype* prototypes, uint32_t prototypeCount, uint32_t lightSphere);
+
+private:
+    std::shared_ptr<void> mapping;              // Unmapped with its last user
+    SceneColumns   view;
+    const ScenePrototype* prototypeView = nullptr;
+    uint32_t       prototypeTotal = 0;
+    uint32_t       light = NONE;
+};
+
+#endif
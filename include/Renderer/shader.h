@@ -7,26 +7,110 @@
 #include <sstream>
 #include <fstream>
 #include <iostream>
+#include <vector>
+#include <deque>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
 #include <glm/gtc/type_ptr.hpp>
 #include <glm/gtc/matrix_transform.hpp> // Provides glm matrix utilities
 
+#include "programcache.h"           // Persistent program binaries + parallel compile support
+#include "glstate.h"                // Redundant-bind filtering + per-frame counters
+#include "pool.h"                   // Program storage
+
 // Encapsulates an OpenGL shader program and uniform helpers
 class Shader {
 public:
-    unsigned int ID;                        // OpenGL shader program handle
+    unsigned int ID = 0;                    // OpenGL shader program handle
 
-    void load(const char* vertexPath, const char* fragmentPath); // Compiles and links vertex + fragment shaders
+    void setCache(ProgramCache* cache);      // Enables binary caching / async compile for later loads
+    void setState(GLState* state);           // Routes use() and uniform counts through a state cache
+    void load(const char* vertexPath, const char* fragmentPath,
+              const std::vector<std::string>& defines = {},
+              bool async = false);           // Compiles and links vertex + fragment shaders
+    void loadWithGeometry(const char* vertexPath, const char* geometryPath,
+                          const char* fragmentPath,
+                          const std::vector<std::string>& defines = {},
+                          bool async = false);   // Same with a geometry stage in between
+    void loadCompute(const char* computePath,
+                     const std::vector<std::string>& defines = {},
+                     bool async = false);    // Compiles and links a compute shader
+    bool isReady();                          // Polls an async build; true once the program is usable
+    bool fromCache() const;                  // True if the program was restored from a stored binary
     void use();                              // Activates the shader program
     void terminate();                        // Deletes the shader program
 
     void setBool(const char* name, int value) const;             // Sets a boolean (int) uniform
     void setInt(std::string &name, int value) const;             // Sets an integer uniform
+    void setInt(const char* name, int value) const;              // Sets an integer uniform
+    void setUint(const char* name, unsigned int value) const;    // Sets an unsigned integer uniform
     void setFloat(std::string &name, float value) const;         // Sets a float uniform
+    void setFloat(const char* name, float value) const;          // Sets a float uniform
+    void setVec2(const char* name, const glm::vec2& vec2) const; // Sets a vec2 uniform
     void setVec3(const char* name, const glm::vec3& vec3) const; // Sets a vec3 uniform
+    void setVec4(const char* name, const glm::vec4& vec4) const; // Sets a vec4 uniform
     void setMat4(const char* name, glm::mat4 mat) const;         // Sets a mat4 uniform
 
 private:    
+    ProgramCache* cache = nullptr;          // Optional binary cache (owned by the renderer)
+    GLState*      state = nullptr;          // Optional GL state cache (owned by the renderer)
+    mutable std::unordered_map<std::string_view, int> locations; // Uniform name -> location (no std::string per lookup)
+    mutable std::deque<std::string> locationNames;  // Key storage (deque: views stay valid as it grows)
+    uint64_t      cacheKey = 0;             // Key of the program being built
+    bool          pending = false;          // Async link still in flight
+    bool          cached = false;           // Restored from the binary cache
+    std::vector<std::pair<unsigned int, const char*>> stages; // Shader objects kept until the link completes
+
+    // Source for one pipeline stage after preprocessing
+    struct StageSource {
+        GLenum      type;
+        const char* name;           // Stage label for error output
+        std::string code;
+    };
+
+    int location(const char* name) const;                            // Cached glGetUniformLocation
+    void build(const std::vector<StageSource>& sources, bool async); // Cache lookup or compile + link
+    std::string preprocess(const std::string& path,
+                           const std::vector<std::string>& defines); // Resolves #include, injects #defines (+ REVERSE_Z)
+    void expandIncludes(const std::string& path, std::ostringstream& out,
+                        std::unordered_set<std::string>& included,
+                        int& fileIndex);                               // Recursive #include expansion
+    std::string readFile(const char* path);                         // Reads a whole shader source file
+    void finishLink();                                              // Checks errors, stores binary, frees shader objects
     void checkCompileErrors(unsigned int shader, const char* type); // Reports shader compile/link errors
 };
 
+// Keyed cache of compiled shader permutations.
+// Each distinct (sources, defines) set is compiled once and shared,
+// so specialised variants replace runtime uniform branches.
+class ShaderVariants {
+public:
+    void setCache(ProgramCache* cache);      // Binary cache passed on to every variant
+    void setState(GLState* state);           // GL state cache passed on to every variant
+
+    // Returns the variant for these sources + defines, building it on first use
+    Shader& get(const char* vertexPath, const char* fragmentPath,
+                const std::vector<std::string>& defines = {}, bool async = false);
+    // Same for a vertex + geometry + fragment program
+    Shader& getWithGeometry(const char* vertexPath, const char* geometryPath, const char* fragmentPath,
+                            const std::vector<std::string>& defines = {}, bool async = false);
+    // Same for a compute program
+    Shader& getCompute(const char* computePath,
+                       const std::vector<std::string>& defines = {}, bool async = false);
+
+    bool isReady();                          // True once every variant has finished linking
+    size_t size() const;                     // Number of compiled variants
+    void terminate();                        // Deletes every variant program
+
+private:
+    ProgramCache* cache = nullptr;
+    GLState*      state = nullptr;
+    Pool<Shader, 64> programs;                  // Blocks never move: references stay valid
+    std::unordered_map<std::string, PoolHandle<Shader>> variants;  // Key -> program
+
+    // Key from paths + sorted defines; sorts `defines` in place
+    static std::string makeKey(const std::vector<const char*>& paths, std::vector<std::string>& defines);
+};
+
 #endif
\ No newline at end of file
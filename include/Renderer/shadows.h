@@ -0,0 +1,62 @@
+#ifndef SHADOWS_H
+#define SHADOWS_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "shader.h"         // Layered caster program (via ShaderVariants)
+#include "glstate.h"        // Binds + counters
+
+// Omnidirectional shadow map for one point light.
+// All six cube faces are rendered in a single submission: a geometry shader
+// with 6 invocations routes each triangle to its face through gl_Layer.
+// Casters are split in two: static casters go into a cached cube map that is
+// only re-rendered when the light or a static caster moves; each frame the
+// cache is copied into the sampled map and only dynamic casters are drawn on
+// top (with no dynamic casters the cache is sampled directly).
+// Depth stores linear light distance / range.
+class PointShadowMap {
+public:
+    static const int SIZE = 1024;                   // Face resolution
+
+    void init(ShaderVariants& shaders, GLState& state);
+
+    // Static caster bounds (xyz centre, w radius) for this light; returns true
+    // when the cache is stale and has been bound + cleared for re-rendering
+    bool beginStatic(const glm::vec3& lightPos, float range,
+                     const std::vector<glm::vec4>& staticCasters);
+    void endStatic();
+
+    // Copy the cache into the frame map and bind it; false (nothing bound)
+    // when there are no dynamic casters and the cache is sampled directly
+    bool beginDynamic(size_t dynamicCasters);
+    void endDynamic();
+
+    Shader& casterShader();                         // Set "model" per caster
+    void bind(Shader& shader, unsigned int unit);   // Sampler + lookup uniforms on a lit program
+    bool cacheHit() const;                          // Last beginStatic() reused the cache
+    void terminate();                               // Release GL objects
+
+    unsigned int staticRenders = 0;                 // Static cache rebuilds since start
+
+private:
+    GLState*     state = nullptr;
+    Shader*      shader = nullptr;
+    unsigned int staticMap = 0, staticFbo = 0;      // Cached static casters
+    unsigned int frameMap = 0, frameFbo = 0;        // Static copy + dynamic casters
+    unsigned int sampled = 0;                       // Map bound for shading this frame
+    bool         hit = false;
+
+    // Cache key: light + every static caster at the last rebuild
+    glm::vec4              cachedLight{0.0f};
+    std::vector<glm::vec4> cachedCasters;
+    bool                   cacheValid = false;
+
+    glm::vec3    lightPos{0.0f};
+    float        range = 1.0f;
+
+    void setupPass(unsigned int fbo);               // Bind a layered target + upload face matrices
+};
+
+#endif
@@ -0,0 +1,80 @@
+#ifndef SOFTCULL_H
+#define SOFTCULL_H
+
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "workerpool.h"     // Band workers
+
+// Results of the last CPU cull (available immediately, no readback)
+struct SoftCullStats {
+    unsigned int tested        = 0; // Bounds submitted
+    unsigned int drawn         = 0; // Passed frustum + occlusion tests
+    unsigned int occluded      = 0; // Hidden behind the rasterised occluders
+    unsigned int frustumCulled = 0; // Off screen / beyond the far plane
+    unsigned int triangles     = 0; // Occluder hull triangles rasterised
+    float        rasterMs      = 0; // Setup + rasterisation + tile reduction
+    float        testMs        = 0; // Bounds tests
+};
+
+// Software occlusion culling, entirely on the CPU (no GL calls, usable headless).
+// The largest occluder spheres are rasterised as inscribed icosahedra into a
+// small depth buffer; the hull lies inside its sphere, so its depth is never
+// nearer than the real surface and the test stays conservative. Rows are
+// split into bands rasterised in parallel by worker threads, 8 pixels at a
+// time with AVX2 when the file is built with it. Each 8x8 tile keeps its
+// farthest depth, and every sphere's projected bounds are tested against the
+// tiles (then pixels, for small bounds) with the same rules as the Hi-Z pass.
+class SoftwareOcclusion {
+public:
+    static const int WIDTH  = 256;      // Depth buffer size (multiple of TILE)
+    static const int HEIGHT = 144;
+    static const int TILE   = 8;        // Tile edge in pixels (one AVX2 register wide)
+
+    SoftwareOcclusion();
+    ~SoftwareOcclusion();
+
+    void init(unsigned int workers = 0);    // Start workers (0 = cores - 1, at least 1)
+
+    // Rasterise occluders (xyz centre, w radius), then test every bound.
+    // Visibility per bound is read back with isVisible(i).
+    void cull(const std::vector<glm::vec4>& occluders,
+              const std::vector<glm::vec4>& bounds,
+              const glm::mat4& viewProjection);
+
+    bool isVisible(size_t index) const;     // Result of the last cull (true past the end)
+    const SoftCullStats& getStats() const;
+    const float* depthBuffer() const;       // WIDTH x HEIGHT window-space depth, row 0 at the bottom
+    unsigned int workerCount() const;
+    bool simd() const;                      // True when built with the AVX2 rasteriser
+    void terminate();                       // Join the workers
+
+private:
+    static const int TILES_X = WIDTH / TILE;
+    static const int TILES_Y = HEIGHT / TILE;
+
+    // Screen-space triangle set up once, rasterised by every band it touches
+    struct Triangle {
+        float edgeA[3], edgeB[3], edgeC[3]; // Edge functions: A*x + B*y + C >= 0 inside
+        float zA, zB, zC;                   // Depth plane: z = zA*x + zB*y + zC
+        int   minX, maxX, minY, maxY;       // Pixel bounds, clamped to the buffer
+    };
+
+    std::vector<float>         depth;       // Nearest occluder depth per pixel
+    std::vector<float>         tileMax;     // Farthest depth per tile
+    std::vector<Triangle>      triangles;
+    std::vector<unsigned char> visible;
+    std::vector<glm::vec3>     hull;        // Unit icosahedron, outward CCW triangles
+    SoftCullStats              stats;
+
+    // Each frame every worker rasterises its own band of tile rows
+    WorkerPool                 workers;
+
+    void buildHull();
+    void setupTriangles(const std::vector<glm::vec4>& occluders, const glm::mat4& viewProjection);
+    void rasterizeBand(int firstTileRow, int lastTileRow);          // Clear, raster, reduce [first, last)
+    void rasterizeRows(const Triangle& tri, int y0, int y1);        // One triangle into rows [y0, y1)
+    bool testBounds(const glm::vec4& bound, const glm::mat4& viewProjection);
+};
+
+#endif
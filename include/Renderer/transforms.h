@@ -0,0 +1,142 @@
+#ifndef TRANSFORMS_H
+#define TRANSFORMS_H
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "column.h"         // Column storage
+#include "workerpool.h"     // Level chunk workers
+
+// Work done by the last update()
+struct TransformStats {
+    unsigned int nodes   = 0;   // Live nodes
+    unsigned int updated = 0;   // World matrices recomputed
+    unsigned int levels  = 0;   // Hierarchy depth
+    unsigned int reorders = 0;  // Depth sorts so far (after re-parenting or an out-of-order batch)
+    float        updateMs = 0;  // CPU time of the update (0 when nothing was dirty)
+};
+
+// Parent-child transforms (position, rotation, scale) for the scene.
+// Nodes are stored depth-sorted in parallel arrays: every parent comes before
+// its children and each depth is one contiguous range, so a single forward
+// pass sees final parent matrices and the nodes of one depth are independent.
+// Setters mark a node dirty; update() recomputes dirty nodes and everything
+// below them, level by level, splitting large levels across worker threads,
+// with SSE mat4 products when available. Nothing dirty = no work.
+// Creating and destroying a node keep the order in place by moving one node
+// per deeper level (O(depth), independent of the node count); only
+// setParent() defers to a full re-sort at the next update().
+// Positions are doubles: world matrices are produced relative to a render
+// origin (camera-relative rendering), and moving the origin dirties the roots.
+class TransformHierarchy {
+public:
+    static constexpr uint32_t NONE = ~0u;
+    static constexpr size_t PARALLEL_MIN = 4096; // Nodes per level before the workers help
+
+    TransformHierarchy() = default;
+    ~TransformHierarchy();
+
+    void init(unsigned int workers = 0);        // Start workers (0 = cores - 1, at least 1)
+
+    // New node (identity rotation, unit scale); parent NONE = root, otherwise
+    // position is relative to the parent. Returns a stable node id.
+    uint32_t create(const glm::dvec3& position, uint32_t parent = NONE);
+    // Many nodes at once (a loaded scene): ids first .. first + count - 1,
+    // returns first. parents[i] indexes the batch (NONE = root) and must be
+    // < i. rotations, scales and parents may be null (identity, unit, all
+    // roots). Every array grows once. With an `owner`, the arrays are
+    // writable memory it keeps alive (a private scene file mapping): an empty
+    // hierarchy adopts them as its local transform and parent columns
+    // instead of copying them.
+    uint32_t createBatch(const glm::dvec3* positions, const glm::quat* rotations, const glm::vec3* scales,
+                         const uint32_t* parents, size_t count, std::shared_ptr<void> owner = nullptr);
+    void destroy(uint32_t node);                // Children become roots (keeping their local transform; O(subtree x depth))
+    void clear();                               // Remove every node (ids start again at 0)
+    bool setParent(uint32_t node, uint32_t parent);  // False (unchanged) if it would form a cycle
+
+    // Local transform (relative to the parent)
+    void setPosition(uint32_t node, const glm::dvec3& position);
+    void setRotation(uint32_t node, const glm::quat& rotation);
+    void setScale(uint32_t node, const glm::vec3& scale);
+    const glm::dvec3& getPosition(uint32_t node) const;
+    const glm::quat& getRotation(uint32_t node) const;
+    const glm::vec3& getScale(uint32_t node) const;
+    uint32_t getParent(uint32_t node) const;
+
+    // Recompute what changed since the last call; true if any world matrix did
+    bool update(const glm::dvec3& renderOrigin);
+    const std::vector<uint32_t>& updated() const;  // Node ids recomputed by the last update()
+
+    // Results of the last update()
+    const glm::mat4& world(uint32_t node) const;    // Render space (relative to the origin)
+    const glm::dvec3& worldPosition(uint32_t node) const;
+    float worldScale(uint32_t node) const;          // Largest axis scale (bounding radius factor)
+
+    const TransformStats& getStats() const;
+    unsigned int workerCount() const;
+    bool simd() const;                          // True when built with the SSE matrix product
+    void terminate();                           // Join the workers
+
+private:
+    // Indexed by sorted position
+    Column<uint32_t>        parentId;           // Parent node id, or NONE (its position is idIndex[parentId])
+    Column<uint32_t>        depth;
+    Column<glm::dvec3>      localPosition;
+    Column<glm::quat>       localRotation;
+    Column<glm::vec3>       localScale;
+    Column<glm::dvec3>      worldTranslation;   // Double world position (origin independent)
+    Column<glm::mat4>       worldMatrix;
+    Column<uint8_t>         dirty;              // Local transform changed since the last update
+    Column<uint32_t>        stamp;              // Update that last recomputed it
+    Column<uint32_t>        sortedId;           // Sorted position -> node id
+
+    // Indexed by node id
+    Column<uint32_t>        idIndex;            // Node id -> sorted position (NONE = free)
+    Column<uint32_t>        idParent;           // Parent node id (structure of record)
+    Column<uint32_t>        idFirstChild;       // Children as a doubly linked sibling list (NONE = leaf)
+    Column<uint32_t>        idNextSibling;      // Only meaningful for nodes with a parent
+    Column<uint32_t>        idPrevSibling;
+    std::vector<uint32_t>   freeIds;
+
+    std::vector<uint32_t>   levelStart;         // Sorted range of each depth (levelStart[d], levelStart[d + 1])
+    bool         orderDirty = false;            // Structure changed: re-sort before the next update
+    bool         anyDirty = false;
+    uint32_t     firstDirtyLevel = 0;           // Depth range holding dirty nodes
+    uint32_t     lastDirtyLevel = 0;
+    uint32_t     updateCount = 0;
+    glm::dvec3   origin{0.0};
+    std::vector<uint32_t> changed;              // Node ids recomputed by the last update()
+    TransformStats stats;
+
+    // Each level range too large for one thread is split in chunks, one per worker
+    WorkerPool                 workers;
+    std::vector<std::vector<uint32_t>> workerChanged;  // Per chunk, merged into `changed`
+
+    // Everything stored per sorted position, for moving a node between positions
+    struct Slot {
+        uint32_t   parentId, depth;
+        glm::dvec3 localPosition;
+        glm::quat  localRotation;
+        glm::vec3  localScale;
+        glm::dvec3 worldTranslation;
+        glm::mat4  worldMatrix;
+        uint8_t    dirty;
+        uint32_t   stamp, sortedId;
+    };
+
+    void markDirty(uint32_t index);
+    void link(uint32_t node, uint32_t parent);  // Add to the parent's child list (parent != NONE)
+    void unlink(uint32_t node);                 // Remove from its parent's child list (if any)
+    Slot readSlot(uint32_t index) const;
+    void writeSlot(uint32_t index, const Slot& slot);   // Also points idIndex at it
+    uint32_t insertSlot(uint32_t level);        // Open a position at the end of `level` (one move per deeper level)
+    void removeSlot(uint32_t index);            // Close a position (one move per deeper level)
+    void reroot(uint32_t node, uint32_t levels);    // Move a subtree `levels` shallower, keeping the order
+    void reorder();                             // Counting sort by depth (world results move along)
+    void updateRange(uint32_t begin, uint32_t end, std::vector<uint32_t>& out);
+};
+
+#endif
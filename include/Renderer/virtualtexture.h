@@ -0,0 +1,147 @@
+#ifndef VIRTUALTEXTURE_H
+#define VIRTUALTEXTURE_H
+
+#include <glad/glad.h>
+#include <cstdint>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "shader.h"         // Feedback program (via ShaderVariants)
+#include "glstate.h"        // Binds + counters
+
+// Tile streaming counters
+struct VirtualTextureStats {
+    unsigned int requested = 0;     // Distinct tiles in the last feedback readback
+    unsigned int resident  = 0;     // Tiles in the physical cache
+    unsigned int queued    = 0;     // Misses handed to the loader by the last readback
+    unsigned int streamed  = 0;     // Tiles uploaded so far
+    unsigned int evicted   = 0;     // Least recently used tiles replaced so far
+};
+
+// Tile file layout: this header, then every tile as SLOT_SIZE x SLOT_SIZE
+// linear RGBA8 texels (row-major, border included), ordered by level, face,
+// row, column. Faces follow CubeSphere::faceDirection.
+struct TileFileHeader {
+    char     magic[4];              // "VTEX"
+    uint32_t version;               // 1
+    uint32_t tileSize;              // Texels per tile edge without the border (TILE_SIZE)
+    uint32_t border;                // Texels repeated from the neighbours on each side (BORDER)
+    uint32_t faceTiles;             // Tiles per face edge at level 0 (power of two)
+    uint32_t levels;                // log2(faceTiles) + 1: the last level is one tile per face
+};
+
+// Virtual texture over the six CubeSphere faces (sparse virtual texturing).
+// Each face is a mip-mapped grid of tiles in a file of any size; the GPU
+// holds a page table (one RGBA8UI texel per tile: cache slot + resident
+// flag) and a fixed CACHE_SLOTS x CACHE_SLOTS tile cache. Every frame the
+// textured surface is drawn at 1/FEEDBACK_DIVISOR resolution writing the
+// tile each pixel wants; the readback (fenced, a few frames old) refreshes
+// the used tiles and queues the misses coarse-first for a loader thread
+// that reads them from the file. Loaded tiles replace the least recently
+// used slot, UPLOADS_PER_FRAME at a time. Shading walks up the mip chain to
+// the finest resident tile; the coarsest level is pinned, so there is
+// always one. GPU memory depends on CACHE_SLOTS, not on the imagery size.
+class VirtualTexture {
+public:
+    static const int TILE_SIZE = 128;               // Texels per tile edge...
+    static const int BORDER = 1;                    // ...plus this on each side (bilinear across tiles)
+    static const int SLOT_SIZE = TILE_SIZE + 2 * BORDER;
+    static const int CACHE_SLOTS = 10;              // Physical cache: 10 x 10 tiles (6.8 MB)
+    static const int MAX_FACE_TILES = 256;          // Feedback stores tile coordinates in 8 bits
+    static const int FEEDBACK_DIVISOR = 8;          // Feedback pass resolution divisor
+    static const int FEEDBACK_RING = 3;             // Readbacks in flight
+    static const int UPLOADS_PER_FRAME = 8;         // Tiles copied into the cache per update()
+    static const int DEMO_FACE_TILES = 8;           // Tiles per face edge of the generated file
+
+    ~VirtualTexture();
+
+    // Open the tile file (generated with writeDemo() when missing), allocate
+    // the page table + cache, load the pinned level and start the loader;
+    // false = no usable file (the textured surfaces keep their flat colour)
+    bool init(const char* tilePath, ShaderVariants& shaders, GLState& state);
+
+    static std::vector<std::string> defines();      // Variant of the programs sampling it
+
+    // Procedural planet imagery (oceans, land, ice) as a tile file
+    static bool writeDemo(const char* path, int faceTiles);
+
+    // Feedback pass: draw the textured surfaces with the returned program
+    // (camera + model uniforms are the caller's), then endFeedback()
+    Shader& beginFeedback(int renderWidth, int renderHeight);
+    void endFeedback();
+
+    // Read back the newest finished feedback, queue its misses and upload loaded tiles
+    void update();
+
+    void bind(Shader& shader, unsigned int unit) const;    // Page table on unit, cache on unit + 1
+
+    bool ready() const;                             // Tile file open
+    const VirtualTextureStats& getStats() const;
+    void terminate();                               // Stop the loader, release GL objects
+
+private:
+    // One cache slot
+    struct Slot {
+        uint32_t key = 0;                           // Tile held (valid when used)
+        bool     used = false;
+        bool     pinned = false;                    // Coarsest level: never evicted
+        uint64_t lastUsed = 0;                      // Readback that last wanted it
+    };
+
+    // Tile read by the loader, waiting for a slot
+    struct LoadedTile {
+        uint32_t                   key;
+        std::vector<unsigned char> texels;          // SLOT_SIZE^2 RGBA8
+    };
+
+    GLState*      state = nullptr;
+    Shader*       feedbackShader = nullptr;
+    bool          open = false;
+    TileFileHeader header{};
+
+    unsigned int  pageTable = 0;                    // RGBA8UI 2D array: faceTiles^2 x 6 layers, `levels` mips
+    unsigned int  cache = 0;                        // RGBA8, CACHE_SLOTS * SLOT_SIZE square
+    std::vector<Slot> slots;
+    std::unordered_map<uint32_t, int> slotOf;       // Resident tile -> slot
+    uint64_t      readbacks = 0;                    // LRU clock
+
+    // Feedback target + readback ring
+    unsigned int  feedbackFbo = 0;
+    unsigned int  feedbackTexture = 0;              // RGBA8UI: tile x, tile y, level, face + 1
+    unsigned int  feedbackDepth = 0;
+    int           feedbackWidth = 0, feedbackHeight = 0;
+    unsigned int  readbackBuffers[FEEDBACK_RING] = {};
+    GLsync        readbackFences[FEEDBACK_RING] = {};
+    int           readbackSizes[FEEDBACK_RING][2] = {};
+    int           readbackHead = 0;
+
+    // Loader thread: requests in, tiles out (both under `mutex`)
+    std::ifstream            file;                  // Only the loader reads it after init()
+    std::thread              loader;
+    std::mutex               mutex;
+    std::condition_variable  wake;
+    std::deque<uint32_t>     requests;              // Misses of the newest readback, coarse first
+    std::vector<LoadedTile>  loaded;
+    uint32_t                 loading = 0;           // Key being read (+1; 0 = idle)
+    bool                     quit = false;
+    std::vector<LoadedTile>  waiting;               // Loaded, waiting for an upload budget
+
+    VirtualTextureStats stats;
+
+    static uint32_t tileKey(int face, int level, int x, int y);
+    bool readTile(uint32_t key, unsigned char* texels);        // From the file (init + loader)
+    bool upload(const LoadedTile& tile, bool pin);              // Into a free / LRU slot
+    void setPage(uint32_t key, int slot);                       // Page table texel (-1 = absent)
+    void resizeFeedback(int width, int height);
+    bool readFeedback(std::vector<uint32_t>& keys);             // Newest finished readback
+    void loaderLoop();
+    void stopLoader();
+};
+
+#endif
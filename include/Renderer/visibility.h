@@ -0,0 +1,76 @@
+#ifndef VISIBILITY_H
+#define VISIBILITY_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <string>
+#include <vector>
+
+#include "shader.h"         // Raster / resolve programs (via ShaderVariants)
+#include "glstate.h"        // Binds + counters
+
+// Per-draw data read by the resolve pass (std430)
+struct VisInstance {
+    glm::mat4    model;
+    glm::vec4    color;             // rgb albedo, a = 1 for emissive (unlit)
+    unsigned int firstIndex;        // Offset of the mesh in the pooled index buffer
+    int          baseVertex;        // Offset of the mesh in the pooled position buffer (vertices)
+    unsigned int pad[2];
+};
+
+// Visibility-buffer shading.
+// The raster pass writes only (draw ID, gl_PrimitiveID) per pixel into an
+// RG32UI target. A full-screen resolve then fetches the triangle's three
+// vertices from pooled position/index SSBOs, rebuilds barycentrics by
+// intersecting the pixel's view ray with the triangle, and shades every
+// covered pixel exactly once (no quad overdraw, no per-triangle fragment waste).
+class VisibilityBuffer {
+public:
+    static const unsigned int EMPTY = 0xFFFFFFFFu;  // Draw ID of background pixels
+
+    // SSBO binding points used by shaders/fVisibilityResolve.glsl (shared with the
+    // Hi-Z compute passes, which finish before the resolve; 3-5 stay free for clusters)
+    static const unsigned int POSITIONS_BINDING = 0;
+    static const unsigned int INDICES_BINDING   = 1;
+    static const unsigned int INSTANCES_BINDING = 2;
+
+    // Raster program + both resolve variants (single light / clustered)
+    void init(ShaderVariants& shaders, GLState& state,
+              const std::vector<std::string>& clusteredDefines);
+    void resize(int width, int height);             // Render size (targets grow when needed)
+
+    // Pooled geometry of every mesh (xyz floats, triangle indices)
+    void uploadGeometry(const std::vector<float>& positions,
+                        const std::vector<unsigned int>& indices);
+    void uploadInstances(const std::vector<VisInstance>& instances);
+
+    Shader& beginRaster();          // Bind + clear the ID target; caller sets drawID per draw
+    void endRaster(unsigned int target);    // Copy depth to the scene framebuffer and bind it
+
+    // Bind IDs + pools and return the resolve program (caller sets lighting uniforms)
+    Shader& beginResolve(bool clustered);
+    void resolve();                 // Full-screen shading pass
+
+    void terminate();               // Release GL objects
+
+private:
+    GLState*     state = nullptr;
+    Shader*      rasterShader = nullptr;            // Writes (drawID, primitive ID)
+    Shader*      resolveShader = nullptr;           // Single light
+    Shader*      resolveClusteredShader = nullptr;  // Cluster light lists
+
+    int          width = 0, height = 0;             // Render size
+    int          allocWidth = 0, allocHeight = 0;   // Target size
+    unsigned int fbo = 0;
+    unsigned int idTexture = 0;     // RG32UI (draw ID, triangle ID)
+    unsigned int depthTexture = 0;  // DEPTH24_STENCIL8 (matches the scene target for the depth copy)
+    unsigned int positionBuffer = 0;
+    unsigned int indexBuffer = 0;
+    unsigned int instanceBuffer = 0;
+    size_t       instanceCapacity = 0;
+    unsigned int fullscreenVAO = 0;
+
+    void releaseTargets();
+};
+
+#endif
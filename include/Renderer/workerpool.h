@@ -0,0 +1,40 @@
+#ifndef WORKERPOOL_H
+#define WORKERPOOL_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of threads that run one job at a time, fork-join style: run()
+// hands the same function to every worker (with its index) and returns once
+// all of them are done. Shared by the CPU passes that split a range per worker.
+class WorkerPool {
+public:
+    WorkerPool() = default;
+    ~WorkerPool();
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    static unsigned int defaultSize();          // Cores - 1, at least 1
+
+    void init(unsigned int workers = 0);        // (Re)start workers (0 = defaultSize())
+    void run(const std::function<void(unsigned int)>& job);  // job(index) on every worker, then wait
+    unsigned int size() const;                  // 0 before init() / after terminate()
+    void terminate();                           // Join the workers
+
+private:
+    std::vector<std::thread>   workers;
+    std::mutex                 mutex;
+    std::condition_variable    wake;            // Main -> workers: new job
+    std::condition_variable    done;            // Workers -> main: job finished
+    const std::function<void(unsigned int)>* job = nullptr;
+    unsigned long long         generation = 0;  // Jobs started so far
+    unsigned int               pending = 0;     // Workers still running the current job
+    bool                       quit = false;
+
+    void workerLoop(unsigned int index, unsigned long long seen);  // seen = generation at start
+};
+
+#endif
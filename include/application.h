@@ -1,18 +1,26 @@
 #ifndef APPLICATION_H
 #define APPLICATION_H
 
+#include <string>
+
 #include "Renderer/renderer.h"
 
-// High–level application wrapper that owns persistent Sphere instances
-// and the Renderer. Constructs scene objects, registers them with the
-// renderer, then hands control to the render loop.
+// High–level application wrapper that owns the Renderer. Loads the scene
+// file it was given (e.g. an F7 snapshot) or, without one or when it fails
+// to load, describes the built-in scene objects and registers them with the
+// renderer (which keeps its own copies), then hands control to the render loop.
 class App {
 public:
-    App() {
+    explicit App(const std::string& scenePath = "") {
 
         // Initialize rendering subsystem (GLFW, GLAD, shader, state)
         renderer.init();
 
+        // Scene file from the command line (errors are printed by loadScene)
+        if (!scenePath.empty() && renderer.loadScene(scenePath)) return;
+
+        Sphere coral, lagoon, veil, planet, light;
+
         // Configure first sphere (Coral)
         coral.Name  = "Coral";
         coral.Color = {1.0f, 0.5f, 0.31f};
@@ -31,6 +39,23 @@ public:
         renderer.drawSphere(coral,  { 0.7f,  0.0f,  0.0f});
         renderer.drawSphere(lagoon, {-0.7f,  0.0f,  0.0f});
 
+        // Translucent sphere overlapping both (order-independent transparency)
+        veil.Name    = "Veil";
+        veil.Color   = {0.3f, 0.6f, 1.0f};
+        veil.Opacity = 0.35f;
+        veil.setRadius(0.6f);
+        renderer.drawSphere(veil, {0.0f, 0.0f, 0.0f});
+
+        // Planet below the scene with an Earth-like atmosphere (heights x8 so the
+        // shell is visible at this scale)
+        planet.Name  = "Planet";
+        planet.Color = {0.25f, 0.35f, 0.2f};
+        planet.hasAtmosphere = true;
+        planet.virtualTextured = true;  // Streamed cube-face imagery (Color until the first tiles land)
+        planet.atmosphere.exaggerate(8.0f);
+        planet.setRadius(8.0f);
+        renderer.drawSphere(planet, {0.0f, -9.0f, -4.0f});
+
         // Configure light marker sphere
         light.Name   = "Light";
         light.Color  = {1.0f, 1.0f, 1.0f};
@@ -52,11 +77,6 @@ public:
     }
 
 private:
-    // Persistent scene objects (must outlive renderer usage)
-    Sphere coral;
-    Sphere lagoon;
-    Sphere light;
-
     // Rendering engine instance
     Renderer renderer;
 };
@@ -12,5 +12,7 @@ constexpr const char* APP_NAME = "Sphere";
 
 // Camera settings
 constexpr float FOV = 45.0f;
+constexpr float NEAR_PLANE = 0.1f;
+constexpr float FAR_PLANE  = 100.0f;  // Light cluster slices span NEAR_PLANE..FAR_PLANE, the last one reaching to infinity like the projection
 
 #endif
\ No newline at end of file
@@ -0,0 +1,192 @@
+// Precomputed atmospheric scattering shared by the LUT passes and the
+// programs that read the LUTs. Everything is in planet space: origin at the
+// planet centre, lengths in planet radii (ground at r = 1).
+const float ATMOSPHERE_PI = 3.14159265;
+
+uniform float atmosphereTop;        // 1 + thickness
+uniform vec3  rayleighScattering;
+uniform float rayleighScaleHeight;
+uniform float mieScattering;
+uniform float mieExtinction;        // Scattering + absorption
+uniform float mieScaleHeight;
+uniform float mieG;
+uniform vec3  ozoneAbsorption;
+uniform float ozoneCenter;
+uniform float ozoneWidth;
+
+uniform vec3  planetCenter;         // World space
+uniform float planetRadius;
+uniform vec3  atmosphereCamera;     // Camera in planet space
+uniform vec3  sunDirection;         // Towards the sun
+uniform vec3  sunIlluminance;
+
+uniform sampler2D transmittanceLut;
+uniform sampler2D multiScatteringLut;
+uniform sampler2D skyViewLut;
+
+// Scattering / extinction coefficients at radius r
+struct Medium {
+    vec3 rayleigh;      // Rayleigh scattering
+    vec3 mie;           // Mie scattering (grey)
+    vec3 scattering;
+    vec3 extinction;
+};
+
+Medium sampleMedium(float r) {
+    float h = max(r - 1.0, 0.0);
+    float mieDensity = exp(-h / mieScaleHeight);
+    float ozoneDensity = max(0.0, 1.0 - abs(h - ozoneCenter) / ozoneWidth);
+
+    Medium m;
+    m.rayleigh = rayleighScattering * exp(-h / rayleighScaleHeight);
+    m.mie = vec3(mieScattering * mieDensity);
+    m.scattering = m.rayleigh + m.mie;
+    m.extinction = m.rayleigh + mieExtinction * mieDensity + ozoneAbsorption * ozoneDensity;
+    return m;
+}
+
+float rayleighPhase(float cosTheta) {
+    return 3.0 / (16.0 * ATMOSPHERE_PI) * (1.0 + cosTheta * cosTheta);
+}
+
+// Cornette-Shanks
+float miePhase(float cosTheta) {
+    float g2 = mieG * mieG;
+    float k = 3.0 / (8.0 * ATMOSPHERE_PI) * (1.0 - g2) / (2.0 + g2);
+    return k * (1.0 + cosTheta * cosTheta) / pow(max(1.0 + g2 - 2.0 * mieG * cosTheta, 1e-4), 1.5);
+}
+
+// Entry / exit distances of a ray against the centred sphere of radius R
+// (both negative when it misses)
+vec2 raySphere(vec3 origin, vec3 dir, float R) {
+    float b = dot(origin, dir);
+    float c = dot(origin, origin) - R * R;
+    float d = b * b - c;
+    if (d < 0.0) return vec2(-1.0);
+    float s = sqrt(d);
+    return vec2(-b - s, -b + s);
+}
+
+// True when a ray from radius r with zenith cosine mu meets the ground
+bool rayHitsGround(float r, float mu) {
+    return mu < 0.0 && r * r * (mu * mu - 1.0) + 1.0 >= 0.0;
+}
+
+// Unit LUT coordinates -> texture coordinates hitting the first / last texel centres
+vec2 lutUv(sampler2D lut, vec2 uv) {
+    vec2 size = vec2(textureSize(lut, 0));
+    return (uv * (size - 1.0) + 0.5) / size;
+}
+
+// Transmittance LUT parameterisation (Bruneton): distance to the top
+// relative to its range at this height, and height via the horizon distance
+vec2 transmittanceUv(float r, float mu) {
+    float H = sqrt(atmosphereTop * atmosphereTop - 1.0);
+    float rho = sqrt(max(r * r - 1.0, 0.0));
+    float d = max(0.0, -r * mu + sqrt(max(r * r * (mu * mu - 1.0) + atmosphereTop * atmosphereTop, 0.0)));
+    float dMin = atmosphereTop - r;
+    float dMax = rho + H;
+    return vec2((d - dMin) / max(dMax - dMin, 1e-6), rho / H);
+}
+
+void transmittanceParams(vec2 uv, out float r, out float mu) {
+    float H = sqrt(atmosphereTop * atmosphereTop - 1.0);
+    float rho = H * uv.y;
+    r = sqrt(rho * rho + 1.0);
+    float dMin = atmosphereTop - r;
+    float dMax = rho + H;
+    float d = dMin + uv.x * (dMax - dMin);
+    mu = d == 0.0 ? 1.0 : clamp((H * H - rho * rho - d * d) / (2.0 * r * d), -1.0, 1.0);
+}
+
+// Transmittance from radius r to the top of the atmosphere (0 when the ground is in the way)
+vec3 transmittanceToTop(float r, float mu) {
+    if (rayHitsGround(r, mu)) return vec3(0.0);
+    vec2 uv = transmittanceUv(clamp(r, 1.0, atmosphereTop), mu);
+    return texture(transmittanceLut, lutUv(transmittanceLut, clamp(uv, 0.0, 1.0))).rgb;
+}
+
+// Multiple scattering per unit scattering coefficient (isotropic)
+vec3 multiScattering(float r, float muS) {
+    vec2 uv = vec2(muS * 0.5 + 0.5, (r - 1.0) / (atmosphereTop - 1.0));
+    return texture(multiScatteringLut, lutUv(multiScatteringLut, clamp(uv, 0.0, 1.0))).rgb;
+}
+
+// Sky-view LUT frame: zenith = up, azimuth measured from the sun's azimuth
+vec3 skyViewForward(vec3 up) {
+    vec3 sun = sunDirection - up * dot(sunDirection, up);
+    if (dot(sun, sun) > 1e-8) return normalize(sun);
+    return normalize(cross(up, abs(up.y) < 0.99 ? vec3(0.0, 1.0, 0.0) : vec3(1.0, 0.0, 0.0)));
+}
+
+// Zenith angle of the horizon seen from radius r
+float horizonZenith(float r) {
+    return ATMOSPHERE_PI - asin(min(1.0 / r, 1.0));
+}
+
+// Half the rows above the horizon and half below, both squeezed towards it
+vec2 skyViewUv(vec3 position, vec3 dir) {
+    float r = length(position);
+    vec3 up = position / r;
+    float zenith = acos(clamp(dot(dir, up), -1.0, 1.0));
+    float horizon = horizonZenith(r);
+    float v = zenith < horizon
+        ? 0.5 * (1.0 - sqrt(max(1.0 - zenith / horizon, 0.0)))
+        : 0.5 + 0.5 * sqrt(max((zenith - horizon) / (ATMOSPHERE_PI - horizon), 0.0));
+
+    vec3 horizontal = dir - up * dot(dir, up);
+    float cosAzimuth = dot(horizontal, horizontal) > 1e-8 ? dot(normalize(horizontal), skyViewForward(up)) : 1.0;
+    return vec2(acos(clamp(cosAzimuth, -1.0, 1.0)) / ATMOSPHERE_PI, v);
+}
+
+vec3 skyViewDirection(vec2 uv, vec3 position) {
+    float r = length(position);
+    vec3 up = position / r;
+    float horizon = horizonZenith(r);
+    float zenith;
+    if (uv.y < 0.5) {
+        float t = 1.0 - 2.0 * uv.y;
+        zenith = horizon * (1.0 - t * t);
+    } else {
+        float t = 2.0 * uv.y - 1.0;
+        zenith = horizon + t * t * (ATMOSPHERE_PI - horizon);
+    }
+    float azimuth = uv.x * ATMOSPHERE_PI;
+
+    vec3 forward = skyViewForward(up);
+    vec3 side = cross(up, forward);
+    return up * cos(zenith) + (forward * cos(azimuth) + side * sin(azimuth)) * sin(zenith);
+}
+
+// In-scattered light along a view ray from the camera (to the ground or out of the atmosphere)
+vec3 skyView(vec3 dir) {
+    vec2 uv = skyViewUv(atmosphereCamera, dir);
+    return texture(skyViewLut, lutUv(skyViewLut, uv)).rgb;
+}
+
+// Transmittance between the camera and a visible ground point (planet space):
+// both legs continue to the top in the same direction, so it is their ratio
+vec3 viewTransmittance(vec3 ground) {
+    vec3 toCamera = normalize(atmosphereCamera - ground);
+    float rg = length(ground);
+    vec3 fromGround = transmittanceToTop(max(rg, 1.0), dot(ground / rg, toCamera));
+
+    // Outside the atmosphere the camera leg starts where the ray enters it
+    vec3 start = atmosphereCamera;
+    if (length(start) > atmosphereTop) {
+        vec2 top = raySphere(start, -toCamera, atmosphereTop);
+        if (top.x > 0.0) start += -toCamera * top.x;
+    }
+    float rc = length(start);
+    vec3 fromCamera = transmittanceToTop(rc, dot(start / rc, toCamera));
+    return clamp(fromGround / max(fromCamera, vec3(1e-6)), 0.0, 1.0);
+}
+
+// Sky light reaching the ground, from the vertical scattering column: single
+// scattering with an isotropic phase plus the multiple-scattering term
+// (average path about twice the column, irradiance = PI * radiance)
+vec3 skyIrradiance(float r, float muS) {
+    vec3 column = rayleighScattering * rayleighScaleHeight + vec3(mieScattering * mieScaleHeight);
+    vec3 single = transmittanceToTop(r, max(muS, 0.0)) / (4.0 * ATMOSPHERE_PI);
+    return ATMOSPHERE_PI * 2.0 * column * (single + multiScattering(r, muS));
+}
@@ -0,0 +1,83 @@
+#version 430 core
+// Multiple-scattering LUT (Hillaire 2020): for each (sun cosine, height), the
+// second-order light arriving from 64 directions (sun single scattering, with
+// the ground bounce) and the fraction f of light the medium scatters back;
+// the infinite series of higher orders sums to L2 / (1 - f). One workgroup
+// per texel, one invocation per direction.
+layout (local_size_x = 64) in;
+
+layout (rgba16f, binding = 0) uniform writeonly image2D lut;
+
+#include "atmosphere.glsl"
+
+uniform vec3 groundAlbedo;
+
+const int STEPS = 20;
+
+shared vec3 sharedLight[64];
+shared vec3 sharedTransfer[64];
+
+void main() {
+    ivec2 p = ivec2(gl_WorkGroupID.xy);
+    vec2 uv = vec2(p) / vec2(imageSize(lut) - 1);
+    float muS = uv.x * 2.0 - 1.0;
+    float r = mix(1.0 + 1e-4, atmosphereTop - 1e-4, uv.y);
+    vec3 origin = vec3(0.0, r, 0.0);
+    vec3 sun = vec3(sqrt(max(1.0 - muS * muS, 0.0)), muS, 0.0);
+
+    // Stratified uniform direction on the sphere (8 x 8)
+    uint i = gl_LocalInvocationIndex;
+    float cosTheta = 1.0 - 2.0 * (float(i / 8u) + 0.5) / 8.0;
+    float sinTheta = sqrt(max(1.0 - cosTheta * cosTheta, 0.0));
+    float phi = 2.0 * ATMOSPHERE_PI * (float(i % 8u) + 0.5) / 8.0;
+    vec3 dir = vec3(sinTheta * cos(phi), cosTheta, sinTheta * sin(phi));
+
+    float tMax = raySphere(origin, dir, atmosphereTop).y;
+    float ground = raySphere(origin, dir, 1.0).x;
+    bool hitsGround = ground > 0.0;
+    if (hitsGround) tMax = ground;
+
+    vec3 light = vec3(0.0);         // Second order, unit sun illuminance
+    vec3 transfer = vec3(0.0);      // Scattered fraction of unit isotropic light
+    vec3 transmittance = vec3(1.0);
+    float dt = tMax / float(STEPS);
+    for (int k = 0; k < STEPS; ++k) {
+        vec3 x = origin + dir * ((float(k) + 0.5) * dt);
+        float rx = length(x);
+        Medium m = sampleMedium(rx);
+        vec3 extinction = max(m.extinction, vec3(1e-6));
+        vec3 stepTransmittance = exp(-m.extinction * dt);
+
+        // Analytic integral over the step of S * exp(-extinction * t)
+        vec3 S = transmittanceToTop(rx, dot(x / rx, sun)) * m.scattering / (4.0 * ATMOSPHERE_PI);
+        light += transmittance * (S - S * stepTransmittance) / extinction;
+        transfer += transmittance * (m.scattering - m.scattering * stepTransmittance) / extinction;
+        transmittance *= stepTransmittance;
+    }
+
+    // Lambertian ground lit by the attenuated sun
+    if (hitsGround) {
+        vec3 x = origin + dir * tMax;
+        vec3 n = normalize(x);
+        float cosSun = dot(n, sun);
+        light += transmittance * transmittanceToTop(1.0, cosSun) * max(cosSun, 0.0) * groundAlbedo / ATMOSPHERE_PI;
+    }
+
+    // Average over the sphere of directions (isotropic phase)
+    sharedLight[i] = light;
+    sharedTransfer[i] = transfer;
+    barrier();
+    for (uint s = 32u; s > 0u; s >>= 1) {
+        if (i < s) {
+            sharedLight[i] += sharedLight[i + s];
+            sharedTransfer[i] += sharedTransfer[i + s];
+        }
+        barrier();
+    }
+
+    if (i == 0u) {
+        vec3 L2 = sharedLight[0] / 64.0;
+        vec3 f = sharedTransfer[0] / 64.0;
+        imageStore(lut, p, vec4(L2 / max(1.0 - f, vec3(1e-4)), 1.0));
+    }
+}
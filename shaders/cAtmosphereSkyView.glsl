@@ -0,0 +1,53 @@
+#version 430 core
+// Sky-view LUT: in-scattered light towards the camera for every view
+// direction (latitude squeezed towards the horizon, azimuth from the sun),
+// marched through the atmosphere with the transmittance and multi-scattering
+// LUTs. Rays end on the ground, so below-horizon texels hold the aerial
+// perspective of the planet surface. Rebuilt every frame.
+layout (local_size_x = 8, local_size_y = 8) in;
+
+layout (rgba16f, binding = 0) uniform writeonly image2D lut;
+
+#include "atmosphere.glsl"
+
+const int STEPS = 30;
+
+vec3 integrateScattering(vec3 origin, vec3 dir) {
+    vec2 top = raySphere(origin, dir, atmosphereTop);
+    if (top.y <= 0.0) return vec3(0.0);     // Misses the atmosphere
+    float t0 = max(top.x, 0.0);             // Outside: start where the ray enters
+    float t1 = top.y;
+    float ground = raySphere(origin, dir, 1.0).x;
+    if (ground > 0.0) t1 = min(t1, ground);
+
+    float cosTheta = dot(dir, sunDirection);
+    float phaseR = rayleighPhase(cosTheta);
+    float phaseM = miePhase(cosTheta);
+
+    vec3 light = vec3(0.0);
+    vec3 transmittance = vec3(1.0);
+    float dt = (t1 - t0) / float(STEPS);
+    for (int k = 0; k < STEPS; ++k) {
+        vec3 x = origin + dir * (t0 + (float(k) + 0.5) * dt);
+        float rx = length(x);
+        float muS = dot(x / rx, sunDirection);
+        Medium m = sampleMedium(rx);
+        vec3 extinction = max(m.extinction, vec3(1e-6));
+        vec3 stepTransmittance = exp(-m.extinction * dt);
+
+        vec3 single = transmittanceToTop(rx, muS) * (m.rayleigh * phaseR + m.mie * phaseM);
+        vec3 S = sunIlluminance * (single + multiScattering(rx, muS) * m.scattering);
+        light += transmittance * (S - S * stepTransmittance) / extinction;
+        transmittance *= stepTransmittance;
+    }
+    return light;
+}
+
+void main() {
+    ivec2 p = ivec2(gl_GlobalInvocationID.xy);
+    ivec2 size = imageSize(lut);
+    if (p.x >= size.x || p.y >= size.y) return;
+
+    vec3 dir = skyViewDirection(vec2(p) / vec2(size - 1), atmosphereCamera);
+    imageStore(lut, p, vec4(integrateScattering(atmosphereCamera, dir), 1.0));
+}
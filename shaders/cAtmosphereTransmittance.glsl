@@ -0,0 +1,30 @@
+#version 430 core
+// Transmittance LUT: optical depth from (height, zenith cosine) to the top of
+// the atmosphere, integrated once per parameter change
+layout (local_size_x = 8, local_size_y = 8) in;
+
+layout (rgba16f, binding = 0) uniform writeonly image2D lut;
+
+#include "atmosphere.glsl"
+
+const int STEPS = 40;
+
+void main() {
+    ivec2 p = ivec2(gl_GlobalInvocationID.xy);
+    ivec2 size = imageSize(lut);
+    if (p.x >= size.x || p.y >= size.y) return;
+
+    float r, mu;
+    transmittanceParams(vec2(p) / vec2(size - 1), r, mu);
+    vec3 origin = vec3(0.0, r, 0.0);
+    vec3 dir = vec3(sqrt(max(1.0 - mu * mu, 0.0)), mu, 0.0);
+
+    float dt = max(raySphere(origin, dir, atmosphereTop).y, 0.0) / float(STEPS);
+    vec3 depth = vec3(0.0);
+    for (int i = 0; i < STEPS; ++i) {
+        vec3 x = origin + dir * ((float(i) + 0.5) * dt);
+        depth += sampleMedium(length(x)).extinction * dt;
+    }
+
+    imageStore(lut, p, vec4(exp(-depth), 1.0));
+}
@@ -0,0 +1,45 @@
+#version 430 core
+// Dual-filter bloom downsample: one target texel from 5 bilinear taps of the
+// level above (centre x4 + four diagonal corners one source texel out). The
+// first pass reads the HDR scene and keeps only what is above the threshold.
+layout (local_size_x = 8, local_size_y = 8) in;
+
+layout (r11f_g11f_b10f, binding = 0) uniform writeonly image2D target;
+
+#include "postprocess.glsl"
+
+uniform sampler2D source;
+uniform float sourceLod;
+uniform vec2  sourceTexel;      // 1 / allocated size of the source mip
+uniform vec2  sourceSize;       // Used area of the source mip
+uniform vec2  targetSize;
+uniform int   prefilter;        // 1 on the scene -> half-resolution pass
+uniform float threshold;
+uniform float knee;
+
+vec3 tap(vec2 uv) {
+    return sampleArea(source, uv, sourceLod, sourceSize, sourceTexel);
+}
+
+// Soft-knee bright pass: quadratic ease-in over [threshold - knee, threshold + knee]
+vec3 brightPass(vec3 color) {
+    float brightness = max(color.r, max(color.g, color.b));
+    float soft = clamp(brightness - threshold + knee, 0.0, 2.0 * knee);
+    soft = soft * soft / (4.0 * knee + 1e-5);
+    return color * max(soft, brightness - threshold) / max(brightness, 1e-5);
+}
+
+void main() {
+    ivec2 p = ivec2(gl_GlobalInvocationID.xy);
+    if (any(greaterThanEqual(vec2(p), targetSize))) return;
+
+    vec2 uv = sourceUv(p, targetSize, sourceSize, sourceTexel);
+    vec2 d = sourceTexel;
+    vec3 sum = tap(uv) * 4.0 +
+               tap(uv + vec2(-d.x, -d.y)) + tap(uv + vec2(d.x, -d.y)) +
+               tap(uv + vec2(-d.x,  d.y)) + tap(uv + vec2(d.x,  d.y));
+    vec3 color = sum / 8.0;
+    if (prefilter != 0) color = brightPass(color);
+
+    imageStore(target, p, vec4(color, 1.0));
+}
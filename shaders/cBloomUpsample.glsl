@@ -0,0 +1,39 @@
+#version 430 core
+// Dual-filter bloom upsample: the coarser result through an 8-tap tent
+// (edge taps x1, diagonal taps x2, half a source texel out) added to this
+// level's downsample.
+layout (local_size_x = 8, local_size_y = 8) in;
+
+layout (r11f_g11f_b10f, binding = 0) uniform writeonly image2D target;
+
+#include "postprocess.glsl"
+
+uniform sampler2D source;       // Coarser level (upsampled so far)
+uniform float sourceLod;
+uniform vec2  sourceTexel;
+uniform vec2  sourceSize;
+uniform sampler2D base;         // Downsample chain at the target level
+uniform float baseLod;
+uniform vec2  baseTexel;
+uniform vec2  baseSize;
+uniform vec2  targetSize;
+
+vec3 tap(vec2 uv) {
+    return sampleArea(source, uv, sourceLod, sourceSize, sourceTexel);
+}
+
+void main() {
+    ivec2 p = ivec2(gl_GlobalInvocationID.xy);
+    if (any(greaterThanEqual(vec2(p), targetSize))) return;
+
+    vec2 uv = sourceUv(p, targetSize, sourceSize, sourceTexel);
+    vec2 h = 0.5 * sourceTexel;
+    vec3 sum = tap(uv + vec2(-2.0 * h.x, 0.0)) + tap(uv + vec2(2.0 * h.x, 0.0)) +
+               tap(uv + vec2(0.0, -2.0 * h.y)) + tap(uv + vec2(0.0, 2.0 * h.y)) +
+               2.0 * (tap(uv + vec2(-h.x, -h.y)) + tap(uv + vec2(h.x, -h.y)) +
+                      tap(uv + vec2(-h.x,  h.y)) + tap(uv + vec2(h.x,  h.y)));
+    vec3 upsampled = sum / 12.0;
+
+    vec3 level = sampleArea(base, sourceUv(p, targetSize, baseSize, baseTexel), baseLod, baseSize, baseTexel);
+    imageStore(target, p, vec4(level + upsampled, 1.0));
+}
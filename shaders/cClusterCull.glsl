@@ -0,0 +1,72 @@
+#version 430 core
+// Bins point lights into the cluster grid: one invocation per cluster,
+// lights streamed through shared memory in batches.
+layout (local_size_x = 128) in;
+
+#include "clusters.glsl"
+#include "depth.glsl"
+
+uniform mat4 view;
+uniform mat4 inverseProjection;
+uniform uint lightCount;
+
+shared vec4 batch[128];         // view-space position + range
+
+// View-space point on the ray through an NDC xy corner at a given depth
+vec3 cornerAtDepth(vec2 ndc, float depth) {
+    vec4 p = inverseProjection * vec4(ndc, NDC_NEAR, 1.0);
+    vec3 dir = p.xyz / p.w;
+    return dir * (depth / -dir.z);
+}
+
+void main() {
+    uint cluster = gl_GlobalInvocationID.x;
+    uint total = CLUSTER_GRID_X * CLUSTER_GRID_Y * CLUSTER_GRID_Z;
+    bool active = cluster < total;
+
+    // Cluster AABB in view space
+    uvec3 cell = uvec3(cluster % CLUSTER_GRID_X,
+                       (cluster / CLUSTER_GRID_X) % CLUSTER_GRID_Y,
+                       cluster / (CLUSTER_GRID_X * CLUSTER_GRID_Y));
+    vec2 ndcMin = vec2(cell.xy) / vec2(CLUSTER_GRID_X, CLUSTER_GRID_Y) * 2.0 - 1.0;
+    vec2 ndcMax = vec2(cell.xy + 1u) / vec2(CLUSTER_GRID_X, CLUSTER_GRID_Y) * 2.0 - 1.0;
+    // The last slice also holds everything past zFar (clusterSlice clamps),
+    // and the projection has no far plane: it reaches out to "infinity"
+    float d0 = sliceStart(cell.z);
+    float d1 = cell.z + 1u < CLUSTER_GRID_Z ? sliceStart(cell.z + 1u) : 1e30;
+
+    vec3 aabbMin = vec3( 1e30);
+    vec3 aabbMax = vec3(-1e30);
+    for (int c = 0; c < 4; ++c) {
+        vec2 ndc = vec2((c & 1) != 0 ? ndcMax.x : ndcMin.x, (c & 2) != 0 ? ndcMax.y : ndcMin.y);
+        vec3 pn = cornerAtDepth(ndc, d0);
+        vec3 pf = cornerAtDepth(ndc, d1);
+        aabbMin = min(aabbMin, min(pn, pf));
+        aabbMax = max(aabbMax, max(pn, pf));
+    }
+
+    uint visible = 0u;
+    for (uint base = 0u; base < lightCount; base += 128u) {
+        // Cooperative load of the next batch (view-space)
+        uint li = base + gl_LocalInvocationID.x;
+        if (li < lightCount) {
+            vec4 l = lights[li].positionRange;
+            batch[gl_LocalInvocationID.x] = vec4((view * vec4(l.xyz, 1.0)).xyz, l.w);
+        }
+        barrier();
+
+        uint batchSize = min(128u, lightCount - base);
+        for (uint i = 0u; active && i < batchSize && visible < MAX_LIGHTS_PER_CLUSTER; ++i) {
+            vec4 l = batch[i];
+            vec3 closest = clamp(l.xyz, aabbMin, aabbMax);
+            vec3 d = closest - l.xyz;
+            if (dot(d, d) <= l.w * l.w) {
+                clusterLightIndex[cluster * MAX_LIGHTS_PER_CLUSTER + visible] = base + i;
+                ++visible;
+            }
+        }
+        barrier();
+    }
+
+    if (active) clusterLightCount[cluster] = visible;
+}
@@ -0,0 +1,26 @@
+#version 430 core
+// Stream compaction: every element flagged 1 is written to its scanned
+// offset, preserving order. The last invocation stores the kept count.
+layout (local_size_x = 256) in;
+
+#include "dispatch.glsl"
+
+layout (std430, binding = 0) readonly buffer Input { uint inputs[]; };
+layout (std430, binding = 1) readonly buffer Flags { uint flags[]; };         // 1 = keep, 0 = drop
+layout (std430, binding = 2) readonly buffer Offsets { uint offsets[]; };     // Exclusive scan of flags
+layout (std430, binding = 3) writeonly buffer Output { uint outputs[]; };
+layout (std430, binding = 4) writeonly buffer Kept { uint keptCount; };
+
+uniform uint count;
+
+void main() {
+    uint group = groupIndex();
+    if (group >= groupCount) return;
+
+    uint i = group * 256u + gl_LocalInvocationID.x;
+    if (i >= count) return;
+
+    uint keep = flags[i];
+    if (keep != 0u) outputs[offsets[i]] = inputs[i];
+    if (i == count - 1u) keptCount = offsets[i] + keep;
+}
@@ -0,0 +1,108 @@
+#version 430 core
+// Frustum + Hi-Z occlusion test for every sphere. Writes instanceCount 0/1
+// into the sphere's indirect draw command and counts the outcome.
+layout (local_size_x = 64) in;
+
+struct DrawCommand {
+    uint count;
+    uint instanceCount;
+    uint firstIndex;
+    int  baseVertex;
+    uint baseInstance;
+};
+
+layout (std430, binding = 0) readonly buffer Bounds { vec4 bounds[]; };   // xyz centre, w radius
+layout (std430, binding = 1) buffer Commands { DrawCommand commands[]; };
+layout (std430, binding = 2) buffer Stats {
+    uint drawn;
+    uint occluded;
+    uint frustumCulled;
+};
+
+uniform sampler2D hiz;          // RG32F pyramid (r = farthest depth)
+uniform mat4 viewProjection;
+uniform vec2 hizSize;           // Level 0 size in texels
+uniform int  hizLevels;
+uniform uint count;
+uniform bool occlusion;         // false = frustum test only
+
+#include "depth.glsl"
+
+void main() {
+    uint i = gl_GlobalInvocationID.x;
+    if (i >= count) return;
+
+    vec4 b = bounds[i];
+
+    // Screen-space bounds of the sphere's AABB (8 projected corners)
+    vec3 ndcMin = vec3( 1e30);
+    vec3 ndcMax = vec3(-1e30);
+    bool crossesNear = false;
+    for (int c = 0; c < 8; ++c) {
+        vec3 corner = b.xyz + b.w * vec3((c & 1) != 0 ? 1.0 : -1.0,
+                                         (c & 2) != 0 ? 1.0 : -1.0,
+                                         (c & 4) != 0 ? 1.0 : -1.0);
+        vec4 clip = viewProjection * vec4(corner, 1.0);
+        if (clip.w <= 1e-5) { crossesNear = true; break; }
+        vec3 ndc = clip.xyz / clip.w;
+        ndcMin = min(ndcMin, ndc);
+        ndcMax = max(ndcMax, ndc);
+    }
+
+    // Depth of the closest corner (NDC = window space under REVERSE_Z)
+#ifdef REVERSE_Z
+    float nearestNdc = ndcMax.z;
+    bool beyondFar = ndcMax.z < NDC_FAR;
+    bool pastNear = ndcMax.z < NDC_NEAR;
+#else
+    float nearestNdc = ndcMin.z;
+    bool beyondFar = ndcMin.z > NDC_FAR;
+    bool pastNear = ndcMin.z > NDC_NEAR;
+#endif
+
+    bool visible = true;
+    if (!crossesNear) {
+        // Frustum: rectangle fully off screen or beyond the far plane
+        if (ndcMax.x < -1.0 || ndcMin.x > 1.0 || ndcMax.y < -1.0 || ndcMin.y > 1.0 || beyondFar) {
+            visible = false;
+            atomicAdd(frustumCulled, 1u);
+        } else if (occlusion && pastNear) {
+            vec2 uvMin = clamp(ndcMin.xy * 0.5 + 0.5, 0.0, 1.0);
+            vec2 uvMax = clamp(ndcMax.xy * 0.5 + 0.5, 0.0, 1.0);
+
+            // Level where the rectangle spans at most one texel per axis
+            vec2 extent = (uvMax - uvMin) * hizSize;
+            float level = ceil(log2(max(max(extent.x, extent.y), 1.0)));
+            int lod = clamp(int(level), 0, hizLevels - 1);
+            ivec2 levelSize = max(ivec2(hizSize) >> lod, ivec2(1));
+
+            // Mip sizes round down, so the covering texel may sit one to the right
+            ivec2 t0 = ivec2(uvMin * vec2(levelSize));
+            ivec2 t1 = min(ivec2(uvMax * vec2(levelSize)) + 1, levelSize - 1);
+            t0 = min(t0, levelSize - 1);
+
+#ifdef REVERSE_Z
+            float farthest = 1.0;
+            for (int y = t0.y; y <= t1.y; ++y)
+                for (int x = t0.x; x <= t1.x; ++x)
+                    farthest = min(farthest, texelFetch(hiz, ivec2(x, y), lod).r);
+
+            bool behind = nearestNdc < farthest;
+#else
+            float farthest = 0.0;
+            for (int y = t0.y; y <= t1.y; ++y)
+                for (int x = t0.x; x <= t1.x; ++x)
+                    farthest = max(farthest, texelFetch(hiz, ivec2(x, y), lod).r);
+
+            bool behind = nearestNdc * 0.5 + 0.5 > farthest;   // window-space depth
+#endif
+            if (behind) {
+                visible = false;
+                atomicAdd(occluded, 1u);
+            }
+        }
+    }
+
+    if (visible) atomicAdd(drawn, 1u);
+    commands[i].instanceCount = visible ? 1u : 0u;
+}
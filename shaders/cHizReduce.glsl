@@ -0,0 +1,56 @@
+#version 430 core
+// Builds one level of the Hi-Z pyramid: r = farthest depth, g = nearest depth
+// (under REVERSE_Z the farthest depth is the smallest value).
+// Variants (injected by ShaderVariants):
+//   COPY_DEPTH - level 0: copy the occluder depth buffer into the pyramid
+//   (none)     - reduce level n-1 into level n (2x2, plus the extra row/column
+//                of odd-sized sources so no texel is dropped)
+layout (local_size_x = 8, local_size_y = 8) in;
+
+layout (rg32f, binding = 0) uniform writeonly image2D dstLevel;
+
+uniform sampler2D src;      // Occluder depth (COPY_DEPTH) or the pyramid itself
+uniform int  srcLevel;      // Pyramid level read by the reduce pass
+uniform vec2 srcSize;       // Size of the level being read
+uniform vec2 dstSize;       // Size of the level being written
+
+#ifndef COPY_DEPTH
+vec2 fetch(ivec2 p) {
+    return texelFetch(src, min(p, ivec2(srcSize) - 1), srcLevel).rg;
+}
+
+void fold(inout vec2 d, ivec2 p) {
+    vec2 s = fetch(p);
+#ifdef REVERSE_Z
+    d = vec2(min(d.r, s.r), max(d.g, s.g));
+#else
+    d = vec2(max(d.r, s.r), min(d.g, s.g));
+#endif
+}
+#endif
+
+void main() {
+    ivec2 p = ivec2(gl_GlobalInvocationID.xy);
+    ivec2 size = ivec2(dstSize);
+    if (p.x >= size.x || p.y >= size.y) return;
+
+#ifdef COPY_DEPTH
+    float depth = texelFetch(src, p, 0).r;
+    vec2 d = vec2(depth);
+#else
+    ivec2 s = p * 2;
+    vec2 d = fetch(s);
+    fold(d, s + ivec2(1, 0));
+    fold(d, s + ivec2(0, 1));
+    fold(d, s + ivec2(1, 1));
+
+    // Odd source sizes: the last column / row also covers the leftover texels
+    bool oddX = (int(srcSize.x) & 1) != 0 && p.x == size.x - 1;
+    bool oddY = (int(srcSize.y) & 1) != 0 && p.y == size.y - 1;
+    if (oddX) { fold(d, s + ivec2(2, 0)); fold(d, s + ivec2(2, 1)); }
+    if (oddY) { fold(d, s + ivec2(0, 2)); fold(d, s + ivec2(1, 2)); }
+    if (oddX && oddY) fold(d, s + ivec2(2, 2));
+#endif
+
+    imageStore(dstLevel, p, vec4(d, 0.0, 0.0));
+}
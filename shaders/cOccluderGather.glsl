@@ -0,0 +1,88 @@
+#version 430 core
+// Gathers occluder spheres per screen tile: one invocation per tile.
+// An occluder is kept when its AO reach sphere or its shadow cone (swept
+// away from the light up to the light's range) touches the tile frustum.
+layout (local_size_x = 64) in;
+
+#include "depth.glsl"
+
+layout (std430, binding = OCCLUDERS_BINDING) readonly buffer Occluders { vec4 occluders[]; };
+layout (std430, binding = OCCLUDER_COUNT_BINDING) buffer OccluderCount { uint tileOccluderCount[]; };
+layout (std430, binding = OCCLUDER_INDICES_BINDING) buffer OccluderIndices { uint tileOccluderIndex[]; };
+
+uniform mat4  view;
+uniform mat4  inverseProjection;
+uniform vec4  light;                // xyz world position, w range
+uniform float lightRadius;
+uniform float aoReach;
+uniform float zNear;
+uniform uint  occluderCount;
+
+const int SHADOW_STEPS = 8;         // Spheres bounding the swept shadow cone
+
+vec4 planes[4];                     // Tile side planes (inward normals, through the eye)
+
+vec3 cornerRay(vec2 ndc) {
+    vec4 p = inverseProjection * vec4(ndc, NDC_NEAR, 1.0);
+    return p.xyz / p.w;
+}
+
+// View-space sphere vs tile frustum (no far plane: the projection has none)
+bool touchesTile(vec3 c, float r) {
+    if (-c.z + r < zNear) return false;
+    for (int i = 0; i < 4; ++i) {
+        if (dot(planes[i].xyz, c) < -r) return false;
+    }
+    return true;
+}
+
+void main() {
+    uint tile = gl_GlobalInvocationID.x;
+    if (tile >= OCCLUDER_TILES_X * OCCLUDER_TILES_Y) return;
+
+    uvec2 cell = uvec2(tile % OCCLUDER_TILES_X, tile / OCCLUDER_TILES_X);
+    vec2 ndcMin = vec2(cell) / vec2(OCCLUDER_TILES_X, OCCLUDER_TILES_Y) * 2.0 - 1.0;
+    vec2 ndcMax = vec2(cell + 1u) / vec2(OCCLUDER_TILES_X, OCCLUDER_TILES_Y) * 2.0 - 1.0;
+
+    vec3 bl = cornerRay(ndcMin);
+    vec3 br = cornerRay(vec2(ndcMax.x, ndcMin.y));
+    vec3 tl = cornerRay(vec2(ndcMin.x, ndcMax.y));
+    vec3 tr = cornerRay(ndcMax);
+    vec3 centre = bl + br + tl + tr;
+
+    vec3 normals[4] = vec3[4](cross(bl, tl), cross(tr, br), cross(br, bl), cross(tl, tr));
+    for (int i = 0; i < 4; ++i) {
+        vec3 n = normalize(normals[i]);
+        planes[i] = vec4(dot(n, centre) < 0.0 ? -n : n, 0.0);
+    }
+
+    vec3 lightView = (view * vec4(light.xyz, 1.0)).xyz;
+
+    uint visible = 0u;
+    for (uint i = 0u; i < occluderCount && visible < MAX_OCCLUDERS_PER_TILE; ++i) {
+        vec4 o = occluders[i];
+        vec3 c = (view * vec4(o.xyz, 1.0)).xyz;
+
+        bool keep = touchesTile(c, o.w * aoReach);
+
+        // Shadow cone: widens by (r + lightRadius) per unit of distance past the occluder
+        float d = length(c - lightView);
+        if (!keep && d > o.w && d < light.w) {
+            vec3 axis = (c - lightView) / d;
+            float spread = (o.w + lightRadius) / d;
+            float stride = (light.w - d) / float(SHADOW_STEPS);
+            for (int k = 1; k <= SHADOW_STEPS && !keep; ++k) {
+                float s = d + stride * (float(k) - 0.5);
+                float radius = o.w + spread * (s + 0.5 * stride - d) + 0.5 * stride;
+                keep = touchesTile(lightView + axis * s, radius);
+            }
+        }
+
+        if (keep) {
+            tileOccluderIndex[tile * MAX_OCCLUDERS_PER_TILE + visible] = i;
+            ++visible;
+        }
+    }
+
+    tileOccluderCount[tile] = visible;
+}
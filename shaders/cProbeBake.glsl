@@ -0,0 +1,92 @@
+#version 430 core
+// Bakes irradiance probes: one invocation per probe of the dirty region.
+// Incoming light, projected onto L2 SH:
+//   - a uniform ambient sky,
+//   - each sphere in reach swaps the sky over its solid angle for its own
+//     radiance: every point light bounced off the side facing the probe.
+// Direct light is not stored; the lit shaders evaluate it per fragment.
+#define PROBE_BAKE
+layout (local_size_x = 4, local_size_y = 4, local_size_z = 4) in;
+
+layout (rgba16f, binding = 0) uniform writeonly image3D probes;
+
+#include "probes.glsl"
+
+struct PointLight {
+    vec4 positionRange;     // xyz position, w range
+    vec4 color;
+};
+
+struct ProbeSphere {
+    vec4 bounds;            // xyz centre, w radius
+    vec4 albedo;
+};
+
+layout (std430, binding = PROBE_LIGHTS_BINDING) readonly buffer Lights { PointLight lights[]; };
+layout (std430, binding = PROBE_SPHERES_BINDING) readonly buffer Spheres { ProbeSphere spheres[]; };
+
+uniform vec3  gridMin;
+uniform vec3  cellSize;
+uniform vec3  regionFirst;
+uniform vec3  regionSize;
+uniform uint  lightCount;
+uniform uint  sphereCount;
+uniform float ambient;          // Sky radiance
+uniform float bounceReach;      // Spheres farther than this many radii are ignored
+
+// Same window as phong.glsl
+float lightFalloff(float distance, float range) {
+    float x = clamp(1.0 - pow(distance / range, 4.0), 0.0, 1.0);
+    return x * x;
+}
+
+void main() {
+    ivec3 local = ivec3(gl_GlobalInvocationID);
+    if (any(greaterThanEqual(vec3(local), regionSize))) return;
+    ivec3 probe = ivec3(regionFirst) + local;
+    vec3 P = gridMin + vec3(probe) * cellSize;
+
+    vec3 sh[9];
+    for (int i = 0; i < 9; ++i) sh[i] = vec3(0.0);
+    sh[0] = vec3(ambient * 4.0 * PROBE_PI * 0.282095);
+
+    for (uint s = 0u; s < sphereCount; ++s) {
+        vec4 b = spheres[s].bounds;
+        vec3 toSphere = b.xyz - P;
+        float d = length(toSphere);
+        if (d <= b.w || d >= b.w * bounceReach) continue;   // probe inside / out of reach
+        vec3 dir = toSphere / d;
+        float ratio = b.w / d;
+        float solidAngle = 2.0 * PROBE_PI * (1.0 - sqrt(1.0 - ratio * ratio));
+        float fade = 1.0 - smoothstep(0.75, 1.0, d / (b.w * bounceReach));
+
+        // Lambertian radiance of the visible cap, like the lit shaders' diffuse
+        // term: cosine at the nearest point, widened to the cap's average
+        vec3 Q = b.xyz - dir * b.w;
+        vec3 radiance = vec3(0.0);
+        for (uint l = 0u; l < lightCount; ++l) {
+            vec3 toLight = lights[l].positionRange.xyz - Q;
+            float falloff = lightFalloff(length(toLight), lights[l].positionRange.w);
+            float facing = 0.5 + 0.5 * dot(-dir, normalize(toLight));
+            radiance += falloff * (2.0 / 3.0) * facing * facing * lights[l].color.rgb;
+        }
+        radiance *= spheres[s].albedo.rgb;
+
+        float Y[9];
+        shBasis(dir, Y);
+        vec3 weight = fade * solidAngle * (radiance - vec3(ambient));
+        for (int i = 0; i < 9; ++i) sh[i] += weight * Y[i];
+    }
+
+    // 27 floats, in order, into 7 blocks
+    float c[28];
+    for (int i = 0; i < 9; ++i) {
+        c[i * 3 + 0] = sh[i].r;
+        c[i * 3 + 1] = sh[i].g;
+        c[i * 3 + 2] = sh[i].b;
+    }
+    c[27] = 0.0;
+    for (int b = 0; b < 7; ++b)
+        imageStore(probes, ivec3(probe.xy, probe.z + b * PROBE_GRID_Z),
+                   vec4(c[b * 4], c[b * 4 + 1], c[b * 4 + 2], c[b * 4 + 3]));
+}
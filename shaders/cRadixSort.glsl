@@ -0,0 +1,128 @@
+#version 430 core
+// One 4-bit pass of a stable LSD radix sort of key/value pairs, 256 keys per
+// tile. Per-tile digit counts are stored digit-major so one exclusive scan
+// of the whole array yields every tile's output offset per digit.
+// Variants (injected by ShaderVariants):
+//   RADIX_COUNT - per-tile digit histogram: counts[digit * tileCount + tile]
+//   (none)      - scatter: the tile is sorted locally by four 1-bit splits,
+//                 then each key goes to its digit's scanned offset + rank
+//   KEY64       - uvec2 keys (x = low word, y = high word)
+layout (local_size_x = 256) in;
+
+#include "dispatch.glsl"
+
+#ifdef KEY64
+#define KEY uvec2
+#else
+#define KEY uint
+#endif
+
+layout (std430, binding = 0) readonly buffer KeysIn { KEY keysIn[]; };
+layout (std430, binding = 4) buffer Counts { uint counts[]; };
+
+uniform uint count;
+uniform uint shift;             // Bit offset of this pass's digit
+
+uint digitOf(KEY key) {
+#ifdef KEY64
+    return (shift < 32u ? key.x >> shift : key.y >> (shift - 32u)) & 15u;
+#else
+    return (key >> shift) & 15u;
+#endif
+}
+
+#ifdef RADIX_COUNT
+
+shared uint histogram[16];
+
+void main() {
+    uint tile = groupIndex();
+    if (tile >= groupCount) return;
+
+    uint t = gl_LocalInvocationID.x;
+    if (t < 16u) histogram[t] = 0u;
+    barrier();
+
+    uint i = tile * 256u + t;
+    if (i < count) atomicAdd(histogram[digitOf(keysIn[i])], 1u);
+    barrier();
+
+    if (t < 16u) counts[t * groupCount + tile] = histogram[t];
+}
+
+#else
+
+layout (std430, binding = 1) writeonly buffer KeysOut { KEY keysOut[]; };
+layout (std430, binding = 2) readonly buffer ValuesIn { uint valuesIn[]; };
+layout (std430, binding = 3) writeonly buffer ValuesOut { uint valuesOut[]; };
+
+shared KEY  sKeys[256];
+shared uint sValues[256];
+shared uint sScan[512];         // Double-buffered scan
+shared uint sDigits[256];
+shared uint digitStart[16];     // First local position of each digit
+shared uint digitOffset[16];    // Global output offset of each digit for this tile
+
+// Exclusive scan of one uint per invocation; also returns the tile total
+uint exclusiveScan(uint x, out uint total) {
+    uint t = gl_LocalInvocationID.x;
+    sScan[t] = x;
+    barrier();
+
+    uint src = 0u;
+    for (uint o = 1u; o < 256u; o <<= 1u) {
+        uint v = sScan[src * 256u + t];
+        if (t >= o) v += sScan[src * 256u + t - o];
+        sScan[(1u - src) * 256u + t] = v;
+        src = 1u - src;
+        barrier();
+    }
+
+    uint inclusive = sScan[src * 256u + t];
+    total = sScan[src * 256u + 255u];
+    barrier();
+    return inclusive - x;
+}
+
+void main() {
+    uint tile = groupIndex();
+    if (tile >= groupCount) return;
+
+    uint t = gl_LocalInvocationID.x;
+    uint i = tile * 256u + t;
+    bool valid = i < count;
+
+    // Padding sorts behind every real key of the tile (max digit, stable)
+    KEY  key   = valid ? keysIn[i] : KEY(0xFFFFFFFFu);
+    uint value = valid ? valuesIn[i] : 0u;
+    if (t < 16u) digitOffset[t] = counts[t * groupCount + tile];
+
+    // Stable local sort by the digit, one bit at a time
+    for (uint bit = 0u; bit < 4u; ++bit) {
+        uint one = (digitOf(key) >> bit) & 1u;
+        uint zeros;
+        uint zerosBefore = exclusiveScan(1u - one, zeros);
+        uint dest = one == 0u ? zerosBefore : zeros + t - zerosBefore;
+
+        sKeys[dest] = key;
+        sValues[dest] = value;
+        barrier();
+        key = sKeys[t];
+        value = sValues[t];
+        barrier();
+    }
+
+    uint digit = digitOf(key);
+    sDigits[t] = digit;
+    barrier();
+    if (t == 0u || sDigits[t - 1u] != digit) digitStart[digit] = t;
+    barrier();
+
+    if (t < min(256u, count - tile * 256u)) {
+        uint dest = digitOffset[digit] + t - digitStart[digit];
+        keysOut[dest] = key;
+        valuesOut[dest] = value;
+    }
+}
+
+#endif
@@ -0,0 +1,75 @@
+#version 430 core
+// Exclusive prefix sum of uints, 512 elements per workgroup (work-efficient
+// up-sweep / down-sweep in shared memory). Larger inputs scan the block
+// totals recursively and add them back.
+// Variants (injected by ShaderVariants):
+//   (none)   - scan each block in place, write its total to blockSums
+//   SCAN_ADD - add the scanned block totals to every element of each block
+layout (local_size_x = 256) in;
+
+#include "dispatch.glsl"
+
+layout (std430, binding = 0) buffer Data { uint data[]; };
+layout (std430, binding = 1) buffer BlockSums { uint blockSums[]; };
+
+uniform uint count;
+
+#ifdef SCAN_ADD
+
+void main() {
+    uint group = groupIndex();
+    if (group >= groupCount) return;
+
+    uint i = group * 512u + gl_LocalInvocationID.x;
+    uint add = blockSums[group];
+    if (i < count) data[i] += add;
+    if (i + 256u < count) data[i + 256u] += add;
+}
+
+#else
+
+shared uint temp[512];
+
+void main() {
+    uint group = groupIndex();
+    if (group >= groupCount) return;
+
+    uint t = gl_LocalInvocationID.x;
+    uint base = group * 512u;
+    uint a = 2u * t, b = 2u * t + 1u;
+    temp[a] = base + a < count ? data[base + a] : 0u;
+    temp[b] = base + b < count ? data[base + b] : 0u;
+
+    // Up-sweep: partial sums at the right of each subtree
+    uint offset = 1u;
+    for (uint d = 256u; d > 0u; d >>= 1u) {
+        barrier();
+        if (t < d) temp[offset * (b + 1u) - 1u] += temp[offset * (a + 1u) - 1u];
+        offset <<= 1u;
+    }
+
+    barrier();
+    if (t == 0u) {
+        blockSums[group] = temp[511];
+        temp[511] = 0u;
+    }
+
+    // Down-sweep: push prefixes back to the leaves
+    for (uint d = 1u; d < 512u; d <<= 1u) {
+        offset >>= 1u;
+        barrier();
+        if (t < d) {
+            uint left  = offset * (a + 1u) - 1u;
+            uint right = offset * (b + 1u) - 1u;
+            uint v = temp[left];
+            temp[left] = temp[right];
+            temp[right] += v;
+        }
+    }
+    barrier();
+
+    if (base + a < count) data[base + a] = temp[a];
+    if (base + b < count) data[base + b] = temp[b];
+}
+
+#endif
@@ -0,0 +1,35 @@
+#version 430 core
+// Fused composite: HDR scene + bloom, exposure, ACES tonemap and gamma in
+// one pass, written to the LDR image that is blitted to the window.
+layout (local_size_x = 8, local_size_y = 8) in;
+
+layout (rgba8, binding = 0) uniform writeonly image2D target;
+
+#include "postprocess.glsl"
+
+uniform sampler2D scene;
+uniform float sceneLod;
+uniform vec2  sceneTexel;
+uniform vec2  sceneSize;
+uniform sampler2D bloom;        // Top of the upsample chain (half resolution)
+uniform float bloomLod;
+uniform vec2  bloomTexel;
+uniform vec2  bloomSize;
+uniform vec2  targetSize;
+uniform float exposure;
+uniform float bloomIntensity;
+
+// ACES filmic curve (Narkowicz fit)
+vec3 aces(vec3 x) {
+    return clamp((x * (2.51 * x + 0.03)) / (x * (2.43 * x + 0.59) + 0.14), 0.0, 1.0);
+}
+
+void main() {
+    ivec2 p = ivec2(gl_GlobalInvocationID.xy);
+    if (any(greaterThanEqual(vec2(p), targetSize))) return;
+
+    vec3 hdr = texelFetch(scene, p, 0).rgb;
+    vec3 glow = sampleArea(bloom, sourceUv(p, targetSize, bloomSize, bloomTexel), bloomLod, bloomSize, bloomTexel);
+    vec3 color = aces((hdr + bloomIntensity * glow) * exposure);
+    imageStore(target, p, vec4(pow(color, vec3(1.0 / 2.2)), 1.0));
+}
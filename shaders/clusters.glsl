@@ -0,0 +1,30 @@
+// Cluster grid shared by the light cull pass and clustered shading.
+// Layout constants are injected by ClusteredLights::defines().
+
+struct PointLight {
+    vec4 positionRange;     // xyz world position, w range
+    vec4 color;
+};
+
+layout (std430, binding = LIGHTS_BINDING) buffer Lights { PointLight lights[]; };
+layout (std430, binding = GRID_BINDING) buffer LightGrid { uint clusterLightCount[]; };
+layout (std430, binding = INDICES_BINDING) buffer LightIndices { uint clusterLightIndex[]; };
+
+uniform float zNear;
+uniform float zFar;
+
+// Exponential depth slice for a positive view-space distance (zFar and
+// beyond fall in the last slice, which the light cull leaves unbounded)
+uint clusterSlice(float viewDepth) {
+    float slice = log(max(viewDepth, zNear) / zNear) * float(CLUSTER_GRID_Z) / log(zFar / zNear);
+    return uint(clamp(slice, 0.0, float(CLUSTER_GRID_Z - 1)));
+}
+
+// View-space depth where a slice starts
+float sliceStart(uint slice) {
+    return zNear * pow(zFar / zNear, float(slice) / float(CLUSTER_GRID_Z));
+}
+
+uint clusterIndex(uvec3 cell) {
+    return cell.x + CLUSTER_GRID_X * (cell.y + CLUSTER_GRID_Y * cell.z);
+}
@@ -0,0 +1,30 @@
+// Depth convention shared by every pass that reads depth or unprojects.
+// REVERSE_Z is injected by Shader when the GL context uses reversed depth:
+// [0, 1] clip range, near plane at 1, the (infinite) far plane at 0.
+
+#ifdef REVERSE_Z
+const float NDC_NEAR = 1.0;         // NDC z of the near plane
+const float NDC_FAR  = 0.0;         // NDC z of the far plane
+#else
+const float NDC_NEAR = -1.0;
+const float NDC_FAR  = 1.0;
+#endif
+
+// NDC z of a window-space depth value
+float depthToNdc(float depth) {
+#ifdef REVERSE_Z
+    return depth;
+#else
+    return depth * 2.0 - 1.0;
+#endif
+}
+
+// Window-space depth in the standard convention (0 near .. 1 far). With the
+// infinite camera projection reversed depth is exactly 1 - standard depth
+float standardDepth(float depth) {
+#ifdef REVERSE_Z
+    return 1.0 - depth;
+#else
+    return depth;
+#endif
+}
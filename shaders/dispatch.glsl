@@ -0,0 +1,7 @@
+// Flattened workgroup index for dispatches split over x/y (GL only
+// guarantees 65535 groups per dimension); groups past groupCount exit
+uniform uint groupCount;
+
+uint groupIndex() {
+    return gl_WorkGroupID.y * gl_NumWorkGroups.x + gl_WorkGroupID.x;
+}
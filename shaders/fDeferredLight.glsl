@@ -0,0 +1,51 @@
+#version 430 core
+// Variants (injected by ShaderVariants):
+//   AMBIENT - full-screen ambient term from the albedo target
+//   (none)  - one point light, drawn over its light volume
+out vec4 FragColor;
+
+#include "phong.glsl"
+#include "depth.glsl"
+
+uniform sampler2D gAlbedo;
+
+#ifdef AMBIENT
+
+void main() {
+    vec3 albedo = texelFetch(gAlbedo, ivec2(gl_FragCoord.xy), 0).rgb;
+    FragColor = vec4(ambientStrength * albedo, 1.0);
+}
+
+#else
+
+#include "octahedral.glsl"
+
+uniform sampler2D gNormal;
+uniform sampler2D gDepth;
+
+uniform mat4 inverseViewProjection;
+uniform vec2 screenSize;
+uniform vec3 viewPos;
+uniform vec4 lightPositionRange;
+uniform vec3 lightColor;
+
+void main() {
+    ivec2 texel = ivec2(gl_FragCoord.xy);
+    vec4 albedo = texelFetch(gAlbedo, texel, 0);
+    if (albedo.a == 0.0) discard;               // Background
+
+    // World position from depth
+    float depth = texelFetch(gDepth, texel, 0).r;
+    vec4 ndc = vec4(gl_FragCoord.xy / screenSize * 2.0 - 1.0, depthToNdc(depth), 1.0);
+    vec4 world = inverseViewProjection * ndc;
+    vec3 worldPos = world.xyz / world.w;
+
+    vec3 N = octDecode(texelFetch(gNormal, texel, 0).xy);
+    float distance = length(lightPositionRange.xyz - worldPos);
+    float falloff = lightFalloff(distance, lightPositionRange.w);
+    if (falloff == 0.0) discard;
+
+    FragColor = vec4(falloff * phongLight(N, worldPos, viewPos, lightPositionRange.xyz, lightColor, albedo.rgb), 0.0);
+}
+
+#endif
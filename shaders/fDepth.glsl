@@ -0,0 +1,4 @@
+#version 430 core
+// Depth prepass: no colour output, depth comes from the fixed-function pipeline
+void main() {
+}
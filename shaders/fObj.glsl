@@ -1,38 +1,175 @@
 #version 430 core
+// Variants (injected by ShaderVariants):
+//   EMISSIVE  - light marker, flat inColor * emissiveIntensity output
+//   CLUSTERED - Phong lit by every light in the fragment's cluster
+//   GBUFFER   - deferred geometry pass: albedo + octahedral normal, no lighting
+//   ATMOSPHERE - planet surface lit by the sun through its precomputed atmosphere
+//   VIRTUAL_TEXTURE - (with ATMOSPHERE) albedo from the streamed cube-face imagery
+//               (inColor until a tile is resident)
+//   (none)    - Phong lit by the single lightPos / lightColor light
+//   SHADOWS   - (with the lit variants) cube shadow map for the shadowed point light
+//   SPHERE_OCCLUSION - (with the lit variants) analytic sphere soft shadow for the
+//               shadowed light + sphere AO on the ambient term
+//   PROBES    - (with the lit variants) ambient from the SH irradiance probe grid
+//   MULTIVIEW - drawn through gMultiView.glsl: the eye comes from the fragment's view
 in vec3 vWorldPos;
 in vec3 vNormal;
-out vec4 FragColor;
 
-uniform bool source;
 uniform vec3 inColor;
-uniform vec3 lightPos;
-uniform vec3 lightColor;
+
+#ifdef GBUFFER
+
+#include "octahedral.glsl"
+
+layout (location = 0) out vec4 gAlbedo;     // rgb albedo, a = 1 marks geometry
+layout (location = 1) out vec2 gNormal;
+
+void main() {
+    gAlbedo = vec4(inColor, 1.0);
+    gNormal = octEncode(normalize(vNormal));
+}
+
+#else
+
+out vec4 FragColor;
+
+#ifdef EMISSIVE
+
+uniform float emissiveIntensity = 1.0;     // > 1 into the HDR target (bloom)
+
+void main() {
+    FragColor = vec4(inColor * emissiveIntensity, 1.0);
+}
+
+#elif defined(ATMOSPHERE)
+
+#include "atmosphere.glsl"
+
+#ifdef VIRTUAL_TEXTURE
+in vec3 vObjectPos;
+#include "virtualtexture.glsl"
+#endif
+
+// Lambertian ground under the attenuated sun and the sky, then the camera's
+// aerial perspective: transmittance to the camera plus the sky-view
+// in-scattering, which below the horizon ends on the ground
+void main() {
+    vec3 N = normalize(vNormal);
+    vec3 ground = (vWorldPos - planetCenter) / planetRadius;
+    float r = max(length(ground), 1.0);
+    float muS = dot(normalize(ground), sunDirection);
+
+    vec3 albedo = inColor;
+#ifdef VIRTUAL_TEXTURE
+    vec4 texel = virtualTexture(vObjectPos);
+    if (texel.a > 0.0) albedo = texel.rgb;
+#endif
+
+    vec3 irradiance = transmittanceToTop(r, muS) * max(dot(N, sunDirection), 0.0) + skyIrradiance(r, muS);
+    vec3 surface = albedo / ATMOSPHERE_PI * sunIlluminance * irradiance;
+
+    vec3 dir = normalize(ground - atmosphereCamera);
+    FragColor = vec4(surface * viewTransmittance(ground) + skyView(dir), 1.0);
+}
+
+#else
+
+#include "phong.glsl"
+
+#ifdef MULTIVIEW
+flat in vec3 vEye;
+#define viewPos vEye
+#else
 uniform vec3 viewPos;
+#endif
+
+#ifdef PROBES
+#include "probes.glsl"
+#else
+// Flat ambient term
+vec3 ambientLight(vec3 P, vec3 N, vec3 albedo) {
+    return ambientStrength * albedo;
+}
+#endif
+
+#ifdef SHADOWS
+#include "shadow.glsl"
+#endif
+
+#ifdef SPHERE_OCCLUSION
+#include "sphereocclusion.glsl"
+uniform float occlusionLightRadius;     // Radius of the shadowed light's sphere
+#endif
 
-uniform float ambientStrength = 0.12;
-uniform float diffuseStrength = 1.0;
-uniform float specularStrength = 0.6;
-uniform float shininess = 32.0;
+#ifdef CLUSTERED
+
+#include "clusters.glsl"
+
+uniform mat4 view;
+uniform vec2 screenSize;
+uniform int  shadowLight = -1;  // Index of the light that owns the shadow map
 
 void main() {
+    vec3 N = normalize(vNormal);
+
+    // Cluster containing this fragment
+    float viewDepth = -(view * vec4(vWorldPos, 1.0)).z;
+    uvec2 tile = uvec2(gl_FragCoord.xy / screenSize * vec2(CLUSTER_GRID_X, CLUSTER_GRID_Y));
+    tile = min(tile, uvec2(CLUSTER_GRID_X - 1u, CLUSTER_GRID_Y - 1u));
+    uint cluster = clusterIndex(uvec3(tile, clusterSlice(viewDepth)));
+
+    float ao = 1.0;
+    float occlusionShadow = 1.0;
+#ifdef SPHERE_OCCLUSION
+    if (shadowLight >= 0)
+        sphereOcclusion(vWorldPos, N, lights[shadowLight].positionRange.xyz, occlusionLightRadius, ao, occlusionShadow);
+    else
+        sphereOcclusion(vWorldPos, N, vWorldPos + N, 0.0, ao, occlusionShadow);
+#endif
 
-    if (source) {
-        FragColor = vec4(lightColor, 1.0);
-        return;
+    vec3 color = ao * ambientLight(vWorldPos, N, inColor);
+    uint count = clusterLightCount[cluster];
+    for (uint i = 0u; i < count; ++i) {
+        uint index = clusterLightIndex[cluster * MAX_LIGHTS_PER_CLUSTER + i];
+        PointLight light = lights[index];
+        float distance = length(light.positionRange.xyz - vWorldPos);
+        float falloff = lightFalloff(distance, light.positionRange.w);
+#ifdef SHADOWS
+        if (int(index) == shadowLight) falloff *= pointShadow(vWorldPos, N);
+#endif
+#ifdef SPHERE_OCCLUSION
+        if (int(index) == shadowLight) falloff *= occlusionShadow;
+#endif
+        color += falloff * phongLight(N, vWorldPos, viewPos, light.positionRange.xyz, light.color.rgb, inColor);
     }
 
-    vec3 N = normalize(vNormal);
-    vec3 L = normalize(lightPos - vWorldPos);
-    vec3 V = normalize(viewPos - vWorldPos);
+    FragColor = vec4(color, 1.0);
+}
 
-    float diff = max(dot(N, L), 0.0);
+#else
 
-    vec3 R = reflect(-L, N);
-    float spec = pow(max(dot(R, V), 0.0), shininess);
+uniform vec3 lightPos;
+uniform vec3 lightColor;
 
-    vec3 ambient = ambientStrength * inColor;
-    vec3 diffuse = diffuseStrength * diff * inColor * lightColor;
-    vec3 specular = specularStrength * spec * lightColor;
+void main() {
+    vec3 N = normalize(vNormal);
+#if defined(SHADOWS)
+    vec3 color = ambientLight(vWorldPos, N, inColor) +
+                 pointShadow(vWorldPos, N) * phongLight(N, vWorldPos, viewPos, lightPos, lightColor, inColor);
+    FragColor = vec4(color, 1.0);
+#elif defined(SPHERE_OCCLUSION)
+    float ao, visibility;
+    sphereOcclusion(vWorldPos, N, lightPos, occlusionLightRadius, ao, visibility);
+    vec3 color = ao * ambientLight(vWorldPos, N, inColor) +
+                 visibility * phongLight(N, vWorldPos, viewPos, lightPos, lightColor, inColor);
+    FragColor = vec4(color, 1.0);
+#else
+    vec3 color = ambientLight(vWorldPos, N, inColor) +
+                 phongLight(N, vWorldPos, viewPos, lightPos, lightColor, inColor);
+    FragColor = vec4(color, 1.0);
+#endif
+}
 
-    FragColor = vec4(ambient + diffuse + specular, 1.0);
-}
\ No newline at end of file
+#endif
+#endif
+#endif
@@ -0,0 +1,20 @@
+#version 430 core
+// Resolves weighted blended OIT over the opaque scene: weighted average
+// colour, covering 1 - revealage (blended with SRC_ALPHA, ONE_MINUS_SRC_ALPHA)
+uniform sampler2D accumTexture;
+uniform sampler2D revealageTexture;
+
+out vec4 FragColor;
+
+void main() {
+    ivec2 texel = ivec2(gl_FragCoord.xy);
+    float revealage = texelFetch(revealageTexture, texel, 0).r;
+    if (revealage >= 1.0) discard;          // No translucent surface here
+
+    vec4 accum = texelFetch(accumTexture, texel, 0);
+    // Overflowed half floats: fall back to the alpha sum
+    if (any(isinf(accum.rgb))) accum.rgb = vec3(accum.a);
+
+    vec3 average = accum.rgb / max(accum.a, 1e-5);
+    FragColor = vec4(average, 1.0 - revealage);
+}
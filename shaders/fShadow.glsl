@@ -0,0 +1,11 @@
+#version 430 core
+// Linear light distance as depth (matches the lookup in shadow.glsl)
+
+in vec3 gWorldPos;
+
+uniform vec3 lightPos;
+uniform float range;
+
+void main() {
+    gl_FragDepth = length(gWorldPos - lightPos) / range;
+}
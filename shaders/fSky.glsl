@@ -0,0 +1,19 @@
+#version 430 core
+// Atmosphere against the empty background: in-scattered light from the
+// sky-view LUT, one fetch per pixel. Drawn at the far plane (GL_LEQUAL, no
+// depth writes) so covered pixels are skipped, and added to the scene.
+#include "atmosphere.glsl"
+#include "depth.glsl"
+
+uniform mat4 inverseViewProjection;
+uniform vec2 screenSize;
+uniform vec3 viewPos;
+
+out vec4 FragColor;
+
+void main() {
+    vec2 ndc = gl_FragCoord.xy / screenSize * 2.0 - 1.0;
+    vec4 near = inverseViewProjection * vec4(ndc, NDC_NEAR, 1.0);   // The far plane is at infinity
+    vec3 dir = normalize(near.xyz / near.w - viewPos);
+    FragColor = vec4(skyView(dir), 1.0);
+}
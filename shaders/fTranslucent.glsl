@@ -0,0 +1,62 @@
+#version 430 core
+// Translucent sphere surface for weighted blended OIT (McGuire & Bavoil 2013).
+// Writes premultiplied colour scaled by a depth/alpha weight into the
+// accumulation target and alpha into the revealage target; blending makes
+// the result independent of draw order. Both faces are drawn, back faces lit
+// with the flipped normal.
+// Variants (injected by ShaderVariants):
+//   CLUSTERED - lit by every light in the fragment's cluster
+//   (none)    - lit by the single lightPos / lightColor light
+in vec3 vWorldPos;
+in vec3 vNormal;
+
+layout (location = 0) out vec4 accum;       // sum of w * (rgb * a, a)
+layout (location = 1) out float revealage;  // product of (1 - a), via blending
+
+uniform vec3  inColor;
+uniform float opacity;
+uniform vec3  viewPos;
+
+#include "phong.glsl"
+#include "depth.glsl"
+
+#ifdef CLUSTERED
+#include "clusters.glsl"
+uniform mat4 view;
+uniform vec2 screenSize;
+#else
+uniform vec3 lightPos;
+uniform vec3 lightColor;
+#endif
+
+// Weight favouring near, opaque surfaces (paper eq. 10, window-space depth)
+float oitWeight(float z, float a) {
+    float w = pow(min(1.0, a * 10.0) + 0.01, 3.0) * 1e8 * pow(1.0 - z * 0.9, 3.0);
+    return clamp(w, 1e-2, 3e3);
+}
+
+void main() {
+    vec3 N = normalize(vNormal);
+    if (!gl_FrontFacing) N = -N;
+
+#ifdef CLUSTERED
+    float viewDepth = -(view * vec4(vWorldPos, 1.0)).z;
+    uvec2 tile = uvec2(gl_FragCoord.xy / screenSize * vec2(CLUSTER_GRID_X, CLUSTER_GRID_Y));
+    tile = min(tile, uvec2(CLUSTER_GRID_X - 1u, CLUSTER_GRID_Y - 1u));
+    uint cluster = clusterIndex(uvec3(tile, clusterSlice(viewDepth)));
+
+    vec3 color = ambientStrength * inColor;
+    uint count = clusterLightCount[cluster];
+    for (uint i = 0u; i < count; ++i) {
+        PointLight light = lights[clusterLightIndex[cluster * MAX_LIGHTS_PER_CLUSTER + i]];
+        float falloff = lightFalloff(length(light.positionRange.xyz - vWorldPos), light.positionRange.w);
+        color += falloff * phongLight(N, vWorldPos, viewPos, light.positionRange.xyz, light.color.rgb, inColor);
+    }
+#else
+    vec3 color = phong(N, vWorldPos, viewPos, lightPos, lightColor, inColor);
+#endif
+
+    float w = oitWeight(standardDepth(gl_FragCoord.z), opacity);
+    accum = vec4(color * opacity, opacity) * w;
+    revealage = opacity;
+}
@@ -0,0 +1,15 @@
+#version 430 core
+// Virtual texture feedback: the tile each pixel wants (x, y, level, face + 1;
+// 0 = no textured surface), read back by VirtualTexture::update()
+in vec3 vObjectPos;
+
+#include "virtualtexture.glsl"
+
+layout (location = 0) out uvec4 feedback;
+
+void main() {
+    vec2 uv;
+    int face = cubeFaceUv(vObjectPos, uv);
+    int level = vtLevel(vObjectPos);
+    feedback = uvec4(uvec2(vtTile(uv, level)), uint(level), uint(face + 1));
+}
@@ -0,0 +1,10 @@
+#version 430 core
+// Visibility raster: (draw ID, triangle ID) per pixel, no shading
+
+uniform uint drawID;
+
+layout (location = 0) out uvec2 visibility;
+
+void main() {
+    visibility = uvec2(drawID, uint(gl_PrimitiveID));
+}
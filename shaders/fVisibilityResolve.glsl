@@ -0,0 +1,106 @@
+#version 430 core
+// Visibility-buffer resolve: one shaded sample per covered pixel.
+// Variants (injected by ShaderVariants):
+//   CLUSTERED - Phong lit by every light in the pixel's cluster
+//   (none)    - Phong lit by the single lightPos / lightColor light
+out vec4 FragColor;
+
+#include "phong.glsl"
+#include "depth.glsl"
+
+struct Instance {
+    mat4 model;
+    vec4 color;             // rgb albedo, a = 1 emissive
+    uint firstIndex;
+    int  baseVertex;
+    uint pad0, pad1;
+};
+
+layout (std430, binding = 0) readonly buffer Positions { float positions[]; };
+layout (std430, binding = 1) readonly buffer Indices { uint indices[]; };
+layout (std430, binding = 2) readonly buffer Instances { Instance instances[]; };
+
+uniform usampler2D visibility;      // (draw ID, triangle ID), 0xFFFFFFFF = empty
+uniform vec2 screenSize;
+uniform mat4 inverseViewProjection;
+uniform vec3 viewPos;
+
+vec3 fetchPosition(Instance inst, uint corner) {
+    uint v = uint(int(indices[inst.firstIndex + corner]) + inst.baseVertex) * 3u;
+    return vec3(positions[v], positions[v + 1u], positions[v + 2u]);
+}
+
+#ifdef CLUSTERED
+#include "clusters.glsl"
+
+uniform mat4 view;
+
+vec3 shade(vec3 N, vec3 worldPos, vec3 albedo) {
+    float viewDepth = -(view * vec4(worldPos, 1.0)).z;
+    uvec2 tile = uvec2(gl_FragCoord.xy / screenSize * vec2(CLUSTER_GRID_X, CLUSTER_GRID_Y));
+    tile = min(tile, uvec2(CLUSTER_GRID_X - 1u, CLUSTER_GRID_Y - 1u));
+    uint cluster = clusterIndex(uvec3(tile, clusterSlice(viewDepth)));
+
+    vec3 color = ambientStrength * albedo;
+    uint count = clusterLightCount[cluster];
+    for (uint i = 0u; i < count; ++i) {
+        PointLight light = lights[clusterLightIndex[cluster * MAX_LIGHTS_PER_CLUSTER + i]];
+        float distance = length(light.positionRange.xyz - worldPos);
+        float falloff = lightFalloff(distance, light.positionRange.w);
+        color += falloff * phongLight(N, worldPos, viewPos, light.positionRange.xyz, light.color.rgb, albedo);
+    }
+    return color;
+}
+
+#else
+
+uniform vec3 lightPos;
+uniform vec3 lightColor;
+
+vec3 shade(vec3 N, vec3 worldPos, vec3 albedo) {
+    return phong(N, worldPos, viewPos, lightPos, lightColor, albedo);
+}
+
+#endif
+
+void main() {
+    uvec2 id = texelFetch(visibility, ivec2(gl_FragCoord.xy), 0).xy;
+    if (id.x == 0xFFFFFFFFu) discard;
+
+    Instance inst = instances[id.x];
+    if (inst.color.a > 0.5) {
+        FragColor = vec4(inst.color.rgb, 1.0);
+        return;
+    }
+
+    // Triangle corners (object + world space)
+    vec3 p0 = fetchPosition(inst, id.y * 3u);
+    vec3 p1 = fetchPosition(inst, id.y * 3u + 1u);
+    vec3 p2 = fetchPosition(inst, id.y * 3u + 2u);
+    vec3 w0 = (inst.model * vec4(p0, 1.0)).xyz;
+    vec3 w1 = (inst.model * vec4(p1, 1.0)).xyz;
+    vec3 w2 = (inst.model * vec4(p2, 1.0)).xyz;
+
+    // Perspective-correct barycentrics: intersect the pixel's view ray with the triangle
+    vec2 ndc = gl_FragCoord.xy / screenSize * 2.0 - 1.0;
+    vec4 nearPoint = inverseViewProjection * vec4(ndc, NDC_NEAR, 1.0);  // The far plane is at infinity
+    vec3 dir = normalize(nearPoint.xyz / nearPoint.w - viewPos);
+
+    vec3 e1 = w1 - w0;
+    vec3 e2 = w2 - w0;
+    vec3 pvec = cross(dir, e2);
+    float invDet = 1.0 / dot(e1, pvec);
+    vec3 tvec = viewPos - w0;
+    float u = dot(tvec, pvec) * invDet;
+    float v = dot(dir, cross(tvec, e1)) * invDet;
+    vec3 bary = vec3(1.0 - u - v, u, v);
+
+    // Same attributes vObj.glsl would have interpolated
+    vec3 worldPos = bary.x * w0 + bary.y * w1 + bary.z * w2;
+    mat3 normalMatrix = mat3(inst.model);
+    vec3 N = normalize(bary.x * normalize(normalMatrix * p0) +
+                       bary.y * normalize(normalMatrix * p1) +
+                       bary.z * normalize(normalMatrix * p2));
+
+    FragColor = vec4(shade(N, worldPos, inst.color.rgb), 1.0);
+}
@@ -0,0 +1,37 @@
+#version 430 core
+// Sends each view's copy of a triangle to that view: gl_ViewportIndex selects
+// the side-by-side / split viewport, gl_Layer the cube face (ignored on
+// non-layered targets). Triangles outside the view's frustum stop here.
+
+#include "multiview.glsl"
+
+layout (triangles) in;
+layout (triangle_strip, max_vertices = 3) out;
+
+in vec3 mvWorldPos[];
+in vec3 mvNormal[];
+flat in int mvView[];
+
+out vec3 vWorldPos;
+out vec3 vNormal;
+flat out vec3 vEye;     // Replaces the viewPos uniform in fObj.glsl
+
+void main() {
+    for (int axis = 0; axis < 3; ++axis) {
+        vec3 c = vec3(gl_in[0].gl_Position[axis], gl_in[1].gl_Position[axis], gl_in[2].gl_Position[axis]);
+        vec3 w = vec3(gl_in[0].gl_Position.w, gl_in[1].gl_Position.w, gl_in[2].gl_Position.w);
+        if (all(lessThan(c, -w)) || all(greaterThan(c, w))) return;
+    }
+
+    int view = mvView[0];
+    for (int i = 0; i < 3; ++i) {
+        gl_ViewportIndex = view;
+        gl_Layer = view;
+        vWorldPos = mvWorldPos[i];
+        vNormal = mvNormal[i];
+        vEye = views[view].eye.xyz;
+        gl_Position = gl_in[i].gl_Position;
+        EmitVertex();
+    }
+    EndPrimitive();
+}
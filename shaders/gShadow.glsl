@@ -0,0 +1,31 @@
+#version 430 core
+// One invocation per cube face: each triangle is emitted to every face layer
+
+layout (triangles, invocations = 6) in;
+layout (triangle_strip, max_vertices = 3) out;
+
+uniform mat4 faceMatrices[6];   // Light view-projection per face (GL face order)
+
+out vec3 gWorldPos;
+
+void main() {
+    mat4 faceMatrix = faceMatrices[gl_InvocationID];
+
+    // Skip triangles entirely outside this face's frustum
+    vec4 clip[3];
+    for (int i = 0; i < 3; ++i) clip[i] = faceMatrix * gl_in[i].gl_Position;
+    for (int axis = 0; axis < 3; ++axis) {
+        if (all(lessThan(vec3(clip[0][axis], clip[1][axis], clip[2][axis]),
+                         -vec3(clip[0].w, clip[1].w, clip[2].w)))) return;
+        if (all(greaterThan(vec3(clip[0][axis], clip[1][axis], clip[2][axis]),
+                            vec3(clip[0].w, clip[1].w, clip[2].w)))) return;
+    }
+
+    for (int i = 0; i < 3; ++i) {
+        gl_Layer = gl_InvocationID;
+        gWorldPos = gl_in[i].gl_Position.xyz;
+        gl_Position = clip[i];
+        EmitVertex();
+    }
+    EndPrimitive();
+}
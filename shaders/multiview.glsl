@@ -0,0 +1,10 @@
+// View block of the multi-view pass (MultiView): one view-projection + eye
+// per view; instance i of a draw is view i.
+struct View {
+    mat4 viewProjection;
+    vec4 eye;               // xyz eye position
+};
+
+layout (std140, binding = MULTIVIEW_BINDING) uniform Views {
+    View views[MULTIVIEW_MAX_VIEWS];
+};
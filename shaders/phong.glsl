@@ -0,0 +1,32 @@
+// Phong lighting shared by lit fragment variants
+uniform float ambientStrength = 0.12;
+uniform float diffuseStrength = 1.0;
+uniform float specularStrength = 0.6;
+uniform float shininess = 32.0;
+
+// Diffuse + specular contribution of one point light
+vec3 phongLight(vec3 N, vec3 worldPos, vec3 viewPos, vec3 lightPos, vec3 lightColor, vec3 albedo) {
+    vec3 L = normalize(lightPos - worldPos);
+    vec3 V = normalize(viewPos - worldPos);
+
+    float diff = max(dot(N, L), 0.0);
+
+    vec3 R = reflect(-L, N);
+    float spec = pow(max(dot(R, V), 0.0), shininess);
+
+    vec3 diffuse = diffuseStrength * diff * albedo * lightColor;
+    vec3 specular = specularStrength * spec * lightColor;
+
+    return diffuse + specular;
+}
+
+// Ambient + one light
+vec3 phong(vec3 N, vec3 worldPos, vec3 viewPos, vec3 lightPos, vec3 lightColor, vec3 albedo) {
+    return ambientStrength * albedo + phongLight(N, worldPos, viewPos, lightPos, lightColor, albedo);
+}
+
+// Smooth window so a light fades to exactly zero at its range
+float lightFalloff(float distance, float range) {
+    float x = clamp(1.0 - pow(distance / range, 4.0), 0.0, 1.0);
+    return x * x;
+}
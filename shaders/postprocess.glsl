@@ -0,0 +1,14 @@
+// Shared by the post-processing passes (PostProcess): each source is one mip
+// of a texture of which only the lower-left `Size` texels hold this frame's
+// image; lookups are clamped to that area.
+
+// Texture coordinate of the source point under target texel `p`
+vec2 sourceUv(ivec2 p, vec2 targetSize, vec2 size, vec2 texel) {
+    return (vec2(p) + 0.5) / targetSize * size * texel;
+}
+
+// Bilinear fetch kept inside the used area
+vec3 sampleArea(sampler2D tex, vec2 uv, float lod, vec2 size, vec2 texel) {
+    uv = clamp(uv, 0.5 * texel, (size - 0.5) * texel);
+    return textureLod(tex, uv, lod).rgb;
+}
@@ -0,0 +1,64 @@
+// Irradiance probe grid (IrradianceProbes): L2 spherical harmonics, 9 RGB
+// coefficients packed in order into 7 vec4 blocks stacked along z of one 3D
+// texture. Layout constants are injected by IrradianceProbes::defines().
+const float PROBE_PI = 3.14159265;
+
+uniform sampler3D probeGrid;
+uniform vec3 probeGridMin;
+uniform vec3 probeCellSize;
+
+// Real SH basis up to l = 2 for a unit direction
+void shBasis(vec3 d, out float Y[9]) {
+    Y[0] = 0.282095;
+    Y[1] = 0.488603 * d.y;
+    Y[2] = 0.488603 * d.z;
+    Y[3] = 0.488603 * d.x;
+    Y[4] = 1.092548 * d.x * d.y;
+    Y[5] = 1.092548 * d.y * d.z;
+    Y[6] = 0.315392 * (3.0 * d.z * d.z - 1.0);
+    Y[7] = 1.092548 * d.x * d.z;
+    Y[8] = 0.546274 * (d.x * d.x - d.y * d.y);
+}
+
+// Irradiance around normal N from radiance coefficients (clamped cosine
+// convolution: pi, 2pi/3, pi/4 per band)
+vec3 shIrradiance(vec3 sh[9], vec3 N) {
+    float Y[9];
+    shBasis(N, Y);
+    vec3 e = PROBE_PI * sh[0] * Y[0];
+    for (int i = 1; i < 4; ++i) e += (2.0 * PROBE_PI / 3.0) * sh[i] * Y[i];
+    for (int i = 4; i < 9; ++i) e += (PROBE_PI / 4.0) * sh[i] * Y[i];
+    return max(e, vec3(0.0));
+}
+
+#ifndef PROBE_BAKE
+
+// Trilinear probe irradiance at P around N. The lookup is pushed half a cell
+// along the normal so a surface does not read the probes inside its own sphere.
+vec3 probeIrradiance(vec3 P, vec3 N) {
+    vec3 grid = vec3(PROBE_GRID_X, PROBE_GRID_Y, PROBE_GRID_Z);
+    vec3 cell = clamp((P + N * 0.5 * probeCellSize - probeGridMin) / probeCellSize, vec3(0.0), grid - 1.0);
+
+    // Texel centres of block 0; each block is PROBE_GRID_Z slices further along z
+    vec3 uvw = (cell + 0.5) / vec3(grid.xy, grid.z * 7.0);
+    float block = 1.0 / 7.0;
+    float c[28];
+    for (int b = 0; b < 7; ++b) {
+        vec4 t = texture(probeGrid, uvw + vec3(0.0, 0.0, float(b) * block));
+        c[b * 4 + 0] = t.x;
+        c[b * 4 + 1] = t.y;
+        c[b * 4 + 2] = t.z;
+        c[b * 4 + 3] = t.w;
+    }
+
+    vec3 sh[9];
+    for (int i = 0; i < 9; ++i) sh[i] = vec3(c[i * 3], c[i * 3 + 1], c[i * 3 + 2]);
+    return shIrradiance(sh, N);
+}
+
+// Lambertian ambient + indirect light (replaces ambientStrength * albedo)
+vec3 ambientLight(vec3 P, vec3 N, vec3 albedo) {
+    return albedo * probeIrradiance(P, N) / PROBE_PI;
+}
+
+#endif
@@ -0,0 +1,17 @@
+// Point light cube shadow lookup (PointShadowMap)
+uniform samplerCubeShadow shadowMap;
+uniform vec3  shadowLightPos;
+uniform float shadowRange;
+uniform float shadowBias = 0.01;
+
+// 1 = lit, 0 = shadowed (hardware 2x2 PCF on the depth compare)
+float pointShadow(vec3 worldPos, vec3 N) {
+    vec3 fromLight = worldPos - shadowLightPos;
+    float distance = length(fromLight);
+    if (distance >= shadowRange) return 1.0;
+
+    // Slope-scaled bias: grazing surfaces need more
+    float cosTheta = clamp(dot(N, -fromLight / distance), 0.0, 1.0);
+    float bias = shadowBias * (1.0 + 2.0 * (1.0 - cosTheta));
+    return texture(shadowMap, vec4(fromLight, distance / shadowRange - bias));
+}
@@ -0,0 +1,56 @@
+// Analytic sphere occlusion: per-tile occluder lists (SphereOccluders) plus
+// closed-form soft shadow and ambient occlusion terms.
+// Layout constants are injected by SphereOccluders::defines().
+
+layout (std430, binding = OCCLUDERS_BINDING) readonly buffer Occluders { vec4 occluders[]; };  // xyz centre, w radius
+layout (std430, binding = OCCLUDER_COUNT_BINDING) readonly buffer OccluderCount { uint tileOccluderCount[]; };
+layout (std430, binding = OCCLUDER_INDICES_BINDING) readonly buffer OccluderIndices { uint tileOccluderIndex[]; };
+
+uniform vec2  occluderScreenSize;
+uniform float aoReach;              // AO influence distance in occluder radii
+
+// Cosine-weighted solid angle of a sphere seen from P (0 = no occlusion)
+float sphereAO(vec3 P, vec3 N, vec4 s) {
+    vec3 d = s.xyz - P;
+    float l = length(d);
+    if (l <= s.w * 1.001 || l >= s.w * aoReach) return 0.0;    // own sphere / out of reach
+    float h = l / s.w;
+    float fade = 1.0 - smoothstep(0.6, 1.0, h / aoReach);
+    return clamp(dot(N, d / l), 0.0, 1.0) / (h * h) * fade;
+}
+
+// Fraction of a spherical light hidden by a sphere: overlap of the two cones from P
+float sphereShadow(vec3 P, vec3 lightPos, float lightRadius, vec4 s) {
+    vec3 toLight = lightPos - P;
+    vec3 toOccluder = s.xyz - P;
+    float dl = length(toLight);
+    float dO = length(toOccluder);
+    if (dO <= s.w * 1.001 || dO - s.w >= dl) return 0.0;        // own sphere / behind the light
+
+    float thetaL = asin(min(lightRadius / dl, 1.0));
+    float thetaO = asin(min(s.w / dO, 1.0));
+    float gamma = acos(clamp(dot(toLight / dl, toOccluder / dO), -1.0, 1.0));
+
+    // Solid angle of the smaller cap, faded out as the cones separate
+    float capLight = 1.0 - cos(thetaL);
+    float capMin = 1.0 - cos(min(thetaL, thetaO));
+    float overlap = capMin * (1.0 - smoothstep(abs(thetaL - thetaO), thetaL + thetaO, gamma));
+    return clamp(overlap / max(capLight, 1e-6), 0.0, 1.0);
+}
+
+// AO (1 = open) and light visibility (1 = lit) from the fragment's tile list
+void sphereOcclusion(vec3 P, vec3 N, vec3 lightPos, float lightRadius,
+                     out float ao, out float shadow) {
+    uvec2 tile = uvec2(gl_FragCoord.xy / occluderScreenSize * vec2(OCCLUDER_TILES_X, OCCLUDER_TILES_Y));
+    tile = min(tile, uvec2(OCCLUDER_TILES_X - 1u, OCCLUDER_TILES_Y - 1u));
+    uint t = tile.x + OCCLUDER_TILES_X * tile.y;
+
+    ao = 1.0;
+    shadow = 1.0;
+    uint count = tileOccluderCount[t];
+    for (uint i = 0u; i < count; ++i) {
+        vec4 s = occluders[tileOccluderIndex[t * MAX_OCCLUDERS_PER_TILE + i]];
+        ao *= 1.0 - sphereAO(P, N, s);
+        shadow *= 1.0 - sphereShadow(P, lightPos, lightRadius, s);
+    }
+}
@@ -0,0 +1,14 @@
+#version 430 core
+// Attribute-less full-screen triangle (draw 3 vertices)
+// Variants (injected by ShaderVariants):
+//   FAR_PLANE - at the far plane, so with GL_LEQUAL it only covers pixels nothing was drawn to
+#include "depth.glsl"
+
+void main() {
+    vec2 pos = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+#ifdef FAR_PLANE
+    gl_Position = vec4(pos * 2.0 - 1.0, NDC_FAR, 1.0);
+#else
+    gl_Position = vec4(pos * 2.0 - 1.0, 0.0, 1.0);
+#endif
+}
@@ -0,0 +1,14 @@
+#version 430 core
+// Unit sphere mesh placed at a light and scaled to its range
+
+layout (location = 0) in vec3 aPos;
+
+uniform mat4 projection;
+uniform mat4 view;
+uniform vec4 lightPositionRange;    // xyz position, w range
+uniform float volumeScale;          // Keeps the coarse mesh outside the true sphere
+
+void main() {
+    vec3 worldPos = lightPositionRange.xyz + aPos * lightPositionRange.w * volumeScale;
+    gl_Position = projection * view * vec4(worldPos, 1.0);
+}
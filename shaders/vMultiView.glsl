@@ -0,0 +1,21 @@
+#version 430 core
+// Multi-view sphere vertex: drawn instanced with one instance per view,
+// projected by that view; gMultiView.glsl routes it to the view's target
+
+#include "multiview.glsl"
+
+layout (location = 0) in vec3 aPos;
+
+uniform mat4 model;
+
+out vec3 mvWorldPos;
+out vec3 mvNormal;
+flat out int mvView;
+
+void main() {
+    vec4 worldPos = model * vec4(aPos, 1.0);
+    mvWorldPos = worldPos.xyz;
+    mvNormal = normalize(mat3(model) * aPos);
+    mvView = gl_InstanceID;
+    gl_Position = views[gl_InstanceID].viewProjection * worldPos;
+}
@@ -1,4 +1,8 @@
 #version 430 core
+// Variants (injected by ShaderVariants):
+//   DEPTH_ONLY - position only (depth prepass); gl_Position is invariant so the
+//                shading pass can depth-test with GL_EQUAL against it
+//   VIRTUAL_TEXTURE - also pass the object-space position (cube-face lookup)
 
 layout (location = 0) in vec3 aPos;
 
@@ -6,14 +10,27 @@ uniform mat4 projection;
 uniform mat4 view;
 uniform mat4 model;
 
+invariant gl_Position;
+
+#ifndef DEPTH_ONLY
 out vec3 vWorldPos;
 out vec3 vNormal;
+#endif
+
+#ifdef VIRTUAL_TEXTURE
+out vec3 vObjectPos;
+#endif
 
 void main() {
     vec4 worldPos = model * vec4(aPos, 1.0);
-    vWorldPos = worldPos.xyz;
 
+#ifndef DEPTH_ONLY
+    vWorldPos = worldPos.xyz;
     vNormal = normalize(mat3(model) * aPos);
+#endif
+#ifdef VIRTUAL_TEXTURE
+    vObjectPos = aPos;
+#endif
 
     gl_Position = projection * view * worldPos;
-}
\ No newline at end of file
+}
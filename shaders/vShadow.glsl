@@ -0,0 +1,10 @@
+#version 430 core
+// Shadow caster: world-space position, projected per face by gShadow.glsl
+
+layout (location = 0) in vec3 aPos;
+
+uniform mat4 model;
+
+void main() {
+    gl_Position = model * vec4(aPos, 1.0);
+}
@@ -0,0 +1,64 @@
+// Virtual texture over the six CubeSphere faces (VirtualTexture): a page
+// table per face (one mip per level, texel = cache slot xy + resident flag)
+// and one physical tile cache. Layout constants are injected by
+// VirtualTexture::defines(); the rest comes from the tile file.
+const float VT_PI = 3.14159265;
+
+uniform usampler2DArray pageTable;  // Layer = face
+uniform sampler2D tileCache;
+uniform int   vtFaceTiles;          // Tiles per face edge at level 0
+uniform int   vtLevels;
+uniform float vtLodBias = 0.0;      // -log2(resolution divisor) in the feedback pass
+
+// Face (0-5: +X -X +Y -Y +Z -Z) and its (u, v) in [0,1]^2, matching
+// CubeSphere::faceDirection: u along the face's columns, v down its rows
+int cubeFaceUv(vec3 p, out vec2 uv) {
+    vec3 a = abs(p);
+    int face;
+    vec2 hv;                        // Column axis, row axis
+    float major;
+    if (a.x >= a.y && a.x >= a.z) {
+        face = p.x > 0.0 ? 0 : 1; hv = p.zy; major = a.x;
+    } else if (a.y >= a.z) {
+        face = p.y > 0.0 ? 2 : 3; hv = p.xz; major = a.y;
+    } else {
+        face = p.z > 0.0 ? 4 : 5; hv = p.xy; major = a.z;
+    }
+    hv /= major;
+    uv = vec2(hv.x + 1.0, 1.0 - hv.y) * 0.5;
+    return face;
+}
+
+// Level whose texels match this pixel's footprint. Measured as an angle on
+// the sphere (continuous across face edges, unlike the face uv); a face
+// spans pi/2, so level 0 has about vtFaceTiles * VT_TILE_SIZE / (pi/2)
+// texels per radian.
+int vtLevel(vec3 objectPos) {
+    vec3 d = normalize(objectPos);
+    float footprint = max(length(dFdx(d)), length(dFdy(d)));
+    float texelsPerRadian = float(vtFaceTiles * VT_TILE_SIZE) * 2.0 / VT_PI;
+    float lod = log2(max(footprint * texelsPerRadian, 1e-6)) + vtLodBias;
+    return clamp(int(floor(lod)), 0, vtLevels - 1);
+}
+
+// Tile of `level` holding face coordinate uv
+ivec2 vtTile(vec2 uv, int level) {
+    int n = vtFaceTiles >> level;
+    return min(ivec2(uv * float(n)), ivec2(n - 1));
+}
+
+// Finest resident texel at or above the wanted level (a = 0: nothing resident)
+vec4 virtualTexture(vec3 objectPos) {
+    vec2 uv;
+    int face = cubeFaceUv(objectPos, uv);
+    for (int level = vtLevel(objectPos); level < vtLevels; ++level) {
+        ivec2 tile = vtTile(uv, level);
+        uvec4 page = texelFetch(pageTable, ivec3(tile, face), level);
+        if (page.a == 0u) continue;
+
+        vec2 inTile = uv * float(vtFaceTiles >> level) - vec2(tile);
+        vec2 texel = vec2(page.xy) * float(VT_SLOT_SIZE) + float(VT_BORDER) + inTile * float(VT_TILE_SIZE);
+        return vec4(textureLod(tileCache, texel / float(VT_CACHE_SIZE), 0.0).rgb, 1.0);
+    }
+    return vec4(0.0);
+}
@@ -0,0 +1,156 @@
+#include "Renderer/atmosphere.h"
+#include "config.h"
+
+// Multiply heights, divide coefficients: optical depths stay the same
+void AtmosphereParams::exaggerate(float factor) {
+    thickness *= factor;
+    rayleighScaleHeight *= factor;
+    mieScaleHeight *= factor;
+    ozoneCenter *= factor;
+    ozoneWidth *= factor;
+    rayleighScattering /= factor;
+    mieScattering /= factor;
+    mieAbsorption /= factor;
+    ozoneAbsorption /= factor;
+}
+
+// Everything the transmittance / multi-scattering LUTs are built from
+bool AtmosphereParams::scatteringDiffers(const AtmosphereParams& o) const {
+    return thickness != o.thickness ||
+           rayleighScattering != o.rayleighScattering || rayleighScaleHeight != o.rayleighScaleHeight ||
+           mieScattering != o.mieScattering || mieAbsorption != o.mieAbsorption ||
+           mieScaleHeight != o.mieScaleHeight || mieG != o.mieG ||
+           ozoneAbsorption != o.ozoneAbsorption || ozoneCenter != o.ozoneCenter ||
+           ozoneWidth != o.ozoneWidth;
+}
+
+// Allocate the LUTs and build the programs
+void Atmosphere::init(ShaderVariants& shaders, GLState& glState) {
+    state = &glState;
+
+    transmittanceShader = &shaders.getCompute(ATMOSPHERE_TRANSMITTANCE_CSHADER_PATH, {}, true);
+    multiScatteringShader = &shaders.getCompute(ATMOSPHERE_MULTI_SCATTERING_CSHADER_PATH, {}, true);
+    skyViewShader = &shaders.getCompute(ATMOSPHERE_SKY_VIEW_CSHADER_PATH, {}, true);
+    skyShader = &shaders.get(FULLSCREEN_VSHADER_PATH, SKY_FSHADER_PATH, {"FAR_PLANE"}, true);
+
+    auto makeLut = [&](unsigned int& tex, int w, int h) {
+        glGenTextures(1, &tex);
+        state->bindTexture(0, GL_TEXTURE_2D, tex);
+        glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA16F, w, h);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    };
+    makeLut(transmittanceLut, TRANSMITTANCE_WIDTH, TRANSMITTANCE_HEIGHT);
+    makeLut(multiScatteringLut, MULTI_SCATTERING_SIZE, MULTI_SCATTERING_SIZE);
+    makeLut(skyViewLut, SKY_VIEW_WIDTH, SKY_VIEW_HEIGHT);
+
+    glGenVertexArrays(1, &fullscreenVAO);
+}
+
+// Parameter LUTs only on change (or first use); the sky-view LUT every call
+void Atmosphere::update(const AtmosphereParams& p, const glm::vec3& groundAlbedo,
+                        const glm::vec3& c, float r,
+                        const glm::vec3& sunPosition, const glm::vec3& sunColor,
+                        const glm::vec3& eye) {
+    center = c;
+    radius = r;
+    viewPos = eye;
+    glm::vec3 toSun = sunPosition - c;
+    sunDirection = glm::dot(toSun, toSun) > 0.0f ? glm::normalize(toSun) : glm::vec3(0.0f, 1.0f, 0.0f);
+    sunIlluminance = sunColor * p.sunIntensity;
+
+    if (!built || p.scatteringDiffers(params) || groundAlbedo != albedo) {
+        params = p;
+        albedo = groundAlbedo;
+        built = true;
+        ++rebuilds;
+
+        fill(*transmittanceShader, transmittanceLut,
+             (TRANSMITTANCE_WIDTH + 7) / 8, (TRANSMITTANCE_HEIGHT + 7) / 8);
+
+        // One 64-direction workgroup per texel
+        multiScatteringShader->use();
+        multiScatteringShader->setVec3("groundAlbedo", albedo);
+        fill(*multiScatteringShader, multiScatteringLut, MULTI_SCATTERING_SIZE, MULTI_SCATTERING_SIZE);
+    }
+
+    fill(*skyViewShader, skyViewLut, (SKY_VIEW_WIDTH + 7) / 8, (SKY_VIEW_HEIGHT + 7) / 8);
+}
+
+// Run one LUT pass: the earlier LUTs as inputs, `lut` as the image output
+void Atmosphere::fill(Shader& shader, unsigned int lut, int groupsX, int groupsY) {
+    shader.use();
+    bind(shader);
+    glBindImageTexture(0, lut, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA16F);
+    state->dispatchCompute(groupsX, groupsY, 1);
+    glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT | GL_TEXTURE_FETCH_BARRIER_BIT);
+}
+
+// Medium parameters, in planet radii like the LUTs themselves
+void Atmosphere::setMedium(Shader& shader) const {
+    shader.setFloat("atmosphereTop", 1.0f + params.thickness);
+    shader.setVec3("rayleighScattering", params.rayleighScattering);
+    shader.setFloat("rayleighScaleHeight", params.rayleighScaleHeight);
+    shader.setFloat("mieScattering", params.mieScattering);
+    shader.setFloat("mieExtinction", params.mieScattering + params.mieAbsorption);
+    shader.setFloat("mieScaleHeight", params.mieScaleHeight);
+    shader.setFloat("mieG", params.mieG);
+    shader.setVec3("ozoneAbsorption", params.ozoneAbsorption);
+    shader.setFloat("ozoneCenter", params.ozoneCenter);
+    shader.setFloat("ozoneWidth", params.ozoneWidth);
+}
+
+// Everything a program including atmosphere.glsl reads (program must be in use)
+void Atmosphere::bind(Shader& shader) const {
+    setMedium(shader);
+    shader.setVec3("planetCenter", center);
+    shader.setFloat("planetRadius", radius);
+    shader.setVec3("atmosphereCamera", (viewPos - center) / radius);
+    shader.setVec3("sunDirection", sunDirection);
+    shader.setVec3("sunIlluminance", sunIlluminance);
+
+    state->bindTexture(0, GL_TEXTURE_2D, transmittanceLut);
+    state->bindTexture(1, GL_TEXTURE_2D, multiScatteringLut);
+    state->bindTexture(2, GL_TEXTURE_2D, skyViewLut);
+    shader.setInt("transmittanceLut", 0);
+    shader.setInt("multiScatteringLut", 1);
+    shader.setInt("skyViewLut", 2);
+}
+
+// One sky-view fetch per background pixel, added to what is already there
+void Atmosphere::renderSky(const glm::mat4& inverseViewProjection, int width, int height) {
+    state->setDepthTest(true);
+    state->setDepthFunc(GL_LEQUAL);
+    state->setDepthWrite(false);
+    state->setBlend(true);
+    state->setBlendFunc(GL_ONE, GL_ONE);
+
+    skyShader->use();
+    bind(*skyShader);
+    skyShader->setMat4("inverseViewProjection", inverseViewProjection);
+    skyShader->setVec2("screenSize", glm::vec2(width, height));
+    skyShader->setVec3("viewPos", viewPos);
+    state->bindVertexArray(fullscreenVAO);
+    state->drawArrays(GL_TRIANGLES, 0, 3);
+
+    // Back to the renderer's defaults
+    state->setBlend(false);
+    state->setDepthFunc(GL_LESS);
+    state->setDepthWrite(true);
+}
+
+// How many times the parameter LUTs were built
+unsigned int Atmosphere::precomputeCount() const {
+    return rebuilds;
+}
+
+// Release GL objects
+void Atmosphere::terminate() {
+    state->invalidate();    // deleted names may be reused
+    unsigned int textures[3] = {transmittanceLut, multiScatteringLut, skyViewLut};
+    glDeleteTextures(3, textures);
+    glDeleteVertexArrays(1, &fullscreenVAO);
+    transmittanceLut = multiScatteringLut = skyViewLut = fullscreenVAO = 0;
+}
@@ -1,5 +1,7 @@
 #include "Renderer/camera.h"
 
+#include <cmath>
+
 // Constructs a camera from position, up vector, yaw, and pitch
 Camera::Camera(
     glm::vec3 position, 
@@ -12,6 +14,7 @@ Camera::Camera(
     MouseSensitivity(SENSITIVITY)
     {
         // Set initial state and compute orientation vectors
+        WorldPosition = glm::dvec3(position);
         Position = position;
         WorldUp = up;
         Yaw = yaw;
@@ -35,6 +38,7 @@ Camera::Camera(
     MouseSensitivity(SENSITIVITY)
     {
         // Set initial state and compute orientation vectors
+        WorldPosition = glm::dvec3(posX, posY, posZ);
         Position = glm::vec3(posX, posY, posZ);
         Up = glm::vec3(upX, upY, upZ);
         Yaw = yaw;
@@ -47,21 +51,30 @@ glm::mat4 Camera::getViewMatrix() {
     return glm::lookAt(Position, Position + Front, Up);
 }
 
-// Moves the camera based on direction and frame time
+// Render-space position from the double world position
+void Camera::setRenderOrigin(const glm::dvec3& origin) {
+    Position = glm::vec3(WorldPosition - origin);
+}
+
+// Moves the camera based on direction and frame time (in world space; the
+// render-space Position follows by the same step)
 void Camera::processKeyboard(cameraMovement direction, float deltaTime) {
     float velocity = MovementSpeed * deltaTime;
+    glm::vec3 step(0.0f);
     if (direction == cameraMovement::FORWARD) 
-        Position += Front * velocity;
+        step = Front * velocity;
     if (direction == cameraMovement::BACKWARD)
-        Position -= Front * velocity;
+        step = -Front * velocity;
     if (direction == cameraMovement::LEFT) 
-        Position -= Right * velocity;
+        step = -Right * velocity;
     if (direction == cameraMovement::RIGHT)
-        Position += Right * velocity;
+        step = Right * velocity;
     if (direction == cameraMovement::UP)
-        Position += Up * velocity;
+        step = Up * velocity;
     if (direction == cameraMovement::DOWN)
-        Position -= Up * velocity;
+        step = -Up * velocity;
+    WorldPosition += glm::dvec3(step);
+    Position += step;
 }
 
 // Adjusts yaw and pitch based on mouse movement
@@ -94,4 +107,23 @@ void Camera::updateCameraVectors() {
     Front = glm::normalize(front);
     Right = glm::normalize(glm::cross(Front, WorldUp));
     Up    = glm::normalize(glm::cross(Right, Front));
-}
\ No newline at end of file
+}
+
+// Infinite perspective; reversed: clip z = near and w = distance, so depth = near / distance
+glm::mat4 infiniteProjection(float fovy, float aspect, float zNear, bool reversed) {
+    if (!reversed) return glm::infinitePerspective(fovy, aspect, zNear);
+
+    float f = 1.0f / std::tan(fovy * 0.5f);
+    glm::mat4 projection(0.0f);
+    projection[0][0] = f / aspect;
+    projection[1][1] = f;
+    projection[2][3] = -1.0f;
+    projection[3][2] = zNear;
+    return projection;
+}
+
+// Finite perspective; reversed swaps the planes of a [0, 1] depth projection
+glm::mat4 perspectiveProjection(float fovy, float aspect, float zNear, float zFar, bool reversed) {
+    if (!reversed) return glm::perspective(fovy, aspect, zNear, zFar);
+    return glm::perspectiveRH_ZO(fovy, aspect, zFar, zNear);
+}
@@ -0,0 +1,94 @@
+#include "Renderer/clusters.h"
+#include "config.h"
+#include "settings.h"
+
+#include <algorithm>
+
+// Create the grid / index buffers and the light cull program
+void ClusteredLights::init(ShaderVariants& shaders, GLState& glState) {
+    state = &glState;
+    cullShader = &shaders.getCompute(CLUSTER_CULL_CSHADER_PATH, defines(), true);
+
+    const size_t clusters = GRID_X * GRID_Y * GRID_Z;
+
+    glGenBuffers(1, &lightBuffer);
+    glGenBuffers(1, &gridBuffer);
+    glGenBuffers(1, &indexBuffer);
+
+    state->bindBuffer(GL_SHADER_STORAGE_BUFFER, gridBuffer);
+    state->bufferData(GL_SHADER_STORAGE_BUFFER, clusters * sizeof(unsigned int), NULL, GL_DYNAMIC_COPY);
+    state->bindBuffer(GL_SHADER_STORAGE_BUFFER, indexBuffer);
+    state->bufferData(GL_SHADER_STORAGE_BUFFER,
+                      clusters * MAX_LIGHTS_PER_CLUSTER * sizeof(unsigned int), NULL, GL_DYNAMIC_COPY);
+}
+
+// Grid layout + binding points, injected into every program that reads the clusters
+std::vector<std::string> ClusteredLights::defines() {
+    return {
+        "CLUSTERED",
+        "CLUSTER_GRID_X " + std::to_string(GRID_X) + "u",
+        "CLUSTER_GRID_Y " + std::to_string(GRID_Y) + "u",
+        "CLUSTER_GRID_Z " + std::to_string(GRID_Z) + "u",
+        "MAX_LIGHTS_PER_CLUSTER " + std::to_string(MAX_LIGHTS_PER_CLUSTER) + "u",
+        "LIGHTS_BINDING " + std::to_string(LIGHTS_BINDING),
+        "GRID_BINDING " + std::to_string(GRID_BINDING),
+        "INDICES_BINDING " + std::to_string(INDICES_BINDING)
+    };
+}
+
+// Upload lights and bin them into clusters (one invocation per cluster)
+void ClusteredLights::update(const std::vector<PointLight>& lights,
+                             const glm::mat4& view, const glm::mat4& projection,
+                             int screenWidth, int screenHeight) {
+    count = (unsigned int)lights.size();
+    screenSize = glm::vec2(screenWidth, screenHeight);
+
+    // Grow the light buffer (doubling, never empty)
+    if (count > capacity || capacity == 0) {
+        capacity = std::max<size_t>(std::max<size_t>(count, capacity * 2), 1);
+        state->bindBuffer(GL_SHADER_STORAGE_BUFFER, lightBuffer);
+        state->bufferData(GL_SHADER_STORAGE_BUFFER, capacity * sizeof(PointLight), NULL, GL_DYNAMIC_DRAW);
+    }
+    if (count) {
+        state->bindBuffer(GL_SHADER_STORAGE_BUFFER, lightBuffer);
+        state->bufferSubData(GL_SHADER_STORAGE_BUFFER, 0, count * sizeof(PointLight), lights.data());
+    }
+
+    state->bindBufferBase(GL_SHADER_STORAGE_BUFFER, LIGHTS_BINDING, lightBuffer);
+    state->bindBufferBase(GL_SHADER_STORAGE_BUFFER, GRID_BINDING, gridBuffer);
+    state->bindBufferBase(GL_SHADER_STORAGE_BUFFER, INDICES_BINDING, indexBuffer);
+
+    cullShader->use();
+    cullShader->setMat4("view", view);
+    cullShader->setMat4("inverseProjection", glm::inverse(projection));
+    cullShader->setFloat("zNear", NEAR_PLANE);
+    cullShader->setFloat("zFar", FAR_PLANE);
+    cullShader->setUint("lightCount", count);
+
+    const unsigned int clusters = GRID_X * GRID_Y * GRID_Z;
+    state->dispatchCompute((clusters + 127) / 128, 1, 1);
+
+    // Lists are read by fragment shaders next
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+}
+
+// Bind the light buffers and the cluster lookup uniforms for shading
+void ClusteredLights::bind(Shader& shader) {
+    state->bindBufferBase(GL_SHADER_STORAGE_BUFFER, LIGHTS_BINDING, lightBuffer);
+    state->bindBufferBase(GL_SHADER_STORAGE_BUFFER, GRID_BINDING, gridBuffer);
+    state->bindBufferBase(GL_SHADER_STORAGE_BUFFER, INDICES_BINDING, indexBuffer);
+    shader.setVec2("screenSize", screenSize);
+    shader.setFloat("zNear", NEAR_PLANE);
+    shader.setFloat("zFar", FAR_PLANE);
+}
+
+unsigned int ClusteredLights::lightCount() const {
+    return count;
+}
+
+// Release GL objects
+void ClusteredLights::terminate() {
+    glDeleteBuffers(1, &lightBuffer);
+    glDeleteBuffers(1, &gridBuffer);
+    glDeleteBuffers(1, &indexBuffer);
+}
@@ -0,0 +1,26 @@
+#include "Renderer/column.h"
+
+#include <cstdlib>
+#include <new>
+
+#include <sys/mman.h>
+
+static const size_t HUGE_PAGE = 2u << 20;
+
+// Sizes rounded up to the alignment (aligned_alloc requires it); large
+// blocks on a huge page boundary so the advice can apply to all of them
+void* allocateColumn(size_t bytes) {
+    bool large = bytes >= HUGE_PAGE;
+    size_t alignment = large ? HUGE_PAGE : 64;
+    size_t rounded = (bytes + alignment - 1) / alignment * alignment;
+    void* data = std::aligned_alloc(alignment, rounded);
+    if (!data) throw std::bad_alloc();
+#if defined(MADV_HUGEPAGE)
+    if (large) madvise(data, rounded, MADV_HUGEPAGE);
+#endif
+    return data;
+}
+
+void releaseColumn(void* data) {
+    std::free(data);
+}
@@ -62,6 +62,26 @@ const float CubeSphere::getRadius() const {
     return Radius;
 }
 
+// Direction through a face point, with the axes and row order of buildFaceVertices
+void CubeSphere::faceDirection(unsigned int face, float u, float v, float dir[3]) {
+    int fixedAxis, hAxis, vAxis;
+    switch (face / 2) {
+        case Face::X : fixedAxis = 0; vAxis = 1; hAxis = 2; break;
+        case Face::Y : fixedAxis = 1; vAxis = 2; hAxis = 0; break;
+        default      : fixedAxis = 2; vAxis = 1; hAxis = 0; break;
+    }
+
+    float p[3];
+    p[fixedAxis] = (face % 2 == 0) ? POS : NEG;
+    p[hAxis]     = -1.0f + 2.0f * u;
+    p[vAxis]     =  1.0f - 2.0f * v;
+
+    float mag = sqrt(p[0]*p[0] + p[1]*p[1] + p[2]*p[2]);
+    dir[0] = p[0] / mag;
+    dir[1] = p[1] / mag;
+    dir[2] = p[2] / mag;
+}
+
 // Build all vertex positions by projecting cube faces to a sphere
 void CubeSphere::buildVertices() {
     float n[3];
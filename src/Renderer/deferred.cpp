@@ -0,0 +1,225 @@
+#include "Renderer/deferred.h"
+#include "config.h"
+
+#include <algorithm>
+
+// Light volumes are inscribed in the unit sphere; scale out so the coarse
+// mesh fully contains the light's range
+static const float VOLUME_SCALE = 1.1f;
+
+// Build programs, the light volume mesh and the full-screen VAO
+void DeferredRenderer::init(ShaderVariants& shaders, GLState& glState) {
+    state = &glState;
+
+    ambientShader = &shaders.get(FULLSCREEN_VSHADER_PATH, DEFERRED_LIGHT_FSHADER_PATH, {"AMBIENT"}, true);
+    lightShader   = &shaders.get(LIGHT_VOLUME_VSHADER_PATH, DEFERRED_LIGHT_FSHADER_PATH, {}, true);
+    stencilShader = &shaders.get(LIGHT_VOLUME_VSHADER_PATH, DEPTH_FSHADER_PATH, {}, true);
+
+    // Light volume: unit CubeSphere, positions only
+    glGenVertexArrays(1, &volumeVAO);
+    glGenBuffers(1, &volumeVBO);
+    glGenBuffers(1, &volumeEBO);
+    state->bindVertexArray(volumeVAO);
+    state->bindBuffer(GL_ARRAY_BUFFER, volumeVBO);
+    state->bufferData(GL_ARRAY_BUFFER, volume.getVertexDataSize(), volume.getVertexData(), GL_STATIC_DRAW);
+    state->bindBuffer(GL_ELEMENT_ARRAY_BUFFER, volumeEBO);
+    state->bufferData(GL_ELEMENT_ARRAY_BUFFER, volume.getIndexDataSize(), volume.getIndexData(), GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+
+    // Core profile needs a VAO even for attribute-less draws
+    glGenVertexArrays(1, &fullscreenVAO);
+    state->bindVertexArray(0);
+}
+
+// Set the render size; targets are only recreated when they must grow
+// (rendering uses the lower-left width x height area)
+void DeferredRenderer::resize(int w, int h) {
+    width = w;
+    height = h;
+    if (w <= allocWidth && h <= allocHeight) return;
+    releaseTargets();
+    allocWidth = std::max(w, allocWidth);
+    allocHeight = std::max(h, allocHeight);
+
+    auto makeTexture = [&](unsigned int& tex, GLenum format) {
+        glGenTextures(1, &tex);
+        state->bindTexture(0, GL_TEXTURE_2D, tex);
+        glTexStorage2D(GL_TEXTURE_2D, 1, format, allocWidth, allocHeight);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    };
+    makeTexture(albedoTexture, GL_RGBA8);
+    makeTexture(normalTexture, GL_RG16_SNORM);
+    makeTexture(depthStencil, state->depthStencilFormat());
+    makeTexture(depthCopy, state->depthStencilFormat());
+    makeTexture(lightTexture, GL_RGBA16F);
+
+    // G-buffer
+    glGenFramebuffers(1, &gbuffer);
+    state->bindFramebuffer(GL_FRAMEBUFFER, gbuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, albedoTexture, 0);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, normalTexture, 0);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_TEXTURE_2D, depthStencil, 0);
+    GLenum attachments[2] = {GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1};
+    glDrawBuffers(2, attachments);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        std::cout << "ERROR::DEFERRED::GBUFFER_INCOMPLETE" << std::endl;
+
+    // Light accumulation (shares depth/stencil with the G-buffer)
+    glGenFramebuffers(1, &accumulation);
+    state->bindFramebuffer(GL_FRAMEBUFFER, accumulation);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, lightTexture, 0);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_TEXTURE_2D, depthStencil, 0);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        std::cout << "ERROR::DEFERRED::ACCUMULATION_INCOMPLETE" << std::endl;
+
+    // Blit target for the sampled depth copy
+    glGenFramebuffers(1, &depthCopyFbo);
+    state->bindFramebuffer(GL_FRAMEBUFFER, depthCopyFbo);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_TEXTURE_2D, depthCopy, 0);
+    glDrawBuffer(GL_NONE);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        std::cout << "ERROR::DEFERRED::DEPTH_COPY_INCOMPLETE" << std::endl;
+
+    state->bindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+// Bind and clear the G-buffer
+void DeferredRenderer::beginGeometry() {
+    state->bindFramebuffer(GL_FRAMEBUFFER, gbuffer);
+    glViewport(0, 0, width, height);
+    state->setColorWrite(true);
+    state->setDepthWrite(true);
+    state->setDepthFunc(GL_LESS);
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glClearStencil(0);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+}
+
+// Copy depth into the sampled texture (the live one gets stencil writes)
+void DeferredRenderer::endGeometry() {
+    state->bindFramebuffer(GL_READ_FRAMEBUFFER, gbuffer);
+    state->bindFramebuffer(GL_DRAW_FRAMEBUFFER, depthCopyFbo);
+    glBlitFramebuffer(0, 0, width, height, 0, 0, width, height,
+                      GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT, GL_NEAREST);
+}
+
+// Ambient + stencil-tested light volumes, additively blended
+void DeferredRenderer::lightPass(const std::vector<PointLight>& lights,
+                                 const glm::mat4& view, const glm::mat4& projection,
+                                 const glm::vec3& viewPos) {
+    state->bindFramebuffer(GL_FRAMEBUFFER, accumulation);
+    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    glm::mat4 inverseViewProjection = glm::inverse(projection * view);
+
+    state->bindTexture(0, GL_TEXTURE_2D, albedoTexture);
+    state->bindTexture(1, GL_TEXTURE_2D, normalTexture);
+    state->bindTexture(2, GL_TEXTURE_2D, depthCopy);
+
+    // Ambient: one full-screen triangle (background albedo is zero)
+    state->setDepthTest(false);
+    state->setDepthWrite(false);
+    ambientShader->use();
+    ambientShader->setInt("gAlbedo", 0);
+    state->bindVertexArray(fullscreenVAO);
+    state->drawArrays(GL_TRIANGLES, 0, 3);
+
+    state->setBlend(true);
+    state->setBlendFunc(GL_ONE, GL_ONE);
+    state->setStencilTest(true);
+
+    lightShader->use();
+    lightShader->setInt("gAlbedo", 0);
+    lightShader->setInt("gNormal", 1);
+    lightShader->setInt("gDepth", 2);
+    lightShader->setMat4("view", view);
+    lightShader->setMat4("projection", projection);
+    lightShader->setMat4("inverseViewProjection", inverseViewProjection);
+    lightShader->setVec2("screenSize", glm::vec2(width, height));
+    lightShader->setVec3("viewPos", viewPos);
+    lightShader->setFloat("volumeScale", VOLUME_SCALE);
+
+    stencilShader->use();
+    stencilShader->setMat4("view", view);
+    stencilShader->setMat4("projection", projection);
+    stencilShader->setFloat("volumeScale", VOLUME_SCALE);
+
+    state->bindVertexArray(volumeVAO);
+    int indexCount = (int)volume.getIndexCount();
+
+    for (const PointLight& light : lights) {
+        // 1) Stencil: mark pixels whose surface lies inside the volume
+        //    (depth-fail counting on both faces, no colour)
+        stencilShader->use();
+        stencilShader->setVec4("lightPositionRange", light.positionRange);
+        state->setDepthTest(true);
+        state->setColorWrite(false);
+        state->setCull(false);
+        glStencilFunc(GL_ALWAYS, 0, 0xFF);
+        glStencilOpSeparate(GL_BACK,  GL_KEEP, GL_INCR_WRAP, GL_KEEP);
+        glStencilOpSeparate(GL_FRONT, GL_KEEP, GL_DECR_WRAP, GL_KEEP);
+        state->drawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0);
+
+        // 2) Lighting: back faces only, shade marked pixels and reset their stencil
+        lightShader->use();
+        lightShader->setVec4("lightPositionRange", light.positionRange);
+        lightShader->setVec3("lightColor", glm::vec3(light.color));
+        state->setDepthTest(false);
+        state->setColorWrite(true);
+        state->setCull(true);
+        state->setCullFace(GL_FRONT);
+        glStencilFunc(GL_NOTEQUAL, 0, 0xFF);
+        glStencilOp(GL_KEEP, GL_KEEP, GL_ZERO);
+        state->drawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0);
+    }
+
+    // Back to the renderer's defaults
+    state->setStencilTest(false);
+    state->setCull(false);
+    state->setCullFace(GL_BACK);
+    state->setBlend(false);
+    state->setDepthTest(true);
+    state->setDepthWrite(true);
+}
+
+// Accumulation target with the G-buffer depth, for depth-tested forward draws
+void DeferredRenderer::bindAccumulation() {
+    state->bindFramebuffer(GL_FRAMEBUFFER, accumulation);
+    state->setDepthTest(true);
+    state->setDepthFunc(GL_LESS);
+}
+
+// Copy the lit image and its depth to the scene target (default or offscreen
+// framebuffer, both GLState::depthStencilFormat()) so later passes can depth-test against it
+void DeferredRenderer::present(unsigned int target) {
+    state->bindFramebuffer(GL_READ_FRAMEBUFFER, accumulation);
+    state->bindFramebuffer(GL_DRAW_FRAMEBUFFER, target);
+    glBlitFramebuffer(0, 0, width, height, 0, 0, width, height,
+                      GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+    state->bindFramebuffer(GL_FRAMEBUFFER, target);
+}
+
+// Delete screen-sized targets
+void DeferredRenderer::releaseTargets() {
+    if (!gbuffer) return;
+    state->invalidate();    // deleted names may be reused
+    unsigned int fbos[3] = {gbuffer, accumulation, depthCopyFbo};
+    glDeleteFramebuffers(3, fbos);
+    unsigned int textures[5] = {albedoTexture, normalTexture, depthStencil, depthCopy, lightTexture};
+    glDeleteTextures(5, textures);
+    gbuffer = accumulation = depthCopyFbo = 0;
+}
+
+// Release GL objects
+void DeferredRenderer::terminate() {
+    releaseTargets();
+    glDeleteVertexArrays(1, &volumeVAO);
+    glDeleteVertexArrays(1, &fullscreenVAO);
+    glDeleteBuffers(1, &volumeVBO);
+    glDeleteBuffers(1, &volumeEBO);
+}
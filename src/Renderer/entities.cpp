@@ -0,0 +1,138 @@
+#include "Renderer/entities.h"
+
+#include <algorithm>
+
+// Append a row, reusing a free slot when there is one
+EntityHandle EntityStore::create(PoolHandle<Sphere> cold) {
+    uint32_t slot;
+    if (!freeSlots.empty()) {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    } else {
+        slot = (uint32_t)slotRow.size();
+        slotRow.push_back(0);
+        slotGeneration.push_back(1);        // Generation 0 is never live: default handles are stale
+    }
+    slotRow[slot] = (uint32_t)rowSlot.size();
+    rowSlot.push_back(slot);
+
+    worldPosition.push_back(glm::dvec3(0.0));
+    position.push_back(glm::vec3(0.0f));
+    radius.push_back(1.0f);
+    scale.push_back(1.0f);
+    transform.push_back(~0u);
+    color.push_back(glm::vec3(1.0f));
+    opacity.push_back(1.0f);
+    lightRange.push_back(10.0f);
+    flags.push_back(0);
+    mesh.push_back(PoolHandle<Mesh>());
+    sphere.push_back(cold);
+    return {slot, slotGeneration[slot]};
+}
+
+// Move the last row into the removed one and retire the slot
+void EntityStore::destroy(EntityHandle handle) {
+    if (!alive(handle)) return;
+    uint32_t row = slotRow[handle.slot];
+    uint32_t last = (uint32_t)rowSlot.size() - 1;
+
+    auto swapRemove = [&](auto& column) {
+        if (row != last) column[row] = std::move(column[last]);
+        column.pop_back();
+    };
+    swapRemove(worldPosition);
+    swapRemove(position);
+    swapRemove(radius);
+    swapRemove(scale);
+    swapRemove(transform);
+    swapRemove(color);
+    swapRemove(opacity);
+    swapRemove(lightRange);
+    swapRemove(flags);
+    swapRemove(mesh);
+    swapRemove(sphere);
+    swapRemove(rowSlot);
+    if (row != last) slotRow[rowSlot[row]] = row;
+
+    ++slotGeneration[handle.slot];
+    freeSlots.push_back(handle.slot);
+}
+
+// Grow every column once (a loaded scene) instead of a push per field per
+// row. Retired slots are taken first (their generations already moved on
+// when they were freed), then fresh ones. Columns the caller filled ahead
+// are already long enough for resize() to leave alone, and the derived ones
+// stay unwritten: first touch of fresh memory is most of a bulk load.
+uint32_t EntityStore::append(size_t count) {
+    uint32_t first = (uint32_t)rowSlot.size();
+    size_t total = first + count;
+    size_t reused = std::min(count, freeSlots.size());
+    uint32_t firstSlot = (uint32_t)slotRow.size();
+    slotRow.resize(firstSlot + count - reused);
+    slotGeneration.resize(firstSlot + count - reused, 1);
+    rowSlot.resize(total);
+    for (uint32_t i = 0; i < count; ++i) {
+        uint32_t slot = i < reused ? freeSlots[freeSlots.size() - 1 - i] : firstSlot + (uint32_t)(i - reused);
+        slotRow[slot] = first + i;
+        rowSlot[first + i] = slot;
+    }
+    freeSlots.resize(freeSlots.size() - reused);
+
+    worldPosition.resizeUninitialized(total);
+    position.resizeUninitialized(total);
+    radius.resize(total, 1.0f);
+    scale.resizeUninitialized(total);
+    transform.resize(total, ~0u);
+    color.resize(total, glm::vec3(1.0f));
+    opacity.resize(total, 1.0f);
+    lightRange.resize(total, 10.0f);
+    flags.resize(total, 0);
+    mesh.resize(total, PoolHandle<Mesh>());
+    sphere.resize(total, PoolHandle<Sphere>());
+    return first;
+}
+
+// Retire every slot (generations move on, so old handles stay stale) and empty the columns
+void EntityStore::clear() {
+    for (uint32_t slot : rowSlot) {
+        ++slotGeneration[slot];
+        freeSlots.push_back(slot);
+    }
+    rowSlot.clear();
+    worldPosition.clear();
+    position.clear();
+    radius.clear();
+    scale.clear();
+    transform.clear();
+    color.clear();
+    opacity.clear();
+    lightRange.clear();
+    flags.clear();
+    mesh.clear();
+    sphere.clear();
+}
+
+bool EntityStore::alive(EntityHandle handle) const {
+    return handle.slot < slotGeneration.size() && slotGeneration[handle.slot] == handle.generation;
+}
+
+uint32_t EntityStore::row(EntityHandle handle) const {
+    return slotRow[handle.slot];
+}
+
+EntityHandle EntityStore::handle(uint32_t row) const {
+    uint32_t slot = rowSlot[row];
+    return {slot, slotGeneration[slot]};
+}
+
+size_t EntityStore::size() const {
+    return rowSlot.size();
+}
+
+bool EntityStore::isSource(uint32_t row) const {
+    return (flags[row] & ENTITY_SOURCE) != 0;
+}
+
+bool EntityStore::translucent(uint32_t row) const {
+    return !isSource(row) && opacity[row] < 1.0f;
+}
@@ -0,0 +1,301 @@
+#include "Renderer/glstate.h"
+
+#include <GLFW/glfw3.h>
+#include <iostream>
+
+// ARB_clip_control enums (not in the GL 4.3 loader)
+#ifndef GL_NEGATIVE_ONE_TO_ONE
+#define GL_NEGATIVE_ONE_TO_ONE 0x935E
+#endif
+#ifndef GL_ZERO_TO_ONE
+#define GL_ZERO_TO_ONE 0x935F
+#endif
+
+// The same comparison with near and far swapped
+static GLenum mirrorDepthFunc(GLenum func) {
+    switch (func) {
+    case GL_LESS:    return GL_GREATER;
+    case GL_LEQUAL:  return GL_GEQUAL;
+    case GL_GREATER: return GL_LESS;
+    case GL_GEQUAL:  return GL_LEQUAL;
+    default:         return func;       // GL_EQUAL, GL_NOTEQUAL, GL_ALWAYS, GL_NEVER
+    }
+}
+
+// Start counting a new frame
+void GLState::beginFrame() {
+    current = GLFrameStats();
+}
+
+// Publish the finished frame's counters (and print them if requested)
+void GLState::endFrame() {
+    last = current;
+    if (dumpEachFrame) dump(std::cout);
+}
+
+const GLFrameStats& GLState::frameStats() const {
+    return last;
+}
+
+const GLFrameStats& GLState::currentStats() const {
+    return current;
+}
+
+// Print the last frame's counters on one line
+void GLState::dump(std::ostream& out) const {
+    out << "GL frame: draws " << last.draws
+        << " | tris " << last.triangles
+        << " | dispatch " << last.dispatches
+        << " | program " << last.programBinds
+        << " | vao " << last.vaoBinds
+        << " | buffer " << last.bufferBinds
+        << " | texture " << last.textureBinds
+        << " | fbo " << last.framebufferBinds
+        << " | state " << last.stateChanges
+        << " | uniforms " << last.uniformUploads
+        << " | bytes " << last.bytesUploaded
+        << " | skipped " << last.redundant << std::endl;
+}
+
+// Drop all cached values so the next call of each kind reaches the driver
+void GLState::invalidate() {
+    program = vao = activeUnit = drawFramebuffer = readFramebuffer = ~0u;
+    buffers.clear();
+    bufferBases.clear();
+    textures.clear();
+    colorWrite = depthTest = depthWrite = blend = cull = stencilTest = -1;
+    depthFunc = blendSrc = blendDst = cullFace = 0;
+}
+
+// Bind a program unless it is already current
+void GLState::useProgram(unsigned int id) {
+    if (program == id) { ++current.redundant; return; }
+    glUseProgram(id);
+    program = id;
+    ++current.programBinds;
+}
+
+// Bind a VAO; the element buffer binding is VAO state, so forget it
+void GLState::bindVertexArray(unsigned int id) {
+    if (vao == id) { ++current.redundant; return; }
+    glBindVertexArray(id);
+    vao = id;
+    buffers.erase(GL_ELEMENT_ARRAY_BUFFER);
+    ++current.vaoBinds;
+}
+
+// Bind a buffer to a non-indexed target
+void GLState::bindBuffer(GLenum target, unsigned int buffer) {
+    auto it = buffers.find(target);
+    if (it != buffers.end() && it->second == buffer) { ++current.redundant; return; }
+    glBindBuffer(target, buffer);
+    buffers[target] = buffer;
+    ++current.bufferBinds;
+}
+
+// Bind a buffer to an indexed target (UBO / SSBO); also sets the generic binding
+void GLState::bindBufferBase(GLenum target, unsigned int index, unsigned int buffer) {
+    uint64_t key = ((uint64_t)target << 32) | index;
+    auto it = bufferBases.find(key);
+    if (it != bufferBases.end() && it->second == buffer) { ++current.redundant; return; }
+    glBindBufferBase(target, index, buffer);
+    bufferBases[key] = buffer;
+    buffers[target] = buffer;
+    ++current.bufferBinds;
+}
+
+// Bind a texture to a unit (switching the active unit only when needed)
+void GLState::bindTexture(unsigned int unit, GLenum target, unsigned int texture) {
+    uint64_t key = ((uint64_t)unit << 32) | target;
+    auto it = textures.find(key);
+    if (it != textures.end() && it->second == texture) { ++current.redundant; return; }
+    if (activeUnit != unit) {
+        glActiveTexture(GL_TEXTURE0 + unit);
+        activeUnit = unit;
+    }
+    glBindTexture(target, texture);
+    textures[key] = texture;
+    ++current.textureBinds;
+}
+
+// Bind a framebuffer to GL_FRAMEBUFFER, GL_DRAW_FRAMEBUFFER or GL_READ_FRAMEBUFFER
+void GLState::bindFramebuffer(GLenum target, unsigned int framebuffer) {
+    bool draw = target != GL_READ_FRAMEBUFFER;
+    bool read = target != GL_DRAW_FRAMEBUFFER;
+    if ((!draw || drawFramebuffer == framebuffer) && (!read || readFramebuffer == framebuffer)) {
+        ++current.redundant;
+        return;
+    }
+    glBindFramebuffer(target, framebuffer);
+    if (draw) drawFramebuffer = framebuffer;
+    if (read) readFramebuffer = framebuffer;
+    ++current.framebufferBinds;
+}
+
+void GLState::setColorWrite(bool enabled) {
+    if (colorWrite == (int)enabled) { ++current.redundant; return; }
+    GLboolean mask = enabled ? GL_TRUE : GL_FALSE;
+    glColorMask(mask, mask, mask, mask);
+    colorWrite = enabled;
+    ++current.stateChanges;
+}
+
+void GLState::setDepthTest(bool enabled) {
+    setCap(GL_DEPTH_TEST, enabled, depthTest);
+}
+
+void GLState::setDepthWrite(bool enabled) {
+    if (depthWrite == (int)enabled) { ++current.redundant; return; }
+    glDepthMask(enabled ? GL_TRUE : GL_FALSE);
+    depthWrite = enabled;
+    ++current.stateChanges;
+}
+
+void GLState::setDepthFunc(GLenum func) {
+    if (depthFunc == func) { ++current.redundant; return; }
+    glDepthFunc(depthMirrored() ? mirrorDepthFunc(func) : func);
+    depthFunc = func;
+    ++current.stateChanges;
+}
+
+// Switch to reversed depth when glClipControl is available (GL 4.5 or ARB_clip_control)
+bool GLState::enableReversedDepth() {
+    int major = 0, minor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    glGetIntegerv(GL_MINOR_VERSION, &minor);
+    if (major > 4 || (major == 4 && minor >= 5) || glfwExtensionSupported("GL_ARB_clip_control"))
+        clipControl = (ClipControlProc)glfwGetProcAddress("glClipControl");
+    if (!clipControl) {
+        std::cout << "INFO::GLSTATE::NO_CLIP_CONTROL (standard depth)" << std::endl;
+        return false;
+    }
+
+    reversed = true;
+    standardOverride = false;
+    applyDepthConvention();
+    return true;
+}
+
+bool GLState::reversedDepth() const {
+    return reversed;
+}
+
+// Shadow maps keep the standard projection: switch around their passes
+void GLState::setStandardDepth(bool standard) {
+    if (!reversed) return;
+    if (standardOverride == standard) { ++current.redundant; return; }
+    standardOverride = standard;
+    applyDepthConvention();
+}
+
+GLenum GLState::depthStencilFormat() const {
+    return reversed ? GL_DEPTH32F_STENCIL8 : GL_DEPTH24_STENCIL8;
+}
+
+bool GLState::depthMirrored() const {
+    return reversed && !standardOverride;
+}
+
+// Clip range, clear value and the cached depth function for the current convention
+void GLState::applyDepthConvention() {
+    bool mirrored = depthMirrored();
+    clipControl(GL_LOWER_LEFT, mirrored ? GL_ZERO_TO_ONE : GL_NEGATIVE_ONE_TO_ONE);
+    glClearDepth(mirrored ? 0.0 : 1.0);
+    if (depthFunc) glDepthFunc(mirrored ? mirrorDepthFunc(depthFunc) : depthFunc);
+    ++current.stateChanges;
+}
+
+void GLState::setBlend(bool enabled) {
+    setCap(GL_BLEND, enabled, blend);
+}
+
+void GLState::setBlendFunc(GLenum src, GLenum dst) {
+    if (blendSrc == src && blendDst == dst) { ++current.redundant; return; }
+    glBlendFunc(src, dst);
+    blendSrc = src;
+    blendDst = dst;
+    ++current.stateChanges;
+}
+
+// Per-draw-buffer blend function; always issued, and the shared cached
+// function is forgotten since the buffers no longer agree
+void GLState::setBlendFunci(unsigned int buffer, GLenum src, GLenum dst) {
+    glBlendFunci(buffer, src, dst);
+    blendSrc = blendDst = 0;
+    ++current.stateChanges;
+}
+
+void GLState::setCull(bool enabled) {
+    setCap(GL_CULL_FACE, enabled, cull);
+}
+
+void GLState::setCullFace(GLenum face) {
+    if (cullFace == face) { ++current.redundant; return; }
+    glCullFace(face);
+    cullFace = face;
+    ++current.stateChanges;
+}
+
+void GLState::setStencilTest(bool enabled) {
+    setCap(GL_STENCIL_TEST, enabled, stencilTest);
+}
+
+// Indexed draw (counted)
+void GLState::drawElements(GLenum mode, int count, GLenum type, const void* offset) {
+    glDrawElements(mode, count, type, offset);
+    ++current.draws;
+    if (mode == GL_TRIANGLES) current.triangles += count / 3;
+}
+
+// Instanced indexed draw (counted once; triangles of every instance)
+void GLState::drawElementsInstanced(GLenum mode, int count, GLenum type, const void* offset, int instances) {
+    glDrawElementsInstanced(mode, count, type, offset, instances);
+    ++current.draws;
+    if (mode == GL_TRIANGLES) current.triangles += (uint64_t)(count / 3) * instances;
+}
+
+// Non-indexed draw (counted)
+void GLState::drawArrays(GLenum mode, int first, int count) {
+    glDrawArrays(mode, first, count);
+    ++current.draws;
+    if (mode == GL_TRIANGLES) current.triangles += count / 3;
+}
+
+// Indirect indexed draw from the bound GL_DRAW_INDIRECT_BUFFER (counted)
+void GLState::drawElementsIndirect(GLenum mode, GLenum type, const void* offset, int count) {
+    glDrawElementsIndirect(mode, type, offset);
+    ++current.draws;
+    if (mode == GL_TRIANGLES) current.triangles += count / 3;
+}
+
+// Compute dispatch (counted)
+void GLState::dispatchCompute(unsigned int x, unsigned int y, unsigned int z) {
+    glDispatchCompute(x, y, z);
+    ++current.dispatches;
+}
+
+// Buffer upload through the currently bound buffer (counted)
+void GLState::bufferData(GLenum target, size_t size, const void* data, GLenum usage) {
+    glBufferData(target, (GLsizeiptr)size, data, usage);
+    if (data) current.bytesUploaded += size;
+}
+
+// Partial buffer upload through the currently bound buffer (counted)
+void GLState::bufferSubData(GLenum target, size_t offset, size_t size, const void* data) {
+    glBufferSubData(target, (GLintptr)offset, (GLsizeiptr)size, data);
+    current.bytesUploaded += size;
+}
+
+// Uniform upload bookkeeping
+void GLState::countUniform(size_t bytes) {
+    ++current.uniformUploads;
+    current.bytesUploaded += bytes;
+}
+
+// glEnable / glDisable through a cached tri-state
+void GLState::setCap(GLenum cap, bool enabled, int& cached) {
+    if (cached == (int)enabled) { ++current.redundant; return; }
+    if (enabled) glEnable(cap); else glDisable(cap);
+    cached = enabled;
+    ++current.stateChanges;
+}
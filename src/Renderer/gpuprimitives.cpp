@@ -0,0 +1,361 @@
+#include "Renderer/gpuprimitives.h"
+#include "config.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <random>
+
+static const unsigned int MAX_GROUPS_X = 65535;    // Minimum GL guarantee per dimension
+
+// Build every program variant
+void GpuPrimitives::init(ShaderVariants& shaders, GLState& glState) {
+    state = &glState;
+    scanShader       = &shaders.getCompute(SCAN_CSHADER_PATH, {}, true);
+    scanAddShader    = &shaders.getCompute(SCAN_CSHADER_PATH, {"SCAN_ADD"}, true);
+    compactShader    = &shaders.getCompute(COMPACT_CSHADER_PATH, {}, true);
+    countShader[0]   = &shaders.getCompute(RADIX_SORT_CSHADER_PATH, {"RADIX_COUNT"}, true);
+    countShader[1]   = &shaders.getCompute(RADIX_SORT_CSHADER_PATH, {"RADIX_COUNT", "KEY64"}, true);
+    scatterShader[0] = &shaders.getCompute(RADIX_SORT_CSHADER_PATH, {}, true);
+    scatterShader[1] = &shaders.getCompute(RADIX_SORT_CSHADER_PATH, {"KEY64"}, true);
+}
+
+bool GpuPrimitives::isReady() {
+    Shader* all[] = {scanShader, scanAddShader, compactShader,
+                     countShader[0], countShader[1], scatterShader[0], scatterShader[1]};
+    for (Shader* shader : all)
+        if (!shader || !shader->isReady()) return false;
+    return true;
+}
+
+// Grow a scratch buffer to at least `bytes` (contents are not preserved)
+unsigned int GpuPrimitives::reserve(Scratch& scratch, size_t bytes) {
+    if (!scratch.buffer) glGenBuffers(1, &scratch.buffer);
+    if (bytes > scratch.bytes) {
+        scratch.bytes = bytes;
+        state->bindBuffer(GL_SHADER_STORAGE_BUFFER, scratch.buffer);
+        state->bufferData(GL_SHADER_STORAGE_BUFFER, bytes, NULL, GL_DYNAMIC_COPY);
+    }
+    return scratch.buffer;
+}
+
+// One workgroup per `groups`, folded into y past the x limit
+void GpuPrimitives::dispatch(Shader& shader, unsigned int groups) {
+    if (groups == 0) return;
+    unsigned int x = std::min(groups, MAX_GROUPS_X);
+    unsigned int y = (groups + x - 1) / x;
+    shader.setUint("groupCount", groups);
+    state->dispatchCompute(x, y, 1);
+}
+
+void GpuPrimitives::exclusiveScan(unsigned int buffer, unsigned int count) {
+    if (count == 0) return;
+    scanLevel(buffer, count, 0);
+}
+
+// Scan blocks, scan their totals one level down, add them back
+void GpuPrimitives::scanLevel(unsigned int buffer, unsigned int count, size_t level) {
+    unsigned int groups = (count + SCAN_BLOCK - 1) / SCAN_BLOCK;
+    if (scanLevels.size() <= level) scanLevels.resize(level + 1);
+    unsigned int sums = reserve(scanLevels[level], groups * sizeof(unsigned int));
+
+    scanShader->use();
+    scanShader->setUint("count", count);
+    state->bindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, buffer);
+    state->bindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, sums);
+    dispatch(*scanShader, groups);
+    if (groups == 1) return;
+
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+    scanLevel(sums, groups, level + 1);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+    scanAddShader->use();
+    scanAddShader->setUint("count", count);
+    state->bindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, buffer);
+    state->bindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, sums);
+    dispatch(*scanAddShader, groups);
+}
+
+// Scan the flags into offsets, then scatter the kept elements
+void GpuPrimitives::compact(unsigned int input, unsigned int flags, unsigned int count,
+                            unsigned int output, unsigned int keptCount) {
+    if (count == 0) {
+        const unsigned int zero = 0;
+        state->bindBuffer(GL_SHADER_STORAGE_BUFFER, keptCount);
+        state->bufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(zero), &zero);
+        return;
+    }
+
+    unsigned int scanned = reserve(offsets, count * sizeof(unsigned int));
+    state->bindBuffer(GL_COPY_READ_BUFFER, flags);
+    state->bindBuffer(GL_COPY_WRITE_BUFFER, scanned);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, count * sizeof(unsigned int));
+    exclusiveScan(scanned, count);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+    compactShader->use();
+    compactShader->setUint("count", count);
+    state->bindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, input);
+    state->bindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, flags);
+    state->bindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, scanned);
+    state->bindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, output);
+    state->bindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, keptCount);
+    dispatch(*compactShader, (count + RADIX_TILE - 1) / RADIX_TILE);
+}
+
+void GpuPrimitives::sort(unsigned int keys, unsigned int values, unsigned int count, unsigned int keyBits) {
+    radixSort(false, keys, values, count, std::min(keyBits, 32u));
+}
+
+void GpuPrimitives::sort64(unsigned int keys, unsigned int values, unsigned int count, unsigned int keyBits) {
+    radixSort(true, keys, values, count, std::min(keyBits, 64u));
+}
+
+// 4 bits per pass: count digits per tile, scan the digit-major counts,
+// scatter into the other buffer pair; an odd pass count copies back
+void GpuPrimitives::radixSort(bool wide, unsigned int keys, unsigned int values,
+                              unsigned int count, unsigned int keyBits) {
+    if (count < 2 || keyBits == 0) return;
+
+    size_t keySize = wide ? 2 * sizeof(unsigned int) : sizeof(unsigned int);
+    unsigned int tiles = (count + RADIX_TILE - 1) / RADIX_TILE;
+    unsigned int digits = 1u << RADIX_BITS;
+    unsigned int counts = reserve(digitCounts, (size_t)tiles * digits * sizeof(unsigned int));
+
+    unsigned int srcKeys = keys, srcValues = values;
+    unsigned int dstKeys = reserve(keyScratch, count * keySize);
+    unsigned int dstValues = reserve(valueScratch, count * sizeof(unsigned int));
+    Shader& counter = *countShader[wide];
+    Shader& scatter = *scatterShader[wide];
+
+    unsigned int passes = (keyBits + RADIX_BITS - 1) / RADIX_BITS;
+    for (unsigned int pass = 0; pass < passes; ++pass) {
+        unsigned int shift = pass * RADIX_BITS;
+
+        counter.use();
+        counter.setUint("count", count);
+        counter.setUint("shift", shift);
+        state->bindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, srcKeys);
+        state->bindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, counts);
+        dispatch(counter, tiles);
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+        exclusiveScan(counts, tiles * digits);
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+        scatter.use();
+        scatter.setUint("count", count);
+        scatter.setUint("shift", shift);
+        state->bindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, srcKeys);
+        state->bindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, dstKeys);
+        state->bindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, srcValues);
+        state->bindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, dstValues);
+        state->bindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, counts);
+        dispatch(scatter, tiles);
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+        std::swap(srcKeys, dstKeys);
+        std::swap(srcValues, dstValues);
+    }
+
+    if (srcKeys != keys) {
+        glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+        state->bindBuffer(GL_COPY_READ_BUFFER, srcKeys);
+        state->bindBuffer(GL_COPY_WRITE_BUFFER, keys);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, count * keySize);
+        state->bindBuffer(GL_COPY_READ_BUFFER, srcValues);
+        state->bindBuffer(GL_COPY_WRITE_BUFFER, values);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, count * sizeof(unsigned int));
+    }
+}
+
+// New SSBO holding `data`
+static unsigned int makeBuffer(GLState& state, const std::vector<uint32_t>& data) {
+    unsigned int buffer = 0;
+    glGenBuffers(1, &buffer);
+    state.bindBuffer(GL_SHADER_STORAGE_BUFFER, buffer);
+    state.bufferData(GL_SHADER_STORAGE_BUFFER, std::max<size_t>(data.size(), 1) * sizeof(uint32_t),
+                     data.empty() ? NULL : data.data(), GL_DYNAMIC_COPY);
+    return buffer;
+}
+
+// Blocking copy of `count` uints back to the CPU
+static std::vector<uint32_t> readBuffer(GLState& state, unsigned int buffer, size_t count) {
+    std::vector<uint32_t> data(count);
+    glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+    state.bindBuffer(GL_SHADER_STORAGE_BUFFER, buffer);
+    if (count) glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, count * sizeof(uint32_t), data.data());
+    return data;
+}
+
+// CPU reference: stable order of indices by key
+template <typename Key>
+static std::vector<uint32_t> stableOrder(const std::vector<Key>& keys) {
+    std::vector<uint32_t> order(keys.size());
+    std::iota(order.begin(), order.end(), 0u);
+    std::stable_sort(order.begin(), order.end(),
+                     [&](uint32_t a, uint32_t b) { return keys[a] < keys[b]; });
+    return order;
+}
+
+// Run every primitive on awkward sizes and compare with CPU results
+bool GpuPrimitives::selfTest(std::ostream& out) {
+    if (!isReady()) {
+        out << "GPU PRIMITIVES: programs still compiling" << std::endl;
+        return false;
+    }
+
+    std::mt19937 rng(1234);
+    const unsigned int sizes[] = {1, 255, 512, 513, 100000, 1000003};
+    bool allPassed = true;
+
+    for (unsigned int n : sizes) {
+        std::vector<uint32_t> index(n);
+        std::iota(index.begin(), index.end(), 0u);
+
+        // Scan
+        std::vector<uint32_t> data(n), expected(n);
+        for (uint32_t& v : data) v = rng() & 15u;
+        std::exclusive_scan(data.begin(), data.end(), expected.begin(), 0u);
+        unsigned int scanBuffer = makeBuffer(*state, data);
+        exclusiveScan(scanBuffer, n);
+        bool scanOk = readBuffer(*state, scanBuffer, n) == expected;
+
+        // Compaction of the indices with random flags
+        std::vector<uint32_t> flags(n), kept;
+        for (uint32_t i = 0; i < n; ++i) {
+            flags[i] = rng() & 1u;
+            if (flags[i]) kept.push_back(i);
+        }
+        unsigned int input = makeBuffer(*state, index);
+        unsigned int flagBuffer = makeBuffer(*state, flags);
+        unsigned int output = makeBuffer(*state, std::vector<uint32_t>(n));
+        unsigned int keptBuffer = makeBuffer(*state, {0u});
+        compact(input, flagBuffer, n, output, keptBuffer);
+        std::vector<uint32_t> compacted = readBuffer(*state, output, kept.size());
+        bool compactOk = compacted == kept && readBuffer(*state, keptBuffer, 1)[0] == kept.size();
+
+        // 32-bit sort, few distinct keys so stability is exercised
+        std::vector<uint32_t> keys(n);
+        for (uint32_t& k : keys) k = rng() & 0x0F0F00FFu;
+        std::vector<uint32_t> order = stableOrder(keys);
+        unsigned int keyBuffer = makeBuffer(*state, keys);
+        unsigned int valueBuffer = makeBuffer(*state, index);
+        sort(keyBuffer, valueBuffer, n);
+        bool sortOk = readBuffer(*state, valueBuffer, n) == order;
+
+        // 64-bit sort, keys differing in both words
+        std::vector<uint64_t> wide(n);
+        std::vector<uint32_t> words(2 * n);
+        for (uint32_t i = 0; i < n; ++i) {
+            words[2 * i]     = rng() & 0xFFFFu;
+            words[2 * i + 1] = rng() & 7u;
+            wide[i] = ((uint64_t)words[2 * i + 1] << 32) | words[2 * i];
+        }
+        std::vector<uint32_t> wideOrder = stableOrder(wide);
+        unsigned int wideBuffer = makeBuffer(*state, words);
+        unsigned int wideValues = makeBuffer(*state, index);
+        sort64(wideBuffer, wideValues, n);
+        bool sort64Ok = readBuffer(*state, wideValues, n) == wideOrder;
+
+        unsigned int buffers[] = {scanBuffer, input, flagBuffer, output, keptBuffer,
+                                  keyBuffer, valueBuffer, wideBuffer, wideValues};
+        state->invalidate();    // deleted names may be reused
+        glDeleteBuffers(9, buffers);
+
+        bool passed = scanOk && compactOk && sortOk && sort64Ok;
+        allPassed = allPassed && passed;
+        out << "GPU PRIMITIVES: n " << n
+            << " | scan " << (scanOk ? "ok" : "FAIL")
+            << " | compact " << (compactOk ? "ok" : "FAIL")
+            << " | sort32 " << (sortOk ? "ok" : "FAIL")
+            << " | sort64 " << (sort64Ok ? "ok" : "FAIL") << std::endl;
+    }
+    return allPassed;
+}
+
+// GPU time of every primitive from 1M to 16M elements (sorted output verified)
+void GpuPrimitives::benchmark(std::ostream& out) {
+    if (!isReady()) {
+        out << "GPU PRIMITIVES: programs still compiling" << std::endl;
+        return;
+    }
+
+    unsigned int query = 0;
+    glGenQueries(1, &query);
+    auto timeMs = [&](const std::function<void()>& work) {
+        glFinish();
+        glBeginQuery(GL_TIME_ELAPSED, query);
+        work();
+        glEndQuery(GL_TIME_ELAPSED);
+        GLuint64 ns = 0;
+        glGetQueryObjectui64v(query, GL_QUERY_RESULT, &ns);
+        return ns / 1.0e6;
+    };
+
+    std::mt19937 rng(99);
+    for (unsigned int n = 1u << 20; n <= (1u << 24); n <<= 1) {
+        std::vector<uint32_t> keys(n), words(2 * n), flags(n), index(n);
+        for (uint32_t& k : keys) k = rng();
+        for (uint32_t& w : words) w = rng();
+        for (uint32_t& f : flags) f = rng() & 1u;
+        std::iota(index.begin(), index.end(), 0u);
+
+        unsigned int keyBuffer = makeBuffer(*state, keys);
+        unsigned int wideBuffer = makeBuffer(*state, words);
+        unsigned int valueBuffer = makeBuffer(*state, index);
+        unsigned int flagBuffer = makeBuffer(*state, flags);
+        unsigned int output = makeBuffer(*state, index);
+        unsigned int keptBuffer = makeBuffer(*state, {0u});
+
+        // Warm-up grows the scratch buffers outside the timed runs
+        sort64(wideBuffer, valueBuffer, n);
+        compact(keyBuffer, flagBuffer, n, output, keptBuffer);
+
+        // Timed runs: scan in place over the compacted output (values are irrelevant),
+        // sorts over keys not yet sorted
+        double scanMs = timeMs([&] { exclusiveScan(output, n); });
+        double compactMs = timeMs([&] { compact(keyBuffer, flagBuffer, n, output, keptBuffer); });
+        double sortMs = timeMs([&] { sort(keyBuffer, valueBuffer, n); });
+        std::vector<uint32_t> sorted = readBuffer(*state, keyBuffer, n);
+        bool sortedOk = std::is_sorted(sorted.begin(), sorted.end());
+
+        state->bindBuffer(GL_SHADER_STORAGE_BUFFER, wideBuffer);
+        state->bufferSubData(GL_SHADER_STORAGE_BUFFER, 0, words.size() * sizeof(uint32_t), words.data());
+        double sort64Ms = timeMs([&] { sort64(wideBuffer, valueBuffer, n); });
+
+        auto rate = [n](double ms) { return ms > 0.0 ? n / (ms * 1.0e3) : 0.0; };  // M elements / s
+        out << "GPU PRIMITIVES: n " << (n >> 20) << "M"
+            << " | scan " << scanMs << " ms (" << rate(scanMs) << " M/s)"
+            << " | compact " << compactMs << " ms (" << rate(compactMs) << " M/s)"
+            << " | sort32 " << sortMs << " ms (" << rate(sortMs) << " M/s)"
+            << " | sort64 " << sort64Ms << " ms (" << rate(sort64Ms) << " M/s)"
+            << (sortedOk ? "" : " | sort32 FAIL") << std::endl;
+
+        unsigned int buffers[] = {keyBuffer, wideBuffer, valueBuffer, flagBuffer, output, keptBuffer};
+        state->invalidate();
+        glDeleteBuffers(6, buffers);
+    }
+
+    glDeleteQueries(1, &query);
+    releaseScratch();
+}
+
+// Free scratch memory; it is reallocated at the next use
+void GpuPrimitives::releaseScratch() {
+    std::vector<Scratch*> all = {&keyScratch, &valueScratch, &digitCounts, &offsets};
+    for (Scratch& level : scanLevels) all.push_back(&level);
+    state->invalidate();    // deleted names may be reused
+    for (Scratch* scratch : all) {
+        if (scratch->buffer) glDeleteBuffers(1, &scratch->buffer);
+        *scratch = Scratch();
+    }
+    scanLevels.clear();
+}
+
+// Release GL objects
+void GpuPrimitives::terminate() {
+    releaseScratch();
+}
@@ -0,0 +1,55 @@
+#include "Renderer/gpuquery.h"
+
+// Create the ring of query objects for a target
+void GpuQuery::init(GLenum queryTarget) {
+    target = queryTarget;
+    glGenQueries(RING, ids);
+}
+
+// Start measuring into the current slot. If that slot's previous result was
+// never read (the GPU is more than RING frames behind) it is dropped.
+void GpuQuery::begin() {
+    if (!ids[0] || active) return;
+    glBeginQuery(target, ids[head]);
+    issued[head] = true;
+    active = true;
+}
+
+// Stop measuring and move on to the next slot
+void GpuQuery::end() {
+    if (!active) return;
+    glEndQuery(target);
+    active = false;
+    head = (head + 1) % RING;
+}
+
+// Read every finished slot, oldest first; result is the newest one available
+bool GpuQuery::poll(uint64_t& result) {
+    bool found = false;
+    for (int i = 0; i < RING; ++i) {
+        int slot = (head + i) % RING;           // oldest -> newest
+        if (!issued[slot] || (active && slot == head)) continue;
+
+        int available = 0;
+        glGetQueryObjectiv(ids[slot], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) break;                  // later slots cannot be done either
+
+        GLuint64 v = 0;
+        glGetQueryObjectui64v(ids[slot], GL_QUERY_RESULT, &v);
+        issued[slot] = false;
+        value = v;
+        found = true;
+    }
+    result = value;
+    return found;
+}
+
+uint64_t GpuQuery::last() const {
+    return value;
+}
+
+// Delete the query objects
+void GpuQuery::terminate() {
+    if (ids[0]) glDeleteQueries(RING, ids);
+    for (int i = 0; i < RING; ++i) { ids[i] = 0; issued[i] = false; }
+}
@@ -0,0 +1,185 @@
+#include "Renderer/hiz.h"
+#include "config.h"
+
+#include <algorithm>
+#include <cmath>
+
+// Create depth target, pyramid, buffers and compute programs
+void HiZCuller::init(unsigned int w, unsigned int h, ShaderVariants& shaders, GLState& glState) {
+    state  = &glState;
+    width  = w;
+    height = h;
+    levels = 1 + (unsigned int)std::floor(std::log2((float)std::max(width, height)));
+
+    copyShader   = &shaders.getCompute(HIZ_REDUCE_CSHADER_PATH, {"COPY_DEPTH"}, true);
+    reduceShader = &shaders.getCompute(HIZ_REDUCE_CSHADER_PATH, {}, true);
+    cullShader   = &shaders.getCompute(HIZ_CULL_CSHADER_PATH, {}, true);
+
+    // Occluder depth target
+    glGenTextures(1, &depthTexture);
+    state->bindTexture(0, GL_TEXTURE_2D, depthTexture);
+    glTexStorage2D(GL_TEXTURE_2D, 1, GL_DEPTH_COMPONENT32F, width, height);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+    glGenFramebuffers(1, &fbo);
+    state->bindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, depthTexture, 0);
+    glDrawBuffer(GL_NONE);
+    glReadBuffer(GL_NONE);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        std::cout << "ERROR::HIZ::FRAMEBUFFER_INCOMPLETE" << std::endl;
+    }
+    state->bindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    // Depth pyramid (full mip chain, point sampled per level)
+    glGenTextures(1, &pyramid);
+    state->bindTexture(0, GL_TEXTURE_2D, pyramid);
+    glTexStorage2D(GL_TEXTURE_2D, levels, GL_RG32F, width, height);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    glGenBuffers(1, &boundsBuffer);
+    glGenBuffers(1, &commandBuffer);
+
+    // Counters: drawn, occluded, frustumCulled
+    glGenBuffers(STATS_RING, statsBuffers);
+    for (int i = 0; i < STATS_RING; ++i) {
+        state->bindBuffer(GL_SHADER_STORAGE_BUFFER, statsBuffers[i]);
+        state->bufferData(GL_SHADER_STORAGE_BUFFER, 3 * sizeof(unsigned int), NULL, GL_DYNAMIC_READ);
+    }
+}
+
+// Bind + clear the occluder depth target at pyramid resolution
+void HiZCuller::beginOccluders() {
+    state->bindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glViewport(0, 0, width, height);
+    state->setDepthTest(true);
+    state->setDepthFunc(GL_LESS);      // Not the prepass's GL_EQUAL
+    state->setDepthWrite(true);
+    glClear(GL_DEPTH_BUFFER_BIT);
+}
+
+// Reduce the occluder depth into the pyramid, one dispatch per level
+void HiZCuller::endOccluders() {
+    state->bindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    unsigned int w = width, h = height;
+    for (unsigned int level = 0; level < levels; ++level) {
+        Shader& shader = level == 0 ? *copyShader : *reduceShader;
+        shader.use();
+
+        if (level == 0) {
+            state->bindTexture(0, GL_TEXTURE_2D, depthTexture);
+        } else {
+            state->bindTexture(0, GL_TEXTURE_2D, pyramid);
+            shader.setInt("srcLevel", (int)level - 1);
+            shader.setVec2("srcSize", glm::vec2(w, h));
+            w = std::max(1u, w / 2);
+            h = std::max(1u, h / 2);
+        }
+        shader.setInt("src", 0);
+        shader.setVec2("dstSize", glm::vec2(w, h));
+        glBindImageTexture(0, pyramid, level, GL_FALSE, 0, GL_WRITE_ONLY, GL_RG32F);
+
+        state->dispatchCompute((w + 7) / 8, (h + 7) / 8, 1);
+        glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT | GL_TEXTURE_FETCH_BARRIER_BIT);
+    }
+}
+
+// Upload bounds + commands, test every sphere, and kick off the stats readback
+void HiZCuller::cull(const std::vector<glm::vec4>& bounds,
+                     const std::vector<DrawCommand>& commands,
+                     const glm::mat4& viewProjection, bool occlusion) {
+    size_t count = bounds.size();
+    if (count == 0) return;
+    reserve(count);
+
+    state->bindBuffer(GL_SHADER_STORAGE_BUFFER, boundsBuffer);
+    state->bufferSubData(GL_SHADER_STORAGE_BUFFER, 0, count * sizeof(glm::vec4), bounds.data());
+    state->bindBuffer(GL_SHADER_STORAGE_BUFFER, commandBuffer);
+    state->bufferSubData(GL_SHADER_STORAGE_BUFFER, 0, count * sizeof(DrawCommand), commands.data());
+
+    // Reuse the oldest stats slot (its fence is dropped if it never got read)
+    int slot = statsHead;
+    statsHead = (statsHead + 1) % STATS_RING;
+    if (statsFences[slot]) glDeleteSync(statsFences[slot]);
+    unsigned int zero[3] = {0, 0, 0};
+    state->bindBuffer(GL_SHADER_STORAGE_BUFFER, statsBuffers[slot]);
+    state->bufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(zero), zero);
+
+    state->bindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, boundsBuffer);
+    state->bindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, commandBuffer);
+    state->bindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, statsBuffers[slot]);
+    state->bindTexture(0, GL_TEXTURE_2D, pyramid);
+
+    cullShader->use();
+    cullShader->setInt("hiz", 0);
+    cullShader->setMat4("viewProjection", viewProjection);
+    cullShader->setVec2("hizSize", glm::vec2(width, height));
+    cullShader->setInt("hizLevels", (int)levels);
+    cullShader->setUint("count", (unsigned int)count);
+    cullShader->setBool("occlusion", occlusion);
+    state->dispatchCompute((unsigned int)((count + 63) / 64), 1, 1);
+
+    // Commands are consumed by indirect draws, counters by the readback below
+    glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+
+    statsFences[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    statsTested[slot] = (unsigned int)count;
+}
+
+// Bind the culled commands for glDrawElementsIndirect
+void HiZCuller::bindCommands() {
+    state->bindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+}
+
+// Read back the newest finished counters (never waits)
+const CullStats& HiZCuller::getStats() {
+    for (int i = 0; i < STATS_RING; ++i) {
+        int slot = (statsHead + i) % STATS_RING;        // oldest -> newest
+        if (!statsFences[slot]) continue;
+
+        GLenum status = glClientWaitSync(statsFences[slot], 0, 0);
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) break;
+
+        unsigned int counters[3];
+        state->bindBuffer(GL_SHADER_STORAGE_BUFFER, statsBuffers[slot]);
+        glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(counters), counters);
+        glDeleteSync(statsFences[slot]);
+        statsFences[slot] = 0;
+
+        stats.tested        = statsTested[slot];
+        stats.drawn         = counters[0];
+        stats.occluded      = counters[1];
+        stats.frustumCulled = counters[2];
+    }
+    return stats;
+}
+
+// Grow the per-sphere buffers (doubling)
+void HiZCuller::reserve(size_t count) {
+    if (count <= capacity) return;
+    capacity = std::max(count, capacity * 2);
+
+    state->bindBuffer(GL_SHADER_STORAGE_BUFFER, boundsBuffer);
+    state->bufferData(GL_SHADER_STORAGE_BUFFER, capacity * sizeof(glm::vec4), NULL, GL_DYNAMIC_DRAW);
+    state->bindBuffer(GL_SHADER_STORAGE_BUFFER, commandBuffer);
+    state->bufferData(GL_SHADER_STORAGE_BUFFER, capacity * sizeof(DrawCommand), NULL, GL_DYNAMIC_DRAW);
+}
+
+// Release GL objects
+void HiZCuller::terminate() {
+    for (int i = 0; i < STATS_RING; ++i) {
+        if (statsFences[i]) glDeleteSync(statsFences[i]);
+        statsFences[i] = 0;
+    }
+    glDeleteBuffers(STATS_RING, statsBuffers);
+    glDeleteBuffers(1, &boundsBuffer);
+    glDeleteBuffers(1, &commandBuffer);
+    glDeleteTextures(1, &pyramid);
+    glDeleteTextures(1, &depthTexture);
+    glDeleteFramebuffers(1, &fbo);
+}
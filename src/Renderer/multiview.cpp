@@ -0,0 +1,162 @@
+#include "Renderer/multiview.h"
+#include "settings.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <glm/gtc/matrix_transform.hpp>
+
+// Create the view block and the layered capture target
+void MultiView::init(GLState& glState) {
+    state = &glState;
+
+    glGenBuffers(1, &viewBuffer);
+    state->bindBuffer(GL_UNIFORM_BUFFER, viewBuffer);
+    state->bufferData(GL_UNIFORM_BUFFER, sizeof(views), NULL, GL_DYNAMIC_DRAW);
+
+    auto makeCube = [&](unsigned int& cube, GLenum format) {
+        glGenTextures(1, &cube);
+        state->bindTexture(0, GL_TEXTURE_CUBE_MAP, cube);
+        glTexStorage2D(GL_TEXTURE_CUBE_MAP, 1, format, CAPTURE_SIZE, CAPTURE_SIZE);
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+    };
+    makeCube(captureColor, GL_RGBA8);
+    makeCube(captureDepth, GL_DEPTH_COMPONENT32F);
+
+    // Whole cubes attached as a layered target (layer = face)
+    glGenFramebuffers(1, &captureFbo);
+    state->bindFramebuffer(GL_FRAMEBUFFER, captureFbo);
+    glFramebufferTexture(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, captureColor, 0);
+    glFramebufferTexture(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, captureDepth, 0);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        std::cout << "ERROR::MULTIVIEW::FRAMEBUFFER_INCOMPLETE" << std::endl;
+
+    glGenFramebuffers(1, &previewFbo);
+    state->bindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+// View block size + binding point
+std::vector<std::string> MultiView::defines() {
+    return {
+        "MULTIVIEW",
+        "MULTIVIEW_MAX_VIEWS " + std::to_string(MAX_VIEWS),
+        "MULTIVIEW_BINDING " + std::to_string(VIEWS_BINDING)
+    };
+}
+
+// Fill the view block and viewport array for this frame
+void MultiView::setup(MultiViewMode m, Camera& camera, int width, int height,
+                      const glm::vec3& sceneCenter, float sceneRadius) {
+    mode = m;
+    outputWidth = std::max(width, 1);
+    outputHeight = std::max(height, 1);
+    float w = (float)outputWidth;
+    float h = (float)outputHeight;
+
+    bool reversed = state->reversedDepth();
+    auto setView = [&](int i, const glm::mat4& projection, const glm::vec3& eye, const glm::vec3& target,
+                       const glm::vec3& up, const glm::vec4& viewport) {
+        views[i].viewProjection = projection * glm::lookAt(eye, target, up);
+        views[i].eye = glm::vec4(eye, 1.0f);
+        viewports[i] = viewport;
+    };
+
+    if (mode == MULTIVIEW_STEREO) {
+        // Parallel eyes either side of the camera, half the width each
+        count = 2;
+        glm::mat4 projection = infiniteProjection(glm::radians(FOV), (w * 0.5f) / h, NEAR_PLANE, reversed);
+        for (int eye = 0; eye < 2; ++eye) {
+            glm::vec3 offset = camera.Right * eyeSeparation * (eye == 0 ? -0.5f : 0.5f);
+            glm::vec3 position = camera.Position + offset;
+            setView(eye, projection, position, position + camera.Front, camera.Up,
+                    glm::vec4(eye * w * 0.5f, 0.0f, w * 0.5f, h));
+        }
+    } else if (mode == MULTIVIEW_SPLIT) {
+        // Camera top-left; top / front / side views of the scene in the other quadrants
+        count = 4;
+        float qw = w * 0.5f, qh = h * 0.5f;
+        float radius = std::max(sceneRadius, 1.0f);
+        float distance = radius / std::sin(glm::radians(FOV) * 0.5f);
+        glm::mat4 cameraProjection = infiniteProjection(glm::radians(FOV), qw / qh, NEAR_PLANE, reversed);
+        glm::mat4 monitorProjection = perspectiveProjection(glm::radians(FOV), qw / qh, NEAR_PLANE,
+                                                               std::max(FAR_PLANE, distance + 2.0f * radius), reversed);
+        setView(0, cameraProjection, camera.Position, camera.Position + camera.Front, camera.Up,
+                glm::vec4(0.0f, qh, qw, qh));
+        setView(1, monitorProjection, sceneCenter + glm::vec3(0.0f, distance, 0.0f), sceneCenter,
+                glm::vec3(0.0f, 0.0f, -1.0f), glm::vec4(qw, qh, qw, qh));
+        setView(2, monitorProjection, sceneCenter + glm::vec3(0.0f, 0.0f, distance), sceneCenter,
+                glm::vec3(0.0f, 1.0f, 0.0f), glm::vec4(0.0f, 0.0f, qw, qh));
+        setView(3, monitorProjection, sceneCenter + glm::vec3(distance, 0.0f, 0.0f), sceneCenter,
+                glm::vec3(0.0f, 1.0f, 0.0f), glm::vec4(qw, 0.0f, qw, qh));
+    } else {
+        // GL cube face order: +X, -X, +Y, -Y, +Z, -Z (same frames as the shadow cube)
+        static const glm::vec3 dirs[6] = {
+            { 1, 0, 0}, {-1, 0, 0}, {0,  1, 0}, {0, -1, 0}, {0, 0,  1}, {0, 0, -1}
+        };
+        static const glm::vec3 ups[6] = {
+            {0, -1, 0}, {0, -1, 0}, {0, 0,  1}, {0, 0, -1}, {0, -1, 0}, {0, -1, 0}
+        };
+        count = 6;
+        glm::mat4 projection = infiniteProjection(glm::radians(90.0f), 1.0f, NEAR_PLANE, reversed);
+        for (int face = 0; face < 6; ++face)
+            setView(face, projection, camera.Position, camera.Position + dirs[face], ups[face],
+                    glm::vec4(0.0f, 0.0f, (float)CAPTURE_SIZE, (float)CAPTURE_SIZE));
+    }
+
+    state->bindBuffer(GL_UNIFORM_BUFFER, viewBuffer);
+    state->bufferSubData(GL_UNIFORM_BUFFER, 0, count * sizeof(ViewData), views);
+}
+
+// The window was cleared at the start of the frame; the capture cube is cleared here
+void MultiView::begin() {
+    state->bindFramebuffer(GL_FRAMEBUFFER, mode == MULTIVIEW_CUBEMAP ? captureFbo : 0);
+    glViewportArrayv(0, count, &viewports[0].x);
+    state->bindBufferBase(GL_UNIFORM_BUFFER, VIEWS_BINDING, viewBuffer);
+
+    state->setDepthTest(true);
+    state->setDepthWrite(true);
+    state->setDepthFunc(GL_LESS);
+    if (mode == MULTIVIEW_CUBEMAP) glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+}
+
+// The six faces in a 3 x 2 grid, each turned upright (cube faces are stored
+// with -Y up)
+void MultiView::end() {
+    if (mode == MULTIVIEW_CUBEMAP) {
+        int tile = std::min(outputWidth / 3, outputHeight / 2);
+        state->bindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+        state->bindFramebuffer(GL_READ_FRAMEBUFFER, previewFbo);
+        for (int face = 0; face < 6; ++face) {
+            glFramebufferTextureLayer(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, captureColor, 0, face);
+            int x = (face % 3) * tile;
+            int y = outputHeight - (face / 3 + 1) * tile;
+            glBlitFramebuffer(0, 0, CAPTURE_SIZE, CAPTURE_SIZE, x + tile, y + tile, x, y,
+                              GL_COLOR_BUFFER_BIT, GL_LINEAR);
+        }
+        state->bindFramebuffer(GL_FRAMEBUFFER, 0);
+    }
+    glViewport(0, 0, outputWidth, outputHeight);    // Sets every viewport of the array
+}
+
+int MultiView::viewCount() const {
+    return count;
+}
+
+unsigned int MultiView::captureMap() const {
+    return captureColor;
+}
+
+// Release GL objects
+void MultiView::terminate() {
+    state->invalidate();    // deleted names may be reused
+    glDeleteBuffers(1, &viewBuffer);
+    unsigned int textures[2] = {captureColor, captureDepth};
+    glDeleteTextures(2, textures);
+    unsigned int framebuffers[2] = {captureFbo, previewFbo};
+    glDeleteFramebuffers(2, framebuffers);
+    viewBuffer = captureColor = captureDepth = captureFbo = previewFbo = 0;
+}
@@ -0,0 +1,95 @@
+#include "Renderer/occluders.h"
+#include "config.h"
+#include "settings.h"
+
+#include <algorithm>
+
+// Create the tile buffers and the gather program
+void SphereOccluders::init(ShaderVariants& shaders, GLState& glState) {
+    state = &glState;
+    gatherShader = &shaders.getCompute(OCCLUDER_GATHER_CSHADER_PATH, defines(), true);
+
+    const size_t tiles = TILES_X * TILES_Y;
+
+    glGenBuffers(1, &occluderBuffer);
+    glGenBuffers(1, &countBuffer);
+    glGenBuffers(1, &indexBuffer);
+
+    state->bindBuffer(GL_SHADER_STORAGE_BUFFER, countBuffer);
+    state->bufferData(GL_SHADER_STORAGE_BUFFER, tiles * sizeof(unsigned int), NULL, GL_DYNAMIC_COPY);
+    state->bindBuffer(GL_SHADER_STORAGE_BUFFER, indexBuffer);
+    state->bufferData(GL_SHADER_STORAGE_BUFFER, tiles * MAX_PER_TILE * sizeof(unsigned int), NULL, GL_DYNAMIC_COPY);
+}
+
+// Tile layout + binding points, injected into every program that reads the lists
+std::vector<std::string> SphereOccluders::defines() {
+    return {
+        "SPHERE_OCCLUSION",
+        "OCCLUDER_TILES_X " + std::to_string(TILES_X) + "u",
+        "OCCLUDER_TILES_Y " + std::to_string(TILES_Y) + "u",
+        "MAX_OCCLUDERS_PER_TILE " + std::to_string(MAX_PER_TILE) + "u",
+        "OCCLUDERS_BINDING " + std::to_string(OCCLUDERS_BINDING),
+        "OCCLUDER_COUNT_BINDING " + std::to_string(COUNT_BINDING),
+        "OCCLUDER_INDICES_BINDING " + std::to_string(INDICES_BINDING)
+    };
+}
+
+// Upload occluders and gather them per tile (one invocation per tile)
+void SphereOccluders::update(const std::vector<glm::vec4>& occluders,
+                             const glm::vec4& light, float radius,
+                             const glm::mat4& view, const glm::mat4& projection,
+                             int screenWidth, int screenHeight) {
+    count = (unsigned int)occluders.size();
+    lightRadius = radius;
+    screenSize = glm::vec2(screenWidth, screenHeight);
+
+    // Grow the occluder buffer (doubling, never empty)
+    if (count > capacity || capacity == 0) {
+        capacity = std::max<size_t>(std::max<size_t>(count, capacity * 2), 1);
+        state->bindBuffer(GL_SHADER_STORAGE_BUFFER, occluderBuffer);
+        state->bufferData(GL_SHADER_STORAGE_BUFFER, capacity * sizeof(glm::vec4), NULL, GL_DYNAMIC_DRAW);
+    }
+    if (count) {
+        state->bindBuffer(GL_SHADER_STORAGE_BUFFER, occluderBuffer);
+        state->bufferSubData(GL_SHADER_STORAGE_BUFFER, 0, count * sizeof(glm::vec4), occluders.data());
+    }
+
+    state->bindBufferBase(GL_SHADER_STORAGE_BUFFER, OCCLUDERS_BINDING, occluderBuffer);
+    state->bindBufferBase(GL_SHADER_STORAGE_BUFFER, COUNT_BINDING, countBuffer);
+    state->bindBufferBase(GL_SHADER_STORAGE_BUFFER, INDICES_BINDING, indexBuffer);
+
+    gatherShader->use();
+    gatherShader->setMat4("view", view);
+    gatherShader->setMat4("inverseProjection", glm::inverse(projection));
+    gatherShader->setVec4("light", light);
+    gatherShader->setFloat("lightRadius", radius);
+    gatherShader->setFloat("aoReach", aoReach);
+    gatherShader->setFloat("zNear", NEAR_PLANE);
+    gatherShader->setUint("occluderCount", count);
+
+    state->dispatchCompute((TILES_X * TILES_Y + 63) / 64, 1, 1);
+
+    // Lists are read by fragment shaders next
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+}
+
+// Bind the tile lists and the lookup uniforms for shading
+void SphereOccluders::bind(Shader& shader) {
+    state->bindBufferBase(GL_SHADER_STORAGE_BUFFER, OCCLUDERS_BINDING, occluderBuffer);
+    state->bindBufferBase(GL_SHADER_STORAGE_BUFFER, COUNT_BINDING, countBuffer);
+    state->bindBufferBase(GL_SHADER_STORAGE_BUFFER, INDICES_BINDING, indexBuffer);
+    shader.setVec2("occluderScreenSize", screenSize);
+    shader.setFloat("aoReach", aoReach);
+    shader.setFloat("occlusionLightRadius", lightRadius);
+}
+
+unsigned int SphereOccluders::occluderCount() const {
+    return count;
+}
+
+// Release GL objects
+void SphereOccluders::terminate() {
+    glDeleteBuffers(1, &occluderBuffer);
+    glDeleteBuffers(1, &countBuffer);
+    glDeleteBuffers(1, &indexBuffer);
+}
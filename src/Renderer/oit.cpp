@@ -0,0 +1,110 @@
+#include "Renderer/oit.h"
+#include "config.h"
+
+#include <algorithm>
+
+// Build the translucent / composite programs
+void WeightedOIT::init(ShaderVariants& shaders, GLState& glState,
+                       const std::vector<std::string>& clusteredDefines) {
+    state = &glState;
+
+    translucentShader = &shaders.get(VSHADER_PATH, TRANSLUCENT_FSHADER_PATH, {}, true);
+    translucentClusteredShader = &shaders.get(VSHADER_PATH, TRANSLUCENT_FSHADER_PATH, clusteredDefines, true);
+    compositeShader = &shaders.get(FULLSCREEN_VSHADER_PATH, OIT_COMPOSITE_FSHADER_PATH, {}, true);
+
+    glGenVertexArrays(1, &fullscreenVAO);
+}
+
+// Set the render size; targets are only recreated when they must grow
+void WeightedOIT::resize(int w, int h) {
+    width = w;
+    height = h;
+    if (w <= allocWidth && h <= allocHeight) return;
+    releaseTargets();
+    allocWidth = std::max(w, allocWidth);
+    allocHeight = std::max(h, allocHeight);
+
+    auto makeTexture = [&](unsigned int& tex, GLenum format) {
+        glGenTextures(1, &tex);
+        state->bindTexture(0, GL_TEXTURE_2D, tex);
+        glTexStorage2D(GL_TEXTURE_2D, 1, format, allocWidth, allocHeight);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    };
+    makeTexture(accumTexture, GL_RGBA16F);
+    makeTexture(revealageTexture, GL_R8);
+    makeTexture(depthStencil, state->depthStencilFormat());
+
+    glGenFramebuffers(1, &fbo);
+    state->bindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, accumTexture, 0);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, revealageTexture, 0);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_TEXTURE_2D, depthStencil, 0);
+    GLenum attachments[2] = {GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1};
+    glDrawBuffers(2, attachments);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        std::cout << "ERROR::OIT::FRAMEBUFFER_INCOMPLETE" << std::endl;
+    state->bindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+// Opaque depth in, targets cleared (accum 0, revealage 1), blending per target
+Shader& WeightedOIT::begin(unsigned int scene, bool clustered) {
+    state->bindFramebuffer(GL_READ_FRAMEBUFFER, scene);
+    state->bindFramebuffer(GL_DRAW_FRAMEBUFFER, fbo);
+    glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+    state->bindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glViewport(0, 0, width, height);
+
+    const float zero[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    const float one[4]  = {1.0f, 1.0f, 1.0f, 1.0f};
+    glClearBufferfv(GL_COLOR, 0, zero);
+    glClearBufferfv(GL_COLOR, 1, one);
+
+    state->setDepthTest(true);
+    state->setDepthFunc(GL_LESS);
+    state->setDepthWrite(false);
+    state->setCull(false);
+    state->setBlend(true);
+    state->setBlendFunci(0, GL_ONE, GL_ONE);
+    state->setBlendFunci(1, GL_ZERO, GL_ONE_MINUS_SRC_COLOR);
+
+    Shader& shader = clustered ? *translucentClusteredShader : *translucentShader;
+    shader.use();
+    return shader;
+}
+
+// Weighted average over the scene, covering 1 - revealage
+void WeightedOIT::composite(unsigned int scene) {
+    state->bindFramebuffer(GL_FRAMEBUFFER, scene);
+    state->setDepthTest(false);
+    state->setBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    compositeShader->use();
+    state->bindTexture(0, GL_TEXTURE_2D, accumTexture);
+    state->bindTexture(1, GL_TEXTURE_2D, revealageTexture);
+    compositeShader->setInt("accumTexture", 0);
+    compositeShader->setInt("revealageTexture", 1);
+    state->bindVertexArray(fullscreenVAO);
+    state->drawArrays(GL_TRIANGLES, 0, 3);
+
+    // Back to the renderer's defaults
+    state->setBlend(false);
+    state->setDepthTest(true);
+    state->setDepthWrite(true);
+}
+
+// Delete screen-sized targets
+void WeightedOIT::releaseTargets() {
+    if (!fbo) return;
+    state->invalidate();    // deleted names may be reused
+    glDeleteFramebuffers(1, &fbo);
+    unsigned int textures[3] = {accumTexture, revealageTexture, depthStencil};
+    glDeleteTextures(3, textures);
+    fbo = 0;
+}
+
+// Release GL objects
+void WeightedOIT::terminate() {
+    releaseTargets();
+    glDeleteVertexArrays(1, &fullscreenVAO);
+}
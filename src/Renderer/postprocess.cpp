@@ -0,0 +1,192 @@
+#include "Renderer/postprocess.h"
+#include "config.h"
+
+#include <algorithm>
+#include <iostream>
+
+// Programs and timers; targets are created on the first resize()
+void PostProcess::init(ShaderVariants& shaders, GLState& glState) {
+    state = &glState;
+    downsampleShader = &shaders.getCompute(BLOOM_DOWNSAMPLE_CSHADER_PATH, {}, true);
+    upsampleShader = &shaders.getCompute(BLOOM_UPSAMPLE_CSHADER_PATH, {}, true);
+    compositeShader = &shaders.getCompute(TONEMAP_CSHADER_PATH, {}, true);
+
+    downsampleTimer.init(GL_TIME_ELAPSED);
+    upsampleTimer.init(GL_TIME_ELAPSED);
+    compositeTimer.init(GL_TIME_ELAPSED);
+}
+
+// Render area for this frame; the targets only ever grow
+void PostProcess::resize(int outW, int outH, int renderW, int renderH) {
+    outputWidth = std::max(outW, 1);
+    outputHeight = std::max(outH, 1);
+    width = std::max(renderW, 1);
+    height = std::max(renderH, 1);
+
+    if (outputWidth > allocWidth || outputHeight > allocHeight)
+        allocate(std::max(outputWidth, allocWidth), std::max(outputHeight, allocHeight));
+}
+
+// (Re)create the scene target, both bloom chains and the LDR image
+void PostProcess::allocate(int w, int h) {
+    releaseTargets();
+    allocWidth = w = std::max(w, 2 << LEVELS);      // Room for every bloom mip
+    allocHeight = h = std::max(h, 2 << LEVELS);
+
+    auto makeTexture = [&](unsigned int& tex, GLenum format, int levels, int tw, int th) {
+        glGenTextures(1, &tex);
+        state->bindTexture(0, GL_TEXTURE_2D, tex);
+        glTexStorage2D(GL_TEXTURE_2D, levels, format, tw, th);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, levels > 1 ? GL_LINEAR_MIPMAP_NEAREST : GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    };
+    makeTexture(sceneTexture, GL_RGBA16F, 1, w, h);
+    makeTexture(bloomDown, GL_R11F_G11F_B10F, LEVELS, std::max(w / 2, 1), std::max(h / 2, 1));
+    makeTexture(bloomUp, GL_R11F_G11F_B10F, LEVELS, std::max(w / 2, 1), std::max(h / 2, 1));
+    makeTexture(ldrTexture, GL_RGBA8, 1, w, h);
+
+    glGenRenderbuffers(1, &depthStencil);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthStencil);
+    glRenderbufferStorage(GL_RENDERBUFFER, state->depthStencilFormat(), w, h);
+
+    glGenFramebuffers(1, &fbo);
+    state->bindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, sceneTexture, 0);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depthStencil);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        std::cout << "ERROR::POSTPROCESS::FRAMEBUFFER_INCOMPLETE" << std::endl;
+
+    glGenFramebuffers(1, &ldrFbo);
+    state->bindFramebuffer(GL_FRAMEBUFFER, ldrFbo);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, ldrTexture, 0);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        std::cout << "ERROR::POSTPROCESS::LDR_FRAMEBUFFER_INCOMPLETE" << std::endl;
+    state->bindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+unsigned int PostProcess::framebuffer() const {
+    return fbo;
+}
+
+// Downsample chain, upsample chain, fused composite, then the blit to the window
+void PostProcess::run() {
+    int halfW = std::max(allocWidth / 2, 1), halfH = std::max(allocHeight / 2, 1);
+    auto levelSize = [](int size, int level) { return std::max(size >> level, 1); };
+    auto groups = [](int size) { return (unsigned int)(size + 7) / 8; };
+
+    // Source level `lod` of `tex`: allocated texel size + used area in texels
+    auto setSource = [&](Shader& shader, const char* sampler, int unit, unsigned int tex, int lod,
+                         int allocW, int allocH, int usedW, int usedH) {
+        state->bindTexture(unit, GL_TEXTURE_2D, tex);
+        std::string name(sampler);
+        shader.setInt(sampler, unit);
+        shader.setFloat((name + "Lod").c_str(), (float)lod);
+        shader.setVec2((name + "Texel").c_str(), glm::vec2(1.0f / allocW, 1.0f / allocH));
+        shader.setVec2((name + "Size").c_str(), glm::vec2(usedW, usedH));
+    };
+
+    // Bright pass + downsample: scene -> level 0, level i - 1 -> level i
+    downsampleTimer.begin();
+    downsampleShader->use();
+    downsampleShader->setFloat("threshold", bloomThreshold);
+    downsampleShader->setFloat("knee", bloomKnee);
+    for (int level = 0; level < LEVELS; ++level) {
+        int dstW = levelSize(width / 2, level), dstH = levelSize(height / 2, level);
+        if (level == 0)
+            setSource(*downsampleShader, "source", 0, sceneTexture, 0, allocWidth, allocHeight, width, height);
+        else
+            setSource(*downsampleShader, "source", 0, bloomDown, level - 1,
+                      levelSize(halfW, level - 1), levelSize(halfH, level - 1),
+                      levelSize(width / 2, level - 1), levelSize(height / 2, level - 1));
+        downsampleShader->setInt("prefilter", level == 0 ? 1 : 0);
+        downsampleShader->setVec2("targetSize", glm::vec2(dstW, dstH));
+        glBindImageTexture(0, bloomDown, level, GL_FALSE, 0, GL_WRITE_ONLY, GL_R11F_G11F_B10F);
+        state->dispatchCompute(groups(dstW), groups(dstH), 1);
+        glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+    }
+    downsampleTimer.end();
+
+    // Upsample: the coarser result (the last down level to start) + down level i -> up level i
+    upsampleTimer.begin();
+    upsampleShader->use();
+    for (int level = LEVELS - 2; level >= 0; --level) {
+        int dstW = levelSize(width / 2, level), dstH = levelSize(height / 2, level);
+        unsigned int coarser = level == LEVELS - 2 ? bloomDown : bloomUp;
+        setSource(*upsampleShader, "source", 0, coarser, level + 1,
+                  levelSize(halfW, level + 1), levelSize(halfH, level + 1),
+                  levelSize(width / 2, level + 1), levelSize(height / 2, level + 1));
+        setSource(*upsampleShader, "base", 1, bloomDown, level,
+                  levelSize(halfW, level), levelSize(halfH, level), dstW, dstH);
+        upsampleShader->setVec2("targetSize", glm::vec2(dstW, dstH));
+        glBindImageTexture(0, bloomUp, level, GL_FALSE, 0, GL_WRITE_ONLY, GL_R11F_G11F_B10F);
+        state->dispatchCompute(groups(dstW), groups(dstH), 1);
+        glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+    }
+    upsampleTimer.end();
+
+    // Scene + bloom -> exposure -> tonemap -> gamma, one invocation per pixel
+    compositeTimer.begin();
+    compositeShader->use();
+    setSource(*compositeShader, "scene", 0, sceneTexture, 0, allocWidth, allocHeight, width, height);
+    setSource(*compositeShader, "bloom", 1, bloomUp, 0, halfW, halfH,
+              levelSize(width / 2, 0), levelSize(height / 2, 0));
+    compositeShader->setFloat("exposure", exposure);
+    compositeShader->setFloat("bloomIntensity", bloomIntensity);
+    compositeShader->setVec2("targetSize", glm::vec2(width, height));
+    glBindImageTexture(0, ldrTexture, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA8);
+    state->dispatchCompute(groups(width), groups(height), 1);
+    glMemoryBarrier(GL_FRAMEBUFFER_BARRIER_BIT);
+
+    state->bindFramebuffer(GL_READ_FRAMEBUFFER, ldrFbo);
+    state->bindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    glBlitFramebuffer(0, 0, width, height, 0, 0, outputWidth, outputHeight,
+                      GL_COLOR_BUFFER_BIT, GL_LINEAR);
+    state->bindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(0, 0, outputWidth, outputHeight);
+    compositeTimer.end();
+
+    updateTimings();
+}
+
+// Newest finished stage times; one budget sample per complete set
+void PostProcess::updateTimings() {
+    uint64_t ns = 0;
+    bool fresh = false;
+    if (downsampleTimer.poll(ns)) {
+        timings.downsampleMs = ns / 1.0e6f;
+        fresh = true;
+    }
+    if (upsampleTimer.poll(ns)) timings.upsampleMs = ns / 1.0e6f;
+    if (compositeTimer.poll(ns)) timings.compositeMs = ns / 1.0e6f;
+
+    if (fresh) {
+        ++samples;
+        if (timings.totalMs() > budgetMs) ++misses;
+    }
+}
+
+const PostTimings& PostProcess::getTimings() const {
+    return timings;
+}
+
+// Delete the screen-sized targets
+void PostProcess::releaseTargets() {
+    if (!fbo) return;
+    state->invalidate();    // deleted names may be reused
+    unsigned int framebuffers[2] = {fbo, ldrFbo};
+    glDeleteFramebuffers(2, framebuffers);
+    unsigned int textures[4] = {sceneTexture, bloomDown, bloomUp, ldrTexture};
+    glDeleteTextures(4, textures);
+    glDeleteRenderbuffers(1, &depthStencil);
+    fbo = ldrFbo = sceneTexture = bloomDown = bloomUp = ldrTexture = depthStencil = 0;
+}
+
+// Release GL objects
+void PostProcess::terminate() {
+    releaseTargets();
+    downsampleTimer.terminate();
+    upsampleTimer.terminate();
+    compositeTimer.terminate();
+}
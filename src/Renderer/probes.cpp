@@ -0,0 +1,158 @@
+#include "Renderer/probes.h"
+#include "config.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// Create the grid texture, the bake buffers and the program
+void IrradianceProbes::init(ShaderVariants& shaders, GLState& glState) {
+    state = &glState;
+    bakeShader = &shaders.getCompute(PROBE_BAKE_CSHADER_PATH, defines(), true);
+
+    glGenTextures(1, &gridTexture);
+    state->bindTexture(0, GL_TEXTURE_3D, gridTexture);
+    glTexStorage3D(GL_TEXTURE_3D, 1, GL_RGBA16F, GRID_X, GRID_Y, GRID_Z * BLOCKS);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+
+    glGenBuffers(1, &lightBuffer);
+    glGenBuffers(1, &sphereBuffer);
+}
+
+// Grid layout + binding points
+std::vector<std::string> IrradianceProbes::defines() {
+    return {
+        "PROBES",
+        "PROBE_GRID_X " + std::to_string(GRID_X),
+        "PROBE_GRID_Y " + std::to_string(GRID_Y),
+        "PROBE_GRID_Z " + std::to_string(GRID_Z),
+        "PROBE_LIGHTS_BINDING " + std::to_string(LIGHTS_BINDING),
+        "PROBE_SPHERES_BINDING " + std::to_string(SPHERES_BINDING)
+    };
+}
+
+// Distance between neighbouring probes
+glm::vec3 IrradianceProbes::cellSize() const {
+    return (gridMax - gridMin) / glm::vec3(GRID_X - 1, GRID_Y - 1, GRID_Z - 1);
+}
+
+// Diff against the last bake and re-bake the probes the differences can reach
+void IrradianceProbes::update(const std::vector<PointLight>& lights,
+                              const std::vector<glm::vec4>& spheres,
+                              const std::vector<glm::vec3>& albedos,
+                              const glm::vec3& boundsMin, const glm::vec3& boundsMax) {
+    std::vector<ProbeSphere> packed;
+    packed.reserve(spheres.size());
+    for (size_t i = 0; i < spheres.size(); ++i)
+        packed.push_back({spheres[i], glm::vec4(albedos[i], 0.0f)});
+
+    bool full = !baked || boundsMin != gridMin || boundsMax != gridMax ||
+                lights.size() != bakedLights.size() || packed.size() != bakedSpheres.size() ||
+                (!packed.empty() &&
+                 std::memcmp(packed.data(), bakedSpheres.data(), packed.size() * sizeof(ProbeSphere)) != 0);
+
+    // A light only shows up through the spheres inside its range, and those
+    // only within bounceReach of them: dirty the union of their reach boxes
+    glm::vec3 dirtyMin(1e30f), dirtyMax(-1e30f);
+    if (!full) {
+        for (size_t l = 0; l < lights.size(); ++l) {
+            if (std::memcmp(&lights[l], &bakedLights[l], sizeof(PointLight)) == 0) continue;
+            for (const ProbeSphere& s : packed) {
+                glm::vec3 c(s.bounds);
+                float reach = s.bounds.w;
+                bool inOld = glm::length(c - glm::vec3(bakedLights[l].positionRange)) < bakedLights[l].positionRange.w + reach;
+                bool inNew = glm::length(c - glm::vec3(lights[l].positionRange)) < lights[l].positionRange.w + reach;
+                if (!inOld && !inNew) continue;
+                dirtyMin = glm::min(dirtyMin, c - glm::vec3(reach * bounceReach));
+                dirtyMax = glm::max(dirtyMax, c + glm::vec3(reach * bounceReach));
+            }
+        }
+    }
+
+    gridMin = boundsMin;
+    gridMax = boundsMax;
+    bakedLights = lights;
+    bakedSpheres = packed;
+    baked = true;
+    lastBaked = 0;
+
+    // Upload this frame's lights + spheres (grow by doubling, never empty)
+    auto upload = [&](unsigned int buffer, size_t& capacity, const void* data, size_t count, size_t stride) {
+        state->bindBuffer(GL_SHADER_STORAGE_BUFFER, buffer);
+        if (count > capacity || capacity == 0) {
+            capacity = std::max<size_t>(std::max<size_t>(count, capacity * 2), 1);
+            state->bufferData(GL_SHADER_STORAGE_BUFFER, capacity * stride, NULL, GL_DYNAMIC_DRAW);
+        }
+        if (count) state->bufferSubData(GL_SHADER_STORAGE_BUFFER, 0, count * stride, data);
+    };
+
+    glm::ivec3 first(0);
+    glm::ivec3 last(GRID_X - 1, GRID_Y - 1, GRID_Z - 1);
+    if (full) {
+        ++fullCount;
+    } else {
+        if (dirtyMin.x > dirtyMax.x) return;       // Nothing reachable changed
+        glm::vec3 cell = cellSize();
+        glm::ivec3 lo = glm::ivec3(glm::floor((dirtyMin - gridMin) / cell));
+        glm::ivec3 hi = glm::ivec3(glm::ceil((dirtyMax - gridMin) / cell));
+        if (glm::any(glm::lessThan(hi, first)) || glm::any(glm::greaterThan(lo, last))) return;
+        first = glm::max(lo, first);
+        last = glm::min(hi, last);
+    }
+
+    upload(lightBuffer, lightCapacity, lights.data(), lights.size(), sizeof(PointLight));
+    upload(sphereBuffer, sphereCapacity, packed.data(), packed.size(), sizeof(ProbeSphere));
+    bake(first, last);
+}
+
+// One invocation per probe in [first, last]
+void IrradianceProbes::bake(const glm::ivec3& first, const glm::ivec3& last) {
+    glm::ivec3 size = last - first + 1;
+
+    bakeShader->use();
+    bakeShader->setVec3("gridMin", gridMin);
+    bakeShader->setVec3("cellSize", cellSize());
+    bakeShader->setVec3("regionFirst", glm::vec3(first));
+    bakeShader->setVec3("regionSize", glm::vec3(size));
+    bakeShader->setUint("lightCount", (unsigned int)bakedLights.size());
+    bakeShader->setUint("sphereCount", (unsigned int)bakedSpheres.size());
+    bakeShader->setFloat("ambient", ambient);
+    bakeShader->setFloat("bounceReach", bounceReach);
+
+    state->bindBufferBase(GL_SHADER_STORAGE_BUFFER, LIGHTS_BINDING, lightBuffer);
+    state->bindBufferBase(GL_SHADER_STORAGE_BUFFER, SPHERES_BINDING, sphereBuffer);
+    glBindImageTexture(0, gridTexture, 0, GL_TRUE, 0, GL_WRITE_ONLY, GL_RGBA16F);
+
+    state->dispatchCompute((size.x + 3) / 4, (size.y + 3) / 4, (size.z + 3) / 4);
+    glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+    lastBaked = (unsigned int)(size.x * size.y * size.z);
+}
+
+// Bind the grid for a program built with defines()
+void IrradianceProbes::bind(Shader& shader, unsigned int unit) const {
+    state->bindTexture(unit, GL_TEXTURE_3D, gridTexture);
+    shader.setInt("probeGrid", (int)unit);
+    shader.setVec3("probeGridMin", gridMin);
+    shader.setVec3("probeCellSize", cellSize());
+}
+
+unsigned int IrradianceProbes::bakedProbes() const {
+    return lastBaked;
+}
+
+unsigned int IrradianceProbes::fullBakes() const {
+    return fullCount;
+}
+
+// Release GL objects
+void IrradianceProbes::terminate() {
+    state->invalidate();    // deleted names may be reused
+    glDeleteTextures(1, &gridTexture);
+    glDeleteBuffers(1, &lightBuffer);
+    glDeleteBuffers(1, &sphereBuffer);
+    gridTexture = lightBuffer = sphereBuffer = 0;
+}
@@ -0,0 +1,148 @@
+#include "Renderer/programcache.h"
+
+#include <GLFW/glfw3.h>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+
+// On-disk entry header (followed by `length` bytes of driver binary)
+struct CacheHeader {
+    uint32_t magic;         // 'SPBC'
+    uint32_t version;       // File layout version
+    uint64_t driverHash;    // Driver identity the binary was produced by
+    uint64_t key;           // Source + driver key (guards against hash-named collisions)
+    uint32_t format;        // GL binary format enum
+    uint32_t length;        // Binary size in bytes
+};
+
+static const uint32_t CACHE_MAGIC   = 0x43425053; // "SPBC"
+static const uint32_t CACHE_VERSION = 1;
+
+// Read driver identity, binary format count and parallel compile support
+void ProgramCache::init(const char* dir) {
+    directory = dir;
+
+    const char* vendor   = (const char*)glGetString(GL_VENDOR);
+    const char* renderer = (const char*)glGetString(GL_RENDERER);
+    const char* version  = (const char*)glGetString(GL_VERSION);
+    driverId = std::string(vendor ? vendor : "") + "|" +
+               (renderer ? renderer : "") + "|" +
+               (version ? version : "");
+    driverHash = hash(driverId.data(), driverId.size(), 0);
+
+    int formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    enabled = formats > 0;
+
+    // Let the driver compile on its own threads when it can
+    PFNGLMAXSHADERCOMPILERTHREADSKHRPROC maxThreads = nullptr;
+    if (glfwExtensionSupported("GL_KHR_parallel_shader_compile"))
+        maxThreads = (PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)glfwGetProcAddress("glMaxShaderCompilerThreadsKHR");
+    else if (glfwExtensionSupported("GL_ARB_parallel_shader_compile"))
+        maxThreads = (PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)glfwGetProcAddress("glMaxShaderCompilerThreadsARB");
+    if (maxThreads) {
+        maxThreads(0xFFFFFFFFu); // implementation-chosen thread count
+        parallel = true;
+    }
+
+    if (!enabled) {
+        std::cout << "INFO::PROGRAM_CACHE::NO_BINARY_FORMATS (cache disabled)" << std::endl;
+    }
+}
+
+bool ProgramCache::isEnabled() const {
+    return enabled;
+}
+
+bool ProgramCache::hasParallelCompile() const {
+    return parallel;
+}
+
+// Hash every source (length-prefixed so boundaries matter) on top of the driver hash
+uint64_t ProgramCache::makeKey(const std::vector<std::string>& sources) const {
+    uint64_t key = driverHash;
+    for (const std::string& src : sources) {
+        uint64_t len = src.size();
+        key = hash(&len, sizeof(len), key);
+        key = hash(src.data(), src.size(), key);
+    }
+    return key;
+}
+
+// Restore a program from disk; any mismatch or driver rejection counts as a miss
+bool ProgramCache::load(uint64_t key, unsigned int program) {
+    if (!enabled) return false;
+
+    std::ifstream file(entryPath(key), std::ios::binary);
+    if (!file) return false;
+
+    CacheHeader header{};
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!file || header.magic != CACHE_MAGIC || header.version != CACHE_VERSION ||
+        header.driverHash != driverHash || header.key != key || header.length == 0) {
+        return false;
+    }
+
+    std::vector<char> binary(header.length);
+    file.read(binary.data(), binary.size());
+    if (!file) return false;
+
+    glProgramBinary(program, header.format, binary.data(), (GLsizei)binary.size());
+
+    // Drivers may reject binaries after updates even with the same strings
+    int success = 0;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success) {
+        std::cout << "INFO::PROGRAM_CACHE::BINARY_REJECTED (recompiling)" << std::endl;
+        return false;
+    }
+
+    ++hits;
+    return true;
+}
+
+// Write the linked program binary next to the other cache entries
+void ProgramCache::store(uint64_t key, unsigned int program) {
+    if (!enabled) return;
+
+    int length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) return;
+
+    std::vector<char> binary(length);
+    GLenum format = 0;
+    glGetProgramBinary(program, length, NULL, &format, binary.data());
+
+    std::error_code ec;
+    std::filesystem::create_directories(directory, ec);
+
+    std::ofstream file(entryPath(key), std::ios::binary | std::ios::trunc);
+    if (!file) {
+        std::cout << "ERROR::PROGRAM_CACHE::NOT_WRITABLE " << directory << std::endl;
+        return;
+    }
+
+    CacheHeader header{CACHE_MAGIC, CACHE_VERSION, driverHash, key, format, (uint32_t)length};
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(binary.data(), binary.size());
+}
+
+// <dir>/<16 hex digits>.bin
+std::string ProgramCache::entryPath(uint64_t key) const {
+    std::ostringstream oss;
+    oss << directory << "/" << std::hex << std::setw(16) << std::setfill('0') << key << ".bin";
+    return oss.str();
+}
+
+// FNV-1a 64-bit, chained through `seed`
+uint64_t ProgramCache::hash(const void* data, size_t size, uint64_t seed) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    uint64_t h = seed ? seed : 0xcbf29ce484222325ull;
+    for (size_t i = 0; i < size; ++i) {
+        h ^= bytes[i];
+        h *= 0x100000001b3ull;
+    }
+    return h;
+}
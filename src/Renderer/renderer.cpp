@@ -1,5 +1,12 @@
 #include "Renderer/renderer.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+// Scale applied to the light marker sphere
+static const float LIGHT_MARKER_SCALE = 0.35f;
+
 // Constructor: set initial camera position and timing values
 Renderer::Renderer() 
     : camera(glm::vec3(0.0f, 0.0f, 3.0f)),
@@ -12,18 +19,356 @@ void Renderer::init() {
     createGlfwWindow(SCR_WIDTH, SCR_HEIGHT, APP_NAME);
     loadGLAD();
     glViewport(0, 0, SCR_WIDTH, SCR_HEIGHT);
-    glEnable(GL_DEPTH_TEST);               // depth testing for correct occlusion
+    glState.setDepthTest(true);            // depth testing for correct occlusion
+    glState.enableReversedDepth();         // reversed-Z where glClipControl exists (before any shader or depth target)
+
+    // Load main shader program: restored from the binary cache when possible,
+    // otherwise compiled asynchronously so the window comes up immediately
+    programCache.init(SHADER_CACHE_DIR);
+    shaderVariants.setCache(&programCache);
+    shaderVariants.setState(&glState);
+    loadShaderVariants();
+
+    prepassQuery.init(GL_SAMPLES_PASSED);
+    shadedQuery.init(GL_SAMPLES_PASSED);
+
+    hiz.init(SCR_WIDTH, SCR_HEIGHT, shaderVariants, glState);
+    softCull.init();
+    transforms.init();
+    clusters.init(shaderVariants, glState);
+    deferred.init(shaderVariants, glState);
+    visibility.init(shaderVariants, glState, ClusteredLights::defines());
+    shadowMap.init(shaderVariants, glState);
+    occluders.init(shaderVariants, glState);
+    resolution.init(glState);
+    oit.init(shaderVariants, glState, ClusteredLights::defines());
+    primitives.init(shaderVariants, glState);
+    atmosphere.init(shaderVariants, glState);
+    probes.init(shaderVariants, glState);
+    multiView.init(glState);
+    post.init(shaderVariants, glState);
+    virtualTexture.init(VIRTUAL_TEXTURE_PATH, shaderVariants, glState);
+
+    forwardTimer.init(GL_TIME_ELAPSED);
+    deferredTimer.init(GL_TIME_ELAPSED);
+    visibilityTimer.init(GL_TIME_ELAPSED);
+}
+
+// Build the specialised program for each sphere variant (async)
+void Renderer::loadShaderVariants() {
+    for (int clustered = 0; clustered < 2; ++clustered) {
+        for (int probed = 0; probed < 2; ++probed) {
+            std::vector<std::string> defines;
+            if (clustered) defines = ClusteredLights::defines();
+            if (probed)
+                for (const std::string& define : IrradianceProbes::defines()) defines.push_back(define);
+            Shader** lit = litShaders[clustered][probed];
+            lit[SHADOW_NONE] = &shaderVariants.get(VSHADER_PATH, FSHADER_PATH, defines, true);
+
+            std::vector<std::string> mapped = defines;
+            mapped.push_back("SHADOWS");
+            lit[SHADOW_MAP] = &shaderVariants.get(VSHADER_PATH, FSHADER_PATH, mapped, true);
+
+            std::vector<std::string> analytic = defines;
+            for (const std::string& define : SphereOccluders::defines()) analytic.push_back(define);
+            lit[SHADOW_ANALYTIC] = &shaderVariants.get(VSHADER_PATH, FSHADER_PATH, analytic, true);
+        }
+    }
+    buckets[VARIANT_EMISSIVE].shader = &shaderVariants.get(VSHADER_PATH, FSHADER_PATH, {"EMISSIVE"}, true);
+    atmosphereShaders[0] = &shaderVariants.get(VSHADER_PATH, FSHADER_PATH, {"ATMOSPHERE"}, true);
+    std::vector<std::string> textured = VirtualTexture::defines();
+    textured.push_back("ATMOSPHERE");
+    atmosphereShaders[1] = &shaderVariants.get(VSHADER_PATH, FSHADER_PATH, textured, true);
+    depthShader = &shaderVariants.get(VSHADER_PATH, DEPTH_FSHADER_PATH, {"DEPTH_ONLY"}, true);
+
+    std::vector<std::string> multi = MultiView::defines();
+    multiViewLit[0] = &shaderVariants.getWithGeometry(MULTIVIEW_VSHADER_PATH, MULTIVIEW_GSHADER_PATH, FSHADER_PATH, multi, true);
+    multi.push_back("SHADOWS");
+    multiViewLit[1] = &shaderVariants.getWithGeometry(MULTIVIEW_VSHADER_PATH, MULTIVIEW_GSHADER_PATH, FSHADER_PATH, multi, true);
+    multi.back() = "EMISSIVE";
+    multiViewEmissive = &shaderVariants.getWithGeometry(MULTIVIEW_VSHADER_PATH, MULTIVIEW_GSHADER_PATH, FSHADER_PATH, multi, true);
+    gbufferShader = &shaderVariants.get(VSHADER_PATH, FSHADER_PATH, {"GBUFFER"}, true);
+}
 
-    // Load (compile/link) main shader program
-    ourShader.load(VSHADER_PATH, FSHADER_PATH);
+// Register a sphere for rendering: a copy joins the sphere pool, its render
+// properties become a new entity row and its position a transform node
+// (world matrices follow in the next update)
+EntityHandle Renderer::drawSphere(const Sphere& description, const glm::dvec3& position, EntityHandle parent) {
+    EntityHandle handle = addSphere(spheres.create(description), position, parent);
+    setupSphereVertexBuffer(entities.row(handle));
+    return handle;
 }
 
-// Register a sphere for rendering (lazy mesh upload / reuse)
-void Renderer::drawSphere(Sphere& sphere, glm::vec3 position) {
-    sphere.Position = position;
-    setupSphereVertexBuffer(sphere);       // uploads only if VAO==0 or remake==true
-    spheres.push_back(&sphere);
-    if (sphere.source) lightSphere = &sphere; // remember light source sphere
+// Entity row + transform node for a pooled sphere; its mesh is looked up or
+// uploaded by the next bucketSpheres() (ENTITY_REMESH)
+EntityHandle Renderer::addSphere(PoolHandle<Sphere> cold, const glm::dvec3& position, EntityHandle parent) {
+    const Sphere& sphere = *spheres.get(cold);
+    EntityHandle handle = entities.create(cold);
+    uint32_t row = entities.row(handle);
+    uint32_t parentNode = entities.alive(parent) ? entities.transform[entities.row(parent)] : TransformHierarchy::NONE;
+    uint32_t node = transforms.create(position, parentNode);
+    if (transformEntity.size() <= node) transformEntity.resize(node + 1);
+    transformEntity[node] = handle;
+    entities.transform[row] = node;
+    entities.radius[row] = sphere.geometry.getRadius();
+    entities.color[row] = sphere.Color;
+    entities.opacity[row] = sphere.Opacity;
+    entities.lightRange[row] = sphere.LightRange;
+    entities.flags[row] = ENTITY_REMESH |
+                          (sphere.source ? ENTITY_SOURCE : 0u) |
+                          (sphere.dynamic ? ENTITY_DYNAMIC : 0u) |
+                          (sphere.hasAtmosphere ? ENTITY_ATMOSPHERE : 0u) |
+                          (sphere.virtualTextured ? ENTITY_VIRTUAL_TEXTURE : 0u);
+
+    // Remember the light source sphere; only its marker is shrunk
+    if (sphere.source) {
+        if (entities.alive(lightEntity)) transforms.setScale(entities.transform[entities.row(lightEntity)], glm::vec3(1.0f));
+        transforms.setScale(node, glm::vec3(LIGHT_MARKER_SCALE));
+        lightEntity = handle;
+    }
+    return handle;
+}
+
+// Remove an entity: its scene id, its transform node (children become
+// roots), its share of the mesh, its cold data, then its row (the last row
+// moves into it)
+void Renderer::removeSphere(EntityHandle handle) {
+    if (!entities.alive(handle)) return;
+    if (handle.slot < slotSceneId.size() && slotSceneId[handle.slot] != 0) {
+        sceneSpheres.erase(slotSceneId[handle.slot]);
+        slotSceneId[handle.slot] = 0;
+    }
+    uint32_t row = entities.row(handle);
+    uint32_t node = entities.transform[row];
+    transformEntity[node] = EntityHandle();
+    transforms.destroy(node);
+    releaseMesh(entities.mesh[row]);
+    if (!(entities.flags[row] & ENTITY_SHARED)) spheres.destroy(entities.sphere[row]);
+    entities.destroy(handle);
+}
+
+// Replace the scene with a scene file: one pooled Sphere and one mesh per
+// prototype, shared by its spheres (ENTITY_SHARED), then the columns in bulk
+bool Renderer::loadScene(const std::string& path) {
+    SceneFile file;
+    if (!file.open(path)) return false;
+    clearScene();
+
+    const SceneColumns& columns = file.columns();
+    std::vector<uint32_t> users(file.prototypeCount(), 0);
+    for (size_t i = 0; i < columns.count; ++i) ++users[columns.prototypes[i]];
+
+    std::vector<PoolHandle<Sphere>> cold(file.prototypeCount());
+    std::vector<PoolHandle<Mesh>>   shared(file.prototypeCount());
+    for (uint32_t p = 0; p < file.prototypeCount(); ++p) {
+        if (users[p] == 0) continue;
+        const ScenePrototype& prototype = file.prototypes()[p];
+        Sphere sphere;
+        sphere.geometry = CubeSphere(prototype.radius, prototype.subdivisions);
+        sphere.Name.assign(prototype.name, strnlen(prototype.name, sizeof(prototype.name)));
+        sphere.hasAtmosphere = prototype.hasAtmosphere != 0;
+        sphere.atmosphere = prototype.atmosphere;
+        cold[p] = spheres.create(std::move(sphere));
+        shared[p] = acquireMesh(spheres.get(cold[p])->geometry);   // One user so far
+        meshes.get(shared[p])->users += users[p] - 1;
+    }
+
+    uint32_t first = file.instantiate(entities, transforms, transformEntity);
+    for (uint32_t i = 0; i < columns.count; ++i) {
+        uint32_t row = first + i;
+        uint32_t p = columns.prototypes[i];
+        entities.sphere[row] = cold[p];
+        entities.mesh[row] = shared[p];
+        entities.radius[row] = file.prototypes()[p].radius;
+        entities.flags[row] |= ENTITY_SHARED;
+    }
+
+    if (file.lightSphere() != SceneFile::NONE) {
+        lightEntity = entities.handle(first + file.lightSphere());
+        transforms.setScale(entities.transform[first + file.lightSphere()], glm::vec3(LIGHT_MARKER_SCALE));
+    }
+    return true;
+}
+
+// Snapshot: rows in depth order (parents first), local positions, one
+// prototype per distinct cold data (a loaded scene's shared spheres stay shared)
+bool Renderer::saveScene(const std::string& path) {
+    size_t count = entities.size();
+    auto parentRow = [&](uint32_t row) {
+        uint32_t parent = transforms.getParent(entities.transform[row]);
+        if (parent == TransformHierarchy::NONE || !entities.alive(transformEntity[parent])) return SceneFile::NONE;
+        return entities.row(transformEntity[parent]);
+    };
+
+    std::vector<uint32_t> depth(count, SceneFile::NONE);
+    std::vector<uint32_t> chain;
+    uint32_t levels = 0;
+    for (uint32_t row = 0; row < count; ++row) {
+        uint32_t r = row;
+        while (r != SceneFile::NONE && depth[r] == SceneFile::NONE) {
+            chain.push_back(r);
+            r = parentRow(r);
+        }
+        uint32_t d = r == SceneFile::NONE ? 0 : depth[r] + 1;
+        while (!chain.empty()) {
+            depth[chain.back()] = d++;
+            chain.pop_back();
+        }
+        levels = std::max(levels, depth[row] + 1);
+    }
+    std::vector<uint32_t> start(levels + 1, 0), order(count), index(count);
+    for (uint32_t row = 0; row < count; ++row) ++start[depth[row] + 1];
+    for (uint32_t d = 0; d < levels; ++d) start[d + 1] += start[d];
+    for (uint32_t row = 0; row < count; ++row) {
+        index[row] = start[depth[row]]++;
+        order[index[row]] = row;
+    }
+
+    std::vector<glm::dvec3> positions(count);
+    std::vector<glm::quat> rotations(count);
+    std::vector<uint32_t> parents(count), prototypeIndex(count), flags(count);
+    std::vector<glm::vec3> scales(count), colors(count);
+    std::vector<float> opacity(count), lightRange(count);
+    std::vector<ScenePrototype> prototypes;
+    std::unordered_map<uint32_t, uint32_t> prototypeOf;     // Sphere pool index -> prototype
+    for (uint32_t i = 0; i < count; ++i) {
+        uint32_t row = order[i];
+        uint32_t parent = parentRow(row);
+        positions[i] = transforms.getPosition(entities.transform[row]);
+        rotations[i] = transforms.getRotation(entities.transform[row]);
+        scales[i] = transforms.getScale(entities.transform[row]);
+        parents[i] = parent == SceneFile::NONE ? SceneFile::NONE : index[parent];
+        colors[i] = entities.color[row];
+        opacity[i] = entities.opacity[row];
+        lightRange[i] = entities.lightRange[row];
+        flags[i] = entities.flags[row] & SceneFile::FLAGS;
+
+        auto known = prototypeOf.emplace(entities.sphere[row].index, (uint32_t)prototypes.size());
+        if (known.second) {
+            const Sphere& sphere = sphereOf(row);
+            ScenePrototype prototype;
+            prototype.radius = sphere.geometry.getRadius();
+            prototype.subdivisions = sphere.geometry.getSubdivisions();
+            prototype.hasAtmosphere = sphere.hasAtmosphere ? 1 : 0;
+            std::strncpy(prototype.name, sphere.Name.c_str(), sizeof(prototype.name));
+            prototype.atmosphere = sphere.atmosphere;
+            prototypes.push_back(prototype);
+        }
+        prototypeIndex[i] = known.first->second;
+    }
+
+    SceneColumns columns;
+    columns.count = count;
+    columns.positions = positions.data();
+    columns.rotations = rotations.data();
+    columns.scales = scales.data();
+    columns.parents = parents.data();
+    columns.prototypes = prototypeIndex.data();
+    columns.colors = colors.data();
+    columns.opacity = opacity.data();
+    columns.lightRange = lightRange.data();
+    columns.flags = flags.data();
+    uint32_t light = entities.alive(lightEntity) ? index[entities.row(lightEntity)] : SceneFile::NONE;
+    if (light != SceneFile::NONE) scales[light] = glm::vec3(1.0f);     // The marker scale is reapplied on load
+    return SceneFile::save(path, columns, prototypes.data(), (uint32_t)prototypes.size(), light);
+}
+
+// Remove every entity, transform, pooled sphere and mesh (every handle and
+// queued id goes stale)
+void Renderer::clearScene() {
+    entities.clear();
+    transforms.clear();
+    transformEntity.clear();
+    sceneSpheres.clear();
+    slotSceneId.clear();
+    spheres.clear();
+    releaseMeshes();
+    lightEntity = EntityHandle();
+    lightRow = -1;
+    poolDirty = true;
+}
+
+// Queue a sphere (copied here, on the caller's thread); the id is usable at once
+SceneId Renderer::createSphere(const Sphere& sphere, const glm::dvec3& position, SceneId parent) {
+    SceneCommand command;
+    command.type = SCENE_CREATE;
+    command.id = nextSceneId.fetch_add(1, std::memory_order_relaxed);
+    command.parent = parent;
+    command.position = position;
+    command.sphere.reset(new Sphere(sphere));
+    SceneId id = command.id;
+    sceneCommands.push(std::move(command));
+    return id;
+}
+
+void Renderer::destroySphere(SceneId id) {
+    SceneCommand command;
+    command.type = SCENE_DESTROY;
+    command.id = id;
+    sceneCommands.push(std::move(command));
+}
+
+void Renderer::moveSphere(SceneId id, const glm::dvec3& position) {
+    SceneCommand command;
+    command.type = SCENE_MOVE;
+    command.id = id;
+    command.position = position;
+    sceneCommands.push(std::move(command));
+}
+
+void Renderer::recolorSphere(SceneId id, const glm::vec3& color, float opacity) {
+    SceneCommand command;
+    command.type = SCENE_RECOLOR;
+    command.id = id;
+    command.color = glm::vec4(color, opacity);
+    sceneCommands.push(std::move(command));
+}
+
+EntityHandle Renderer::findSphere(SceneId id) const {
+    auto found = sceneSpheres.find(id);
+    return found != sceneSpheres.end() ? found->second : EntityHandle();
+}
+
+// Apply every queued edit before anything reads the entity rows this frame.
+// Creates only add rows and nodes: their meshes come in one pass in
+// bucketSpheres(), one upload per new geometry, shared by all its spheres.
+void Renderer::applySceneCommands() {
+    SceneCommand command;
+    while (sceneCommands.pop(command)) {
+        if (command.type == SCENE_CREATE) {
+            EntityHandle handle = addSphere(spheres.create(std::move(*command.sphere)), command.position, findSphere(command.parent));
+            sceneSpheres[command.id] = handle;
+            if (slotSceneId.size() <= handle.slot) slotSceneId.resize(handle.slot + 1, 0);
+            slotSceneId[handle.slot] = command.id;
+            continue;
+        }
+
+        auto found = sceneSpheres.find(command.id);
+        if (found == sceneSpheres.end() || !entities.alive(found->second)) continue;
+        uint32_t row = entities.row(found->second);
+        switch (command.type) {
+            case SCENE_DESTROY:
+                removeSphere(found->second);        // Erases the id
+                break;
+            case SCENE_MOVE:
+                transforms.setPosition(entities.transform[row], command.position);
+                break;
+            case SCENE_RECOLOR:
+                entities.color[row] = glm::vec3(command.color);
+                entities.opacity[row] = command.color.a;
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+EntityStore& Renderer::getEntities() {
+    return entities;
+}
+
+TransformHierarchy& Renderer::getTransforms() {
+    return transforms;
 }
 
 // Main render loop
@@ -34,79 +379,832 @@ void Renderer::runRenderLoop() {
         deltaTime = currentFrame - lastFrame;
         lastFrame = currentFrame;
 
+        glState.beginFrame();
         displayFrameRate(deltaTime);
         processKeyboardInput(window);
+        applySceneCommands();
 
-        // Clear frame
+        // Clear frame (depth writes must be on for the depth clear)
+        glState.setDepthWrite(true);
         glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        // Bind shader + upload camera matrices
-        ourShader.use();
-        generateCameraView();
-
-        // Provide light + view uniforms (light position may change below for animated light)
-        glm::vec3 lightPos = lightSphere ? lightSphere->Position : glm::vec3(5.0f, 5.0f, 5.0f);
-        ourShader.setVec3("lightPos", lightPos);
-        ourShader.setVec3("viewPos", camera.Position);
-
-        // Draw all non-light spheres (lit objects)
-        for(Sphere* s : spheres) {
-            if (s == lightSphere) continue; // skip light marker here
-            glm::mat4 model = glm::translate(glm::mat4(1.0f), s->Position);
-            ourShader.setBool("source", s->source); // normally false here
-            ourShader.setVec3("inColor", s->Color);
-            ourShader.setMat4("model", model);
-            glBindVertexArray(s->mesh.VAO);
-            glDrawElements(GL_TRIANGLES, s->mesh.indexCount, GL_UNSIGNED_INT, 0);
+        // Keep presenting cleared frames while the programs are still compiling
+        if (!shaderVariants.isReady()) {
+            glfwSwapBuffers(window);
+            glfwPollEvents();
+            continue;
+        }
+
+        // Animate the light first so lit spheres see this frame's position/colour,
+        // then move every position into this frame's render space
+        lightRow = entities.alive(lightEntity) ? (int)entities.row(lightEntity) : -1;
+        animateLight();
+        updateRenderOrigin();
+        glm::vec3 lightPos   = lightRow >= 0 ? entities.position[lightRow] : glm::vec3(5.0f, 5.0f, 5.0f);
+        glm::vec3 lightColor = lightRow >= 0 ? entities.color[lightRow] : glm::vec3(1.0f);
+
+        bucketSpheres();
+
+        // Multi-view: straight to the window (or the capture cube), no culling or scaling
+        if (multiViewMode != MULTIVIEW_OFF) {
+            renderWidth  = fbWidth;
+            renderHeight = fbHeight;
+            if (frameShadowMode == SHADOW_MAP) renderShadows();
+            renderMultiView(lightPos, lightColor);
+
+            glState.endFrame();
+            glfwSwapBuffers(window);
+            glfwPollEvents();
+            if (!firstFrameDrawn) reportFirstFrame();
+            continue;
         }
 
-        // Draw / animate the light sphere (emissive)
-        if (lightSphere) {
-            Sphere* s = lightSphere;
-
-            // Time parameter
-            float t = (float)glfwGetTime();
-
-            // Cycling rainbow color (phase-shifted sine)
-            glm::vec3 dynColor = {
-                0.5f + 0.5f * sinf(t),
-                0.5f + 0.5f * sinf(t + 2.094f),   // +120°
-                0.5f + 0.5f * sinf(t + 4.188f)    // +240°
-            };
-
-            // Animated "dancing" orbit path
-            glm::vec3 dynPos;
-            float r  = 0.3f;                
-            dynPos.x = cosf(t) * r;
-            dynPos.z = sinf(t) * r * cosf(t * 0.5f); 
-            dynPos.y = 1.0f + 0.5f * sinf(t * 2.0f); 
-
-            s->Position = dynPos;                // update light sphere logical position
-            ourShader.setVec3("lightPos", s->Position); // refresh light position for shading
-
-            // Build model (translate + shrink)
-            glm::mat4 model = glm::translate(glm::mat4(1.0f), s->Position);
-            model = glm::scale(model, glm::vec3(0.35f));
-
-            // Source branch in fragment shader: emissive
-            ourShader.setBool("source", s->source);
-            ourShader.setVec3("inColor", dynColor);   // emissive tint
-            ourShader.setVec3("lightColor", dynColor);
-            ourShader.setMat4("model", model);
-
-            glBindVertexArray(s->mesh.VAO);
-            glDrawElements(GL_TRIANGLES, s->mesh.indexCount, GL_UNSIGNED_INT, 0);
+        // Render size for this frame; offscreen targets are cleared like the window.
+        // Reversed depth always renders offscreen (at full size when not scaling):
+        // the scene passes blit float depth between targets, the window's is fixed point
+        if (resolutionTarget()) {
+            resolution.begin(fbWidth, fbHeight, dynamicResolution);
+            renderWidth  = resolution.renderWidth();
+            renderHeight = resolution.renderHeight();
+        } else {
+            renderWidth  = fbWidth;
+            renderHeight = fbHeight;
         }
+        if (postProcessing) post.resize(fbWidth, fbHeight, renderWidth, renderHeight);
+        if (sceneFramebuffer() != 0) {
+            bindSceneTarget();
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        }
+
+        // Lights: bound by the deferred light volumes, binned into the cluster grid
+        // or bounced into the probe grid
+        bool deferredShading = shadingPath == SHADING_DEFERRED;
+        bool forwardProbes = probeLighting && shadingPath == SHADING_FORWARD;
+        if (clusteredLighting || deferredShading || forwardProbes) gatherLights();
+        if (clusteredLighting && !deferredShading)
+            clusters.update(frameLights, camera.getViewMatrix(), projectionMatrix(), renderWidth, renderHeight);
+
+        // GPU culling fills one indirect command per sphere in draw order;
+        // CPU culling decides before submission, without any readback
+        if (occlusionCulling || cpuOcclusionCulling) gatherCullBounds();
+        if (occlusionCulling) cullSpheres();
+        if (cpuOcclusionCulling) cullSpheresCpu();
 
-        glBindVertexArray(0);
+        // Opaque path, the sky behind it, then translucent spheres over it (timed together)
+        GpuQuery* timers[] = {&forwardTimer, &deferredTimer, &visibilityTimer};
+        timers[shadingPath]->begin();
+        if (atmosphereRow >= 0) updateAtmosphere(lightPos, lightColor);
+        if (frameVirtualTexture) updateVirtualTexture();
+        if (shadingPath == SHADING_DEFERRED) {
+            renderDeferred();
+        } else if (shadingPath == SHADING_VISIBILITY) {
+            renderVisibility(lightPos, lightColor);
+        } else {
+            if (frameShadowMode == SHADOW_MAP) renderShadows();
+            if (frameShadowMode == SHADOW_ANALYTIC) gatherOccluders();
+            if (probeLighting) updateProbes();
+            renderForward(lightPos, lightColor);
+        }
+        if (atmosphereRow >= 0) {
+            bindSceneTarget();
+            atmosphere.renderSky(glm::inverse(projectionMatrix() * camera.getViewMatrix()), renderWidth, renderHeight);
+        }
+        if (!translucentSpheres.empty()) renderTranslucent(lightPos, lightColor);
+        timers[shadingPath]->end();
+        updateShadingTimings();
+
+        // Bloom + tonemap into the window (upscaling too), or upscale the LDR frame
+        if (postProcessing) post.run();
+        else if (resolutionTarget()) resolution.present();
+
+        glState.endFrame();
         glfwSwapBuffers(window);
         glfwPollEvents();
+
+        if (!firstFrameDrawn) reportFirstFrame();
     } 
 
     cleanup();
 }
 
+// Forward path: optional depth prepass, then each variant bucket shaded with its own program
+void Renderer::renderForward(const glm::vec3& lightPos, const glm::vec3& lightColor) {
+    // Optional depth-only pass: lays down final depth so shading runs once per pixel
+    if (depthPrepass) renderDepthPrepass();
+
+    // Shading pass: only the nearest surface passes GL_EQUAL after a prepass
+    glState.setDepthFunc(depthPrepass ? GL_EQUAL : GL_LESS);
+    glState.setDepthWrite(!depthPrepass);
+    shadedQuery.begin();
+
+    for (DrawBucket& bucket : buckets) {
+        if (bucket.rows.empty()) continue;
+
+        Shader& shader = *bucket.shader;
+        shader.use();
+        generateCameraView(shader);
+        shader.setVec3("lightColor", lightColor);
+        shader.setVec3("lightPos", lightPos);
+        shader.setVec3("viewPos", camera.Position);
+        if (&bucket == &buckets[VARIANT_LIT]) {
+            if (clusteredLighting) {
+                clusters.bind(shader);
+                shader.setInt("shadowLight", shadowLightIndex);
+            }
+            if (frameShadowMode == SHADOW_MAP) shadowMap.bind(shader, 0);
+            if (frameShadowMode == SHADOW_ANALYTIC) occluders.bind(shader);
+            if (probeLighting) probes.bind(shader, 1);
+        }
+        if (&bucket == &buckets[VARIANT_ATMOSPHERE]) {
+            atmosphere.bind(shader);
+            if (frameVirtualTexture) virtualTexture.bind(shader, 3);
+        }
+        if (&bucket == &buckets[VARIANT_EMISSIVE]) shader.setFloat("emissiveIntensity", emissiveScale());
+
+        for (size_t i = 0; i < bucket.rows.size(); ++i) {
+            uint32_t row = bucket.rows[i];
+            shader.setVec3("inColor", entities.color[row]);
+            shader.setMat4("model", sphereModel(row));
+            submitSphere(bucket.first + i, row);
+        }
+    }
+
+    shadedQuery.end();
+    updateOverdrawStats();
+}
+
+// Render the light's cube shadow map: static casters only when the cache is
+// stale, dynamic casters every frame, all six faces in one submission each
+void Renderer::renderShadows() {
+    staticCasterBounds.clear();
+    dynamicCasters.clear();
+    for (uint32_t row = 0; row < entities.size(); ++row) {
+        if (entities.isSource(row) || entities.translucent(row)) continue;    // lights / translucent spheres do not cast
+        if (entities.flags[row] & ENTITY_DYNAMIC) dynamicCasters.push_back(row);
+        else staticCasterBounds.push_back(glm::vec4(entities.position[row], sphereRadius(row)));
+    }
+
+    Shader& caster = shadowMap.casterShader();
+    auto drawCasters = [&](bool dynamic) {
+        for (uint32_t row = 0; row < entities.size(); ++row) {
+            if (entities.isSource(row) || entities.translucent(row)) continue;
+            if (((entities.flags[row] & ENTITY_DYNAMIC) != 0) != dynamic) continue;
+            caster.setMat4("model", sphereModel(row));
+            glState.bindVertexArray(meshOf(row).VAO);
+            glState.drawElements(GL_TRIANGLES, meshOf(row).indexCount, GL_UNSIGNED_INT, 0);
+        }
+    };
+
+    if (shadowMap.beginStatic(entities.position[lightRow], entities.lightRange[lightRow], staticCasterBounds)) {
+        drawCasters(false);
+        shadowMap.endStatic();
+    }
+    if (shadowMap.beginDynamic(dynamicCasters.size())) {
+        drawCasters(true);
+        shadowMap.endDynamic();
+    }
+    bindSceneTarget();
+}
+
+// Every non-source sphere is an analytic occluder; gather them per screen tile
+void Renderer::gatherOccluders() {
+    occluderBounds.clear();
+    for (uint32_t row = 0; row < entities.size(); ++row) {
+        if (!entities.isSource(row) && !entities.translucent(row))
+            occluderBounds.push_back(glm::vec4(entities.position[row], sphereRadius(row)));
+    }
+    occluders.update(occluderBounds, glm::vec4(entities.position[lightRow], entities.lightRange[lightRow]),
+                     sphereRadius(lightRow), camera.getViewMatrix(), projectionMatrix(),
+                     renderWidth, renderHeight);
+}
+
+// Deferred path: lit spheres into the G-buffer, every light as a stencil-tested
+// volume, then the planet and emissive markers forward-shaded on top before presenting
+void Renderer::renderDeferred() {
+    deferred.resize(renderWidth, renderHeight);
+
+    deferred.beginGeometry();
+    gbufferShader->use();
+    generateCameraView(*gbufferShader);
+    const DrawBucket& lit = buckets[VARIANT_LIT];
+    for (size_t i = 0; i < lit.rows.size(); ++i) {
+        uint32_t row = lit.rows[i];
+        gbufferShader->setVec3("inColor", entities.color[row]);
+        gbufferShader->setMat4("model", sphereModel(row));
+        submitSphere(lit.first + i, row);
+    }
+    deferred.endGeometry();
+
+    deferred.lightPass(frameLights, camera.getViewMatrix(), projectionMatrix(), camera.Position);
+
+    // Neither is lit by the light volumes; depth-test them against the G-buffer depth
+    deferred.bindAccumulation();
+    drawBucket(VARIANT_ATMOSPHERE);
+    drawBucket(VARIANT_EMISSIVE);
+
+    deferred.present(sceneFramebuffer());
+}
+
+// Lit then emissive spheres, each submitted once with one instance per view;
+// views are framed around the lit spheres (the planet excluded)
+void Renderer::renderMultiView(const glm::vec3& lightPos, const glm::vec3& lightColor) {
+    glm::vec3 boundsMin(1e30f), boundsMax(-1e30f);
+    for (uint32_t row = 0; row < entities.size(); ++row) {
+        if (entities.flags[row] & (ENTITY_SOURCE | ENTITY_ATMOSPHERE)) continue;
+        float r = sphereRadius(row);
+        boundsMin = glm::min(boundsMin, entities.position[row] - glm::vec3(r));
+        boundsMax = glm::max(boundsMax, entities.position[row] + glm::vec3(r));
+    }
+    if (boundsMin.x > boundsMax.x) boundsMin = boundsMax = glm::vec3(0.0f);
+    glm::vec3 center = 0.5f * (boundsMin + boundsMax);
+    multiView.setup(multiViewMode, camera, fbWidth, fbHeight, center, glm::length(boundsMax - center));
+
+    multiView.begin();
+    Shader* programs[] = {multiViewLit[frameShadowMode == SHADOW_MAP ? 1 : 0], multiViewEmissive};
+    ShaderVariant variants[] = {VARIANT_LIT, VARIANT_EMISSIVE};
+    for (int v = 0; v < 2; ++v) {
+        const DrawBucket& bucket = buckets[variants[v]];
+        if (bucket.rows.empty()) continue;
+
+        Shader& shader = *programs[v];
+        shader.use();
+        shader.setVec3("lightPos", lightPos);
+        shader.setVec3("lightColor", lightColor);
+        if (v == 0 && frameShadowMode == SHADOW_MAP) shadowMap.bind(shader, 0);
+        for (uint32_t row : bucket.rows) {
+            shader.setVec3("inColor", entities.color[row]);
+            shader.setMat4("model", sphereModel(row));
+            glState.bindVertexArray(meshOf(row).VAO);
+            glState.drawElementsInstanced(GL_TRIANGLES, meshOf(row).indexCount, GL_UNSIGNED_INT, 0, multiView.viewCount());
+        }
+    }
+    multiView.end();
+}
+
+// Forward-shade one bucket onto the bound target (paths that light elsewhere)
+void Renderer::drawBucket(ShaderVariant variant) {
+    const DrawBucket& bucket = buckets[variant];
+    if (bucket.rows.empty()) return;
+
+    glState.setDepthWrite(true);    // later passes (sky, translucency) test against it
+    Shader& shader = *bucket.shader;
+    shader.use();
+    generateCameraView(shader);
+    if (variant == VARIANT_ATMOSPHERE) {
+        atmosphere.bind(shader);
+        if (frameVirtualTexture) virtualTexture.bind(shader, 3);
+    }
+    if (variant == VARIANT_EMISSIVE) shader.setFloat("emissiveIntensity", emissiveScale());
+    for (size_t i = 0; i < bucket.rows.size(); ++i) {
+        uint32_t row = bucket.rows[i];
+        shader.setVec3("inColor", entities.color[row]);
+        shader.setMat4("model", sphereModel(row));
+        submitSphere(bucket.first + i, row);
+    }
+}
+
+// Visibility path: rasterise (draw ID, triangle ID) only, then shade each
+// covered pixel once from the pooled geometry; the planet needs its own
+// program and is drawn forward against the resolved depth
+void Renderer::renderVisibility(const glm::vec3& lightPos, const glm::vec3& lightColor) {
+    if (poolDirty) uploadGeometryPool();
+    visibility.resize(renderWidth, renderHeight);
+
+    // Resolve data for every draw, indexed by the draw ID written below
+    visInstances.clear();
+    for (uint32_t row : drawOrder) {
+        const glm::vec3& color = entities.color[row];
+        VisInstance instance{};
+        instance.model = sphereModel(row);
+        instance.color = entities.isSource(row) ? glm::vec4(color * emissiveScale(), 1.0f) : glm::vec4(color, 0.0f);
+        instance.firstIndex = meshOf(row).poolFirstIndex;
+        instance.baseVertex = meshOf(row).poolBaseVertex;
+        visInstances.push_back(instance);
+    }
+    visibility.uploadInstances(visInstances);
+
+    Shader& raster = visibility.beginRaster();
+    generateCameraView(raster);
+    const DrawBucket& planet = buckets[VARIANT_ATMOSPHERE];
+    for (size_t i = 0; i < drawOrder.size(); ++i) {
+        if (i >= planet.first && i < planet.first + planet.rows.size()) continue;
+        raster.setUint("drawID", (unsigned int)i);
+        raster.setMat4("model", visInstances[i].model);
+        submitSphere(i, drawOrder[i]);
+    }
+    visibility.endRaster(sceneFramebuffer());
+
+    Shader& resolve = visibility.beginResolve(clusteredLighting);
+    glm::mat4 view = camera.getViewMatrix();
+    resolve.setMat4("view", view);
+    resolve.setMat4("inverseViewProjection", glm::inverse(projectionMatrix() * view));
+    resolve.setVec3("viewPos", camera.Position);
+    resolve.setVec3("lightPos", lightPos);
+    resolve.setVec3("lightColor", lightColor);
+    if (clusteredLighting) clusters.bind(resolve);
+    visibility.resolve();
+
+    drawBucket(VARIANT_ATMOSPHERE);
+}
+
+// Concatenate every distinct sphere mesh into the visibility pools and record offsets
+void Renderer::uploadGeometryPool() {
+    std::vector<float> positions;
+    std::vector<unsigned int> indices;
+    std::vector<uint8_t> placed(meshes.capacity(), 0);     // Shared meshes go in once
+    for (uint32_t row = 0; row < entities.size(); ++row) {
+        uint32_t index = entities.mesh[row].index;
+        if (placed[index]) continue;
+        placed[index] = 1;
+        Mesh& mesh = *meshes.get(entities.mesh[row]);
+        mesh.poolFirstIndex = (unsigned int)indices.size();
+        mesh.poolBaseVertex = (int)(positions.size() / 3);
+
+        const CubeSphere& geometry = sphereOf(row).geometry;
+        const float* v = geometry.getVertexData();
+        positions.insert(positions.end(), v, v + geometry.getVertexDataSize() / sizeof(float));
+        const unsigned int* i = geometry.getIndexData();
+        indices.insert(indices.end(), i, i + geometry.getIndexCount());
+    }
+    visibility.uploadGeometry(positions, indices);
+    poolDirty = false;
+}
+
+// Pull finished GPU times of every path (a few frames old, never stalls);
+// new times of the active path drive the dynamic resolution controller
+void Renderer::updateShadingTimings() {
+    uint64_t ns = 0;
+    bool fresh = false;
+    if (forwardTimer.poll(ns)) {
+        shadingTimings.forwardMs = ns / 1.0e6f;
+        fresh |= shadingPath == SHADING_FORWARD;
+    }
+    if (deferredTimer.poll(ns)) {
+        shadingTimings.deferredMs = ns / 1.0e6f;
+        fresh |= shadingPath == SHADING_DEFERRED;
+    }
+    if (visibilityTimer.poll(ns)) {
+        shadingTimings.visibilityMs = ns / 1.0e6f;
+        fresh |= shadingPath == SHADING_VISIBILITY;
+    }
+
+    if (fresh && dynamicResolution) {
+        const float active[] = {shadingTimings.forwardMs, shadingTimings.deferredMs, shadingTimings.visibilityMs};
+        resolution.update(active[shadingPath]);
+    }
+}
+
+// Sort registered spheres into per-variant draw lists (and one flat draw order)
+void Renderer::bucketSpheres() {
+    // Multi-view keeps the world-space shadow map; analytic shadows are binned per screen tile
+    bool multi = multiViewMode != MULTIVIEW_OFF;
+    bool shadowed = lightRow >= 0 && (shadingPath == SHADING_FORWARD || multi);
+    frameShadowMode = shadowed ? shadowMode : SHADOW_NONE;
+    if (multi && frameShadowMode == SHADOW_ANALYTIC) frameShadowMode = SHADOW_NONE;
+    bool probed = probeLighting && shadingPath == SHADING_FORWARD;
+    buckets[VARIANT_LIT].shader = litShaders[clusteredLighting ? 1 : 0][probed ? 1 : 0][frameShadowMode];
+
+    for (DrawBucket& bucket : buckets) bucket.rows.clear();
+    translucentSpheres.clear();
+    atmosphereRow = -1;
+    for (uint32_t row = 0; row < entities.size(); ++row) {
+        uint32_t flags = entities.flags[row];
+        if (flags & ENTITY_REMESH) setupSphereVertexBuffer(row);
+        if (entities.translucent(row)) {
+            translucentSpheres.push_back(row);
+        } else if (flags & ENTITY_SOURCE) {
+            buckets[VARIANT_EMISSIVE].rows.push_back(row);
+        } else if ((flags & ENTITY_ATMOSPHERE) && atmosphereEnabled && atmosphereRow < 0 && !multi) {
+            atmosphereRow = (int)row;   // LUTs exist for one planet; later ones are lit normally
+            buckets[VARIANT_ATMOSPHERE].rows.push_back(row);
+        } else {
+            buckets[VARIANT_LIT].rows.push_back(row);
+        }
+    }
+
+    frameVirtualTexture = atmosphereRow >= 0 && (entities.flags[atmosphereRow] & ENTITY_VIRTUAL_TEXTURE) &&
+                          virtualTexturing && virtualTexture.ready();
+    buckets[VARIANT_ATMOSPHERE].shader = atmosphereShaders[frameVirtualTexture ? 1 : 0];
+
+    drawOrder.clear();
+    for (DrawBucket& bucket : buckets) {
+        bucket.first = drawOrder.size();
+        drawOrder.insert(drawOrder.end(), bucket.rows.begin(), bucket.rows.end());
+    }
+}
+
+// The planet's sun is the animated light, seen from the planet centre;
+// the parameter LUTs are rebuilt only when the medium or albedo changed
+void Renderer::updateAtmosphere(const glm::vec3& lightPos, const glm::vec3& lightColor) {
+    atmosphere.update(sphereOf(atmosphereRow).atmosphere, entities.color[atmosphereRow],
+                      entities.position[atmosphereRow], sphereRadius(atmosphereRow),
+                      lightPos, lightColor, camera.Position);
+}
+
+// Upload the tiles streamed since the last frame, then draw the planet into
+// the feedback target to record the tiles it needs now (read back later)
+void Renderer::updateVirtualTexture() {
+    virtualTexture.update();
+
+    Shader& feedback = virtualTexture.beginFeedback(renderWidth, renderHeight);
+    generateCameraView(feedback);
+    const Mesh& mesh = meshOf(atmosphereRow);
+    feedback.setMat4("model", sphereModel(atmosphereRow));
+    glState.bindVertexArray(mesh.VAO);
+    glState.drawElements(GL_TRIANGLES, mesh.indexCount, GL_UNSIGNED_INT, 0);
+    virtualTexture.endFeedback();
+    bindSceneTarget();
+}
+
+// Lit opaque spheres block the probes' sky and bounce the lights; the grid
+// spans them (not the planet, which would stretch it over empty space)
+void Renderer::updateProbes() {
+    probeSpheres.clear();
+    probeAlbedos.clear();
+    glm::vec3 boundsMin(1e30f), boundsMax(-1e30f);
+    for (uint32_t row = 0; row < entities.size(); ++row) {
+        if (entities.isSource(row) || entities.translucent(row)) continue;
+        const glm::vec3& p = entities.position[row];
+        float r = sphereRadius(row);
+        probeSpheres.push_back(glm::vec4(p, r));
+        probeAlbedos.push_back(entities.color[row]);
+        if (entities.flags[row] & ENTITY_ATMOSPHERE) continue;
+        boundsMin = glm::min(boundsMin, p - glm::vec3(r));
+        boundsMax = glm::max(boundsMax, p + glm::vec3(r));
+    }
+    if (boundsMin.x > boundsMax.x) boundsMin = boundsMax = glm::vec3(0.0f);
+    probes.update(frameLights, probeSpheres, probeAlbedos,
+                  boundsMin - glm::vec3(0.5f), boundsMax + glm::vec3(0.5f));
+}
+
+// Collect every source sphere as a point light (world space)
+void Renderer::gatherLights() {
+    frameLights.clear();
+    shadowLightIndex = -1;
+    for (uint32_t row = 0; row < entities.size(); ++row) {
+        if (!entities.isSource(row)) continue;
+        if ((int)row == lightRow) shadowLightIndex = (int)frameLights.size();
+        frameLights.push_back({glm::vec4(entities.position[row], entities.lightRange[row]),
+                               glm::vec4(entities.color[row], 1.0f)});
+    }
+}
+
+// Animate the light sphere along its "dancing" orbit with a cycling colour
+void Renderer::animateLight() {
+    if (lightRow < 0 || !lightAnimation) return;
+
+    // Time parameter
+    float t = (float)glfwGetTime();
+
+    // Cycling rainbow color (phase-shifted sine); also the emitted light colour
+    entities.color[lightRow] = {
+        0.5f + 0.5f * sinf(t),
+        0.5f + 0.5f * sinf(t + 2.094f),   // +120°
+        0.5f + 0.5f * sinf(t + 4.188f)    // +240°
+    };
+
+    // Animated "dancing" orbit path
+    glm::vec3 dynPos;
+    float r  = 0.3f;
+    dynPos.x = cosf(t) * r;
+    dynPos.z = sinf(t) * r * cosf(t * 0.5f);
+    dynPos.y = 1.0f + 0.5f * sinf(t * 2.0f);
+
+    transforms.setPosition(entities.transform[lightRow], glm::dvec3(dynPos));   // entity columns follow in updateRenderOrigin()
+}
+
+// Snap the origin near the camera and rebuild the float matrices from the
+// doubles, so precision depends on distance to the camera, never to the
+// world origin. Snapping keeps render-space positions (and the shadow / probe
+// caches keyed on them) unchanged while the camera moves within a cell; then
+// only moved subtrees are recomputed, and a still scene costs nothing.
+void Renderer::updateRenderOrigin() {
+    glm::dvec3 eye = camera.WorldPosition;
+    renderOrigin = originSnap > 0.0 ? glm::floor(eye / originSnap + 0.5) * originSnap : eye;
+    camera.setRenderOrigin(renderOrigin);
+    if (!transforms.update(renderOrigin)) return;
+
+    for (uint32_t node : transforms.updated()) {
+        EntityHandle handle = transformEntity[node];
+        if (!entities.alive(handle)) continue;
+        uint32_t row = entities.row(handle);
+        entities.worldPosition[row] = transforms.worldPosition(node);
+        entities.position[row] = glm::vec3(transforms.world(node)[3]);
+        entities.scale[row] = transforms.worldScale(node);
+    }
+}
+
+const glm::dvec3& Renderer::getRenderOrigin() const {
+    return renderOrigin;
+}
+
+// Model matrix from the transform hierarchy (updated once per frame)
+const glm::mat4& Renderer::sphereModel(uint32_t row) const {
+    return transforms.world(entities.transform[row]);
+}
+
+// Bounding radius matching sphereModel()
+float Renderer::sphereRadius(uint32_t row) const {
+    return entities.radius[row] * entities.scale[row];
+}
+
+// Issue one sphere's draw; with culling on, its GPU-written command decides
+// whether any triangles are actually drawn
+void Renderer::submitSphere(size_t drawIndex, uint32_t row) {
+    if (cpuOcclusionCulling && !softCull.isVisible(drawIndex)) return;
+    const Mesh& mesh = meshOf(row);
+    glState.bindVertexArray(mesh.VAO);
+    if (occlusionCulling) {
+        const void* offset = (const void*)(drawIndex * sizeof(DrawCommand));
+        glState.drawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, offset, mesh.indexCount);
+    } else {
+        glState.drawElements(GL_TRIANGLES, mesh.indexCount, GL_UNSIGNED_INT, 0);
+    }
+}
+
+// Translucent spheres in any order: weighted accumulation against the opaque
+// depth (both faces, no depth writes), then one composite over the scene
+void Renderer::renderTranslucent(const glm::vec3& lightPos, const glm::vec3& lightColor) {
+    bool clustered = clusteredLighting && shadingPath != SHADING_DEFERRED;   // lists built this frame
+
+    oit.resize(renderWidth, renderHeight);
+    Shader& shader = oit.begin(sceneFramebuffer(), clustered);
+    generateCameraView(shader);
+    shader.setVec3("viewPos", camera.Position);
+    if (clustered) {
+        clusters.bind(shader);
+    } else {
+        shader.setVec3("lightPos", lightPos);
+        shader.setVec3("lightColor", lightColor);
+    }
+
+    for (uint32_t row : translucentSpheres) {
+        shader.setVec3("inColor", entities.color[row]);
+        shader.setFloat("opacity", entities.opacity[row]);
+        shader.setMat4("model", sphereModel(row));
+        glState.bindVertexArray(meshOf(row).VAO);
+        glState.drawElements(GL_TRIANGLES, meshOf(row).indexCount, GL_UNSIGNED_INT, 0);
+    }
+
+    oit.composite(sceneFramebuffer());
+    bindSceneTarget();
+}
+
+// Bounds + base commands in draw order, and the largest on-screen spheres
+// as occluders (highest radius / distance, in front of the camera)
+void Renderer::gatherCullBounds() {
+    cullBounds.clear();
+    cullCommands.clear();
+    for (uint32_t row : drawOrder) {
+        cullBounds.push_back(glm::vec4(entities.position[row], sphereRadius(row)));
+        cullCommands.push_back({(unsigned int)meshOf(row).indexCount, 1u, 0u, 0, 0u});
+    }
+
+    std::vector<std::pair<float, size_t>> candidates;
+    for (size_t i = 0; i < drawOrder.size(); ++i) {
+        glm::vec3 toSphere = glm::vec3(cullBounds[i]) - camera.Position;
+        float distance = glm::length(toSphere);
+        if (glm::dot(toSphere, camera.Front) <= 0.0f) continue;
+        candidates.push_back({cullBounds[i].w / std::max(distance, 1e-3f), i});
+    }
+    size_t count = std::min<size_t>(maxOccluders, candidates.size());
+    std::partial_sort(candidates.begin(), candidates.begin() + count, candidates.end(),
+                      [](const std::pair<float, size_t>& a, const std::pair<float, size_t>& b) {
+                          return a.first > b.first;
+                      });
+
+    occluderSpheres.clear();
+    cullOccluders.clear();
+    for (size_t i = 0; i < count; ++i) {
+        occluderSpheres.push_back(drawOrder[candidates[i].second]);
+        cullOccluders.push_back(cullBounds[candidates[i].second]);
+    }
+}
+
+// Draw the occluders into the Hi-Z target, build the depth pyramid, then
+// test every sphere's bounds against it on the GPU
+void Renderer::cullSpheres() {
+    glm::mat4 view = camera.getViewMatrix();
+    glm::mat4 projection = projectionMatrix();
+
+    hiz.beginOccluders();
+    depthShader->use();
+    generateCameraView(*depthShader);
+    for (uint32_t row : occluderSpheres) {
+        depthShader->setMat4("model", sphereModel(row));
+        glState.bindVertexArray(meshOf(row).VAO);
+        glState.drawElements(GL_TRIANGLES, meshOf(row).indexCount, GL_UNSIGNED_INT, 0);
+    }
+    hiz.endOccluders();
+    bindSceneTarget();
+
+    hiz.cull(cullBounds, cullCommands, projection * view, true);
+    hiz.bindCommands();
+}
+
+// Rasterise the occluders on the CPU and test every sphere's bounds; the
+// results are final this frame and skip submission in submitSphere().
+// The CPU rasteriser works in standard depth whatever the GL context uses
+void Renderer::cullSpheresCpu() {
+    softCull.cull(cullOccluders, cullBounds, projectionMatrix(false) * camera.getViewMatrix());
+}
+
+// Depth-only pass with the position-only program. Uses the exact model
+// matrices of the shading pass (gl_Position is invariant) so GL_EQUAL holds.
+void Renderer::renderDepthPrepass() {
+    glState.setColorWrite(false);
+    glState.setDepthFunc(GL_LESS);
+    glState.setDepthWrite(true);
+
+    depthShader->use();
+    generateCameraView(*depthShader);
+
+    prepassQuery.begin();
+    for (size_t i = 0; i < drawOrder.size(); ++i) {
+        depthShader->setMat4("model", sphereModel(drawOrder[i]));
+        submitSphere(i, drawOrder[i]);
+    }
+    prepassQuery.end();
+
+    glState.setColorWrite(true);
+}
+
+// Pull finished sample counts (a few frames old) into the overdraw stats
+void Renderer::updateOverdrawStats() {
+    uint64_t shaded = 0, prepass = 0;
+    if (shadedQuery.poll(shaded)) {
+        overdrawStats.shadedFragments = shaded;
+        overdrawStats.shadedPerPixel  = (float)shaded / (float)(renderWidth * renderHeight);
+    }
+    if (prepassQuery.poll(prepass)) overdrawStats.prepassFragments = prepass;
+
+    overdrawStats.overdraw = (depthPrepass && overdrawStats.shadedFragments)
+        ? (float)overdrawStats.prepassFragments / (float)overdrawStats.shadedFragments
+        : 0.0f;
+}
+
+// Enable / disable the depth prepass
+void Renderer::setDepthPrepass(bool enabled) {
+    depthPrepass = enabled;
+}
+
+bool Renderer::getDepthPrepass() const {
+    return depthPrepass;
+}
+
+// Shading work counters (GL_SAMPLES_PASSED, read back without stalling)
+const OverdrawStats& Renderer::getOverdrawStats() const {
+    return overdrawStats;
+}
+
+// Enable / disable Hi-Z occlusion culling
+void Renderer::setOcclusionCulling(bool enabled) {
+    occlusionCulling = enabled;
+}
+
+bool Renderer::getOcclusionCulling() const {
+    return occlusionCulling;
+}
+
+// Enable / disable software (CPU) occlusion culling
+void Renderer::setCpuOcclusionCulling(bool enabled) {
+    cpuOcclusionCulling = enabled;
+}
+
+bool Renderer::getCpuOcclusionCulling() const {
+    return cpuOcclusionCulling;
+}
+
+// CPU cull counts + timings of the current frame
+const SoftCullStats& Renderer::getCpuCullStats() const {
+    return softCull.getStats();
+}
+
+// Switch between clustered and single-light forward shading
+void Renderer::setClusteredLighting(bool enabled) {
+    clusteredLighting = enabled;
+}
+
+bool Renderer::getClusteredLighting() const {
+    return clusteredLighting;
+}
+
+// Select the shading path
+void Renderer::setShadingPath(ShadingPath path) {
+    shadingPath = path;
+}
+
+ShadingPath Renderer::getShadingPath() const {
+    return shadingPath;
+}
+
+// GPU time of the forward / deferred scene passes (each from its last active frame)
+const ShadingTimings& Renderer::getShadingTimings() const {
+    return shadingTimings;
+}
+
+// Select how the animated light is shadowed
+void Renderer::setShadowMode(ShadowMode mode) {
+    shadowMode = mode;
+}
+
+ShadowMode Renderer::getShadowMode() const {
+    return shadowMode;
+}
+
+// Freeze / resume the light's orbit and colour cycle
+void Renderer::setLightAnimation(bool enabled) {
+    lightAnimation = enabled;
+}
+
+bool Renderer::getLightAnimation() const {
+    return lightAnimation;
+}
+
+// Enable / disable dynamic resolution (off = render straight to the window)
+void Renderer::setDynamicResolution(bool enabled) {
+    dynamicResolution = enabled;
+}
+
+bool Renderer::getDynamicResolution() const {
+    return dynamicResolution;
+}
+
+// GPU time the resolution controller aims for
+void Renderer::setFrameBudget(float milliseconds) {
+    resolution.budgetMs = milliseconds;
+}
+
+// Current scale + budget miss counters
+const DynamicResolution& Renderer::getResolution() const {
+    return resolution;
+}
+
+// Enable / disable the planet atmosphere (off = the planet is lit like any sphere)
+void Renderer::setAtmosphere(bool enabled) {
+    atmosphereEnabled = enabled;
+}
+
+bool Renderer::getAtmosphere() const {
+    return atmosphereEnabled;
+}
+
+void Renderer::setPostProcessing(bool enabled) {
+    postProcessing = enabled;
+}
+
+bool Renderer::getPostProcessing() const {
+    return postProcessing;
+}
+
+const PostTimings& Renderer::getPostTimings() const {
+    return post.getTimings();
+}
+
+void Renderer::setVirtualTexturing(bool enabled) {
+    virtualTexturing = enabled;
+}
+
+bool Renderer::getVirtualTexturing() const {
+    return virtualTexturing;
+}
+
+const VirtualTextureStats& Renderer::getVirtualTextureStats() const {
+    return virtualTexture.getStats();
+}
+
+void Renderer::setMultiView(MultiViewMode mode) {
+    multiViewMode = mode;
+}
+
+MultiViewMode Renderer::getMultiView() const {
+    return multiViewMode;
+}
+
+void Renderer::setProbeLighting(bool enabled) {
+    probeLighting = enabled;
+}
+
+bool Renderer::getProbeLighting() const {
+    return probeLighting;
+}
+
+// Re-subdivide every lit sphere (meshes are re-uploaded on the next frame;
+// shared cold data is regenerated once)
+void Renderer::setSubdivisions(unsigned int subdivisions) {
+    for (uint32_t row = 0; row < entities.size(); ++row) {
+        if (entities.isSource(row)) continue;
+        if (sphereOf(row).geometry.getSubdivisions() != subdivisions) sphereOf(row).setSubdivisions(subdivisions);
+        entities.flags[row] |= ENTITY_REMESH;
+    }
+}
+
+// Culled vs drawn sphere counts (a few frames old, never stalls)
+const CullStats& Renderer::getCullStats() {
+    return hiz.getStats();
+}
+
 // Initialize GLFW and request core profile context
 void Renderer::initGlfwWindow() {
     glfwInit();
@@ -139,52 +1237,144 @@ void Renderer::loadGLAD() {
 }
 
 // Upload projection + view matrices
-void Renderer::generateCameraView() {
-    glm::mat4 projection = glm::perspective(glm::radians(FOV),
-        (float)SCR_WIDTH / (float)SCR_HEIGHT, 0.1f, 100.0f);
-    ourShader.setMat4("projection", projection);
+void Renderer::generateCameraView(Shader& shader) {
+    glm::mat4 projection = projectionMatrix();
+    shader.setMat4("projection", projection);
 
     glm::mat4 view = camera.getViewMatrix();
-    ourShader.setMat4("view", view);
+    shader.setMat4("view", view);
 }
 
-// Create / update sphere mesh buffers (only when first created or remake flag true)
-void Renderer::setupSphereVertexBuffer(Sphere& sphere) {
+// Camera projection in the context's depth convention
+glm::mat4 Renderer::projectionMatrix() const {
+    return projectionMatrix(glState.reversedDepth());
+}
+
+// Camera projection (aspect of the current framebuffer), far plane at infinity
+glm::mat4 Renderer::projectionMatrix(bool reversed) const {
+    float aspect = fbHeight > 0 ? (float)fbWidth / (float)fbHeight : (float)SCR_WIDTH / (float)SCR_HEIGHT;
+    return infiniteProjection(glm::radians(FOV), aspect, NEAR_PLANE, reversed);
+}
 
-    if (sphere.mesh.VAO != 0 && !sphere.remake) return; // already uploaded and valid
+// Where the scene is rendered this frame
+unsigned int Renderer::sceneFramebuffer() const {
+    if (postProcessing) return post.framebuffer();
+    return resolutionTarget() ? resolution.framebuffer() : 0;
+}
+
+// Scaled rendering, or reversed depth without the HDR target to render into
+bool Renderer::resolutionTarget() const {
+    return dynamicResolution || (glState.reversedDepth() && !postProcessing);
+}
+
+// Lights read brighter than 1 only where the HDR chain can bloom + tonemap them
+float Renderer::emissiveScale() const {
+    return postProcessing ? post.emissiveIntensity : 1.0f;
+}
 
-    if (sphere.mesh.VAO == 0) {
-        glGenBuffers(1, &sphere.mesh.VBO);
-        glGenVertexArrays(1, &sphere.mesh.VAO);
-        glGenBuffers(1, &sphere.mesh.EBO);
+// Bind the scene framebuffer with a viewport covering the render size
+void Renderer::bindSceneTarget() {
+    glState.bindFramebuffer(GL_FRAMEBUFFER, sceneFramebuffer());
+    glViewport(0, 0, renderWidth, renderHeight);
+}
+
+// Mesh cache key: spheres with equal radius and subdivisions share a mesh
+static uint64_t meshKey(const CubeSphere& geometry) {
+    float radius = geometry.getRadius();
+    uint32_t radiusBits;
+    std::memcpy(&radiusBits, &radius, sizeof(radiusBits));
+    return ((uint64_t)geometry.getSubdivisions() << 32) | radiusBits;
+}
+
+// Point an entity at the mesh of its geometry (only when first created or
+// ENTITY_REMESH is set)
+void Renderer::setupSphereVertexBuffer(uint32_t row) {
+    PoolHandle<Mesh> current = entities.mesh[row];
+    if (meshes.alive(current) && !(entities.flags[row] & ENTITY_REMESH)) return; // already uploaded and valid
+
+    const CubeSphere& geometry = sphereOf(row).geometry;
+    entities.radius[row] = geometry.getRadius();
+    entities.flags[row] &= ~ENTITY_REMESH;  // mesh up-to-date
+    if (meshes.alive(current) && meshes.get(current)->key == meshKey(geometry)) return;
+
+    releaseMesh(current);
+    entities.mesh[row] = acquireMesh(geometry);
+}
+
+// Cached mesh of this geometry with one more user, or a new upload
+PoolHandle<Mesh> Renderer::acquireMesh(const CubeSphere& geometry) {
+    uint64_t key = meshKey(geometry);
+    auto cached = meshCache.find(key);
+    if (cached != meshCache.end()) {
+        ++meshes.get(cached->second)->users;
+        return cached->second;
     }
 
-    glBindVertexArray(sphere.mesh.VAO);
+    PoolHandle<Mesh> handle = meshes.create();
+    Mesh& mesh = *meshes.get(handle);
+    mesh.key = key;
+    mesh.users = 1;
+    glGenVertexArrays(1, &mesh.VAO);
+    mesh.vertices = buffers.create();
+    mesh.indices = buffers.create();
+    glGenBuffers(1, &buffers.get(mesh.vertices)->name);
+    glGenBuffers(1, &buffers.get(mesh.indices)->name);
+    glState.bindVertexArray(mesh.VAO);
 
     // Vertex positions only (3 floats) – normals derived in shader from position
-    glBindBuffer(GL_ARRAY_BUFFER, sphere.mesh.VBO);
-    glBufferData(GL_ARRAY_BUFFER,
-                 sphere.geometry.getVertexDataSize(),
-                 sphere.geometry.getVertexData(),
-                 GL_STATIC_DRAW);
-
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, sphere.mesh.EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER,
-                 sphere.geometry.getIndexDataSize(),
-                 sphere.geometry.getIndexData(),
-                 GL_STATIC_DRAW);
+    fillBuffer(GL_ARRAY_BUFFER, mesh.vertices, geometry.getVertexData(), geometry.getVertexDataSize());
+    fillBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.indices, geometry.getIndexData(), geometry.getIndexDataSize());
 
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void *)0);
     glEnableVertexAttribArray(0);
 
-    glBindVertexArray(0);
+    glState.bindVertexArray(0);
+
+    mesh.indexCount = geometry.getIndexCount();
+    meshCache[key] = handle;
+    poolDirty = true;      // visibility pools hold a copy
+    return handle;
+}
+
+// Drop one entity's use of a mesh; the last user deletes its VAO + buffers
+void Renderer::releaseMesh(PoolHandle<Mesh> handle) {
+    Mesh* mesh = meshes.get(handle);
+    if (!mesh || --mesh->users > 0) return;
+    glState.invalidate();   // deleted names may be reused
+    glDeleteVertexArrays(1, &mesh->VAO);
+    for (PoolHandle<GpuBuffer> buffer : {mesh->vertices, mesh->indices}) {
+        glDeleteBuffers(1, &buffers.get(buffer)->name);
+        buffers.destroy(buffer);
+    }
+    meshCache.erase(mesh->key);
+    meshes.destroy(handle);
+    poolDirty = true;
+}
+
+// Bind a pooled buffer and fill it (in place when the size is unchanged)
+void Renderer::fillBuffer(GLenum target, PoolHandle<GpuBuffer> handle, const void* data, size_t size) {
+    GpuBuffer& buffer = *buffers.get(handle);
+    glState.bindBuffer(target, buffer.name);
+    if (buffer.size == size) {
+        glState.bufferSubData(target, 0, size, data);
+    } else {
+        glState.bufferData(target, size, data, GL_STATIC_DRAW);
+        buffer.size = size;
+    }
+}
 
-    sphere.mesh.indexCount = sphere.geometry.getIndexCount();
-    sphere.remake = false; // mesh up-to-date
+// Cold data of an entity
+Sphere& Renderer::sphereOf(uint32_t row) {
+    return *spheres.get(entities.sphere[row]);
+}
+
+// Mesh of an entity (uploaded at registration)
+const Mesh& Renderer::meshOf(uint32_t row) const {
+    return *meshes.get(entities.mesh[row]);
 }
 
 // Update window title with FPS (throttled)
-void Renderer::displayFrameRate(float deltaTime) const {
+void Renderer::displayFrameRate(float deltaTime) {
     static bool first = true;
     std::ostringstream oss;
     std::string title;
@@ -203,16 +1393,90 @@ void Renderer::displayFrameRate(float deltaTime) const {
         unsigned int frameRate = deltaTime > 0.0f ? (unsigned int)(1.0f / deltaTime) : 0;
         oss.clear();
         oss.str("");
-        oss << APP_NAME << " | FPS : " << frameRate;
+        oss << APP_NAME << " | FPS : " << frameRate
+            << " | draws : " << glState.frameStats().draws
+            << " | frags/px : " << overdrawStats.shadedPerPixel;
+        static const char* pathNames[] = {"forward", "deferred", "visibility"};
+        bool forward = shadingPath == SHADING_FORWARD;
+        if (depthPrepass && forward) oss << " | prepass, overdraw : " << overdrawStats.overdraw;
+        oss << " | tris : " << glState.frameStats().triangles
+            << " | " << pathNames[shadingPath]
+            << " ms : fwd " << shadingTimings.forwardMs
+            << " / def " << shadingTimings.deferredMs
+            << " / vis " << shadingTimings.visibilityMs;
+        if (dynamicResolution)
+            oss << " | res : " << (int)(resolution.getScale() * 100.0f + 0.5f) << "% "
+                << renderWidth << "x" << renderHeight
+                << " (budget " << resolution.budgetMs << " ms, missed "
+                << resolution.misses << "/" << resolution.samples << ")";
+        if (frameShadowMode == SHADOW_MAP)
+            oss << " | shadows : " << (shadowMap.cacheHit() ? "cached" : "rebuilt")
+                << " (" << shadowMap.staticRenders << ")";
+        if (frameShadowMode == SHADOW_ANALYTIC)
+            oss << " | shadows : analytic (" << occluders.occluderCount() << " spheres)";
+        if (clusteredLighting && shadingPath != SHADING_DEFERRED) oss << " | lights : " << clusters.lightCount();
+        if (occlusionCulling) {
+            const CullStats& cull = hiz.getStats();
+            oss << " | culled : " << cull.occluded + cull.frustumCulled << "/" << cull.tested;
+        }
+        if (!translucentSpheres.empty()) oss << " | translucent : " << translucentSpheres.size();
+        if (postProcessing && multiViewMode == MULTIVIEW_OFF) {
+            const PostTimings& t = post.getTimings();
+            oss << " | post : " << t.totalMs() << " ms (down " << t.downsampleMs << " / up " << t.upsampleMs
+                << " / tonemap " << t.compositeMs << ", budget " << post.budgetMs << " ms, missed "
+                << post.misses << "/" << post.samples << ")";
+        }
+        if (multiViewMode != MULTIVIEW_OFF) {
+            static const char* modeNames[] = {"off", "stereo", "split", "cube capture"};
+            oss << " | multi-view : " << modeNames[multiViewMode] << " (" << multiView.viewCount() << " views)";
+        }
+        if (probeLighting && forward)
+            oss << " | probes : " << probes.bakedProbes() << " baked (" << probes.fullBakes() << " full)";
+        if (atmosphereRow >= 0) oss << " | atmosphere : " << atmosphere.precomputeCount() << " LUT builds";
+        if (frameVirtualTexture) {
+            const VirtualTextureStats& vt = virtualTexture.getStats();
+            oss << " | vt : " << vt.resident << "/" << VirtualTexture::CACHE_SLOTS * VirtualTexture::CACHE_SLOTS
+                << " tiles (" << vt.requested << " wanted, " << vt.queued << " queued, "
+                << vt.streamed << " streamed, " << vt.evicted << " evicted)";
+        }
+        const TransformStats& xf = transforms.getStats();
+        oss << " | xforms : " << xf.updated << "/" << xf.nodes
+            << " | meshes : " << meshes.size();
+        if (cpuOcclusionCulling) {
+            const SoftCullStats& cull = softCull.getStats();
+            oss << " | cpu culled : " << cull.occluded + cull.frustumCulled << "/" << cull.tested
+                << " (" << cull.rasterMs + cull.testMs << " ms, "
+                << softCull.workerCount() << (softCull.simd() ? " avx2" : "") << " threads)";
+        }
         title = oss.str();
         glfwSetWindowTitle(window, title.c_str());
         timeSinceLastDisplay = 0.0f;
     }
 }
 
+// GL work counters of the last completed frame
+const GLFrameStats& Renderer::getFrameStats() const {
+    return glState.frameStats();
+}
+
+// Print startup latency once the first shaded frame has been presented
+void Renderer::reportFirstFrame() {
+    firstFrameDrawn = true;
+    std::cout << "Time to first frame: " << glfwGetTime() * 1000.0 << " ms"
+              << " (program cache hits: " << programCache.hits
+              << ", misses: " << programCache.misses
+              << (programCache.hasParallelCompile() ? ", parallel compile" : "")
+              << ")" << std::endl;
+}
+
 // Resize callback
 void Renderer::frameBufferSizeCallback(GLFWwindow* window, int width, int height) {
     glViewport(0, 0, width, height);
+    Renderer* renderer = static_cast<Renderer*>(glfwGetWindowUserPointer(window));
+    if (renderer) {
+        renderer->fbWidth  = width;
+        renderer->fbHeight = height;
+    }
 }
 
 // Static mouse callback -> forward to instance
@@ -249,10 +1513,128 @@ void Renderer::processKeyboardInput(GLFWwindow* window) {
         camera.processKeyboard(cameraMovement::UP, deltaTime);
     if (glfwGetKey(window, GLFW_KEY_LEFT_CONTROL) == GLFW_PRESS)
         camera.processKeyboard(cameraMovement::DOWN, deltaTime);
+
+    // P: toggle depth prepass
+    if (keyPressed(GLFW_KEY_P))
+        setDepthPrepass(!depthPrepass);
+
+    // O: toggle Hi-Z occlusion culling
+    if (keyPressed(GLFW_KEY_O))
+        setOcclusionCulling(!occlusionCulling);
+
+    // C: toggle CPU occlusion culling
+    if (keyPressed(GLFW_KEY_C))
+        setCpuOcclusionCulling(!cpuOcclusionCulling);
+
+    // L: toggle clustered lighting
+    if (keyPressed(GLFW_KEY_L))
+        setClusteredLighting(!clusteredLighting);
+
+    // G / V: toggle deferred / visibility-buffer shading (back to forward when pressed again)
+    if (keyPressed(GLFW_KEY_G))
+        setShadingPath(shadingPath == SHADING_DEFERRED ? SHADING_FORWARD : SHADING_DEFERRED);
+    if (keyPressed(GLFW_KEY_V))
+        setShadingPath(shadingPath == SHADING_VISIBILITY ? SHADING_FORWARD : SHADING_VISIBILITY);
+
+    // H: cycle shadows (none / cube map / analytic), K: freeze / resume the light animation
+    if (keyPressed(GLFW_KEY_H))
+        setShadowMode((ShadowMode)((shadowMode + 1) % SHADOW_MODE_COUNT));
+    if (keyPressed(GLFW_KEY_K))
+        setLightAnimation(!lightAnimation);
+
+    // R: toggle dynamic resolution
+    if (keyPressed(GLFW_KEY_R))
+        setDynamicResolution(!dynamicResolution);
+
+    // Y: toggle the planet atmosphere
+    if (keyPressed(GLFW_KEY_Y))
+        setAtmosphere(!atmosphereEnabled);
+
+    // T: toggle the planet's virtual texture
+    if (keyPressed(GLFW_KEY_T))
+        setVirtualTexturing(!virtualTexturing);
+
+    // B: toggle HDR bloom + tonemapping
+    if (keyPressed(GLFW_KEY_B))
+        setPostProcessing(!postProcessing);
+
+    // M: cycle multi-view off / stereo / split-screen / cube capture
+    if (keyPressed(GLFW_KEY_M))
+        setMultiView((MultiViewMode)((multiViewMode + 1) % MULTIVIEW_MODE_COUNT));
+
+    // I: toggle probe ambient / bounce lighting
+    if (keyPressed(GLFW_KEY_I))
+        setProbeLighting(!probeLighting);
+
+    // - / =: halve / double lit sphere subdivisions
+    bool coarser = keyPressed(GLFW_KEY_MINUS);
+    bool finer   = keyPressed(GLFW_KEY_EQUAL);
+    if ((coarser || finer) && entities.size() > 0) {
+        unsigned int subs = 16;
+        for (uint32_t row = 0; row < entities.size(); ++row)
+            if (!entities.isSource(row)) subs = sphereOf(row).geometry.getSubdivisions();
+        subs = coarser ? std::max(1u, subs / 2) : std::min(512u, subs * 2);
+        setSubdivisions(subs);
+    }
+
+    // F3: print GL counters every frame
+    if (keyPressed(GLFW_KEY_F3))
+        glState.dumpEachFrame = !glState.dumpEachFrame;
+
+    // F4: check the GPU scan / compaction / sort against CPU results, then
+    // benchmark them at 1M-16M elements (stdout; stalls for a few seconds)
+    if (keyPressed(GLFW_KEY_F4) && primitives.selfTest(std::cout))
+        primitives.benchmark(std::cout);
+
+    // F7: snapshot the scene to the startup scene file, F8: reload it
+    if (keyPressed(GLFW_KEY_F7) && saveScene(SCENE_PATH))
+        std::cout << "Scene saved: " << entities.size() << " spheres -> " << SCENE_PATH << std::endl;
+    if (keyPressed(GLFW_KEY_F8) && loadScene(SCENE_PATH))
+        std::cout << "Scene loaded: " << entities.size() << " spheres <- " << SCENE_PATH << std::endl;
+}
+
+// Edge-triggered key check (press, not hold)
+bool Renderer::keyPressed(int key) {
+    bool down = glfwGetKey(window, key) == GLFW_PRESS;
+    bool pressed = down && !keyDown[key];
+    keyDown[key] = down;
+    return pressed;
+}
+
+// Delete every pooled mesh + buffer
+void Renderer::releaseMeshes() {
+    glState.invalidate();   // deleted names may be reused
+    meshes.forEach([](PoolHandle<Mesh>, Mesh& mesh) { glDeleteVertexArrays(1, &mesh.VAO); });
+    buffers.forEach([](PoolHandle<GpuBuffer>, GpuBuffer& buffer) { glDeleteBuffers(1, &buffer.name); });
+    meshes.clear();
+    buffers.clear();
+    meshCache.clear();
 }
 
 // Cleanup GL resources and terminate GLFW
 void Renderer::cleanup() {
-    ourShader.terminate();
+    deferred.terminate();
+    visibility.terminate();
+    shadowMap.terminate();
+    occluders.terminate();
+    resolution.terminate();
+    oit.terminate();
+    primitives.terminate();
+    atmosphere.terminate();
+    probes.terminate();
+    multiView.terminate();
+    post.terminate();
+    virtualTexture.terminate();
+    forwardTimer.terminate();
+    deferredTimer.terminate();
+    visibilityTimer.terminate();
+    clusters.terminate();
+    hiz.terminate();
+    softCull.terminate();
+    transforms.terminate();
+    releaseMeshes();
+    prepassQuery.terminate();
+    shadedQuery.terminate();
+    shaderVariants.terminate();
     glfwTerminate();
 }
\ No newline at end of file
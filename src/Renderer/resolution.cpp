@@ -0,0 +1,105 @@
+#include "Renderer/resolution.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+// Largest per-update scale change in each direction
+static const float SCALE_STEP_DOWN = 0.10f;
+static const float SCALE_STEP_UP   = 0.02f;
+static const float BUDGET_HEADROOM = 0.9f;      // Aim slightly under budget
+
+void DynamicResolution::init(GLState& glState) {
+    state = &glState;
+}
+
+// Render size from the current scale (or the output size); the target only ever grows
+void DynamicResolution::begin(int w, int h, bool scaled) {
+    outputWidth = std::max(w, 1);
+    outputHeight = std::max(h, 1);
+    float s = scaled ? scale : 1.0f;
+    width = std::max(1, (int)std::lround(outputWidth * s));
+    height = std::max(1, (int)std::lround(outputHeight * s));
+
+    if (outputWidth > allocWidth || outputHeight > allocHeight)
+        allocate(std::max(outputWidth, allocWidth), std::max(outputHeight, allocHeight));
+}
+
+// (Re)create the offscreen target
+void DynamicResolution::allocate(int w, int h) {
+    if (fbo) {
+        state->invalidate();    // deleted names may be reused
+        glDeleteFramebuffers(1, &fbo);
+        glDeleteTextures(1, &colorTexture);
+        glDeleteRenderbuffers(1, &depthStencil);
+    }
+    allocWidth = w;
+    allocHeight = h;
+
+    glGenTextures(1, &colorTexture);
+    state->bindTexture(0, GL_TEXTURE_2D, colorTexture);
+    glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, w, h);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    glGenRenderbuffers(1, &depthStencil);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthStencil);
+    glRenderbufferStorage(GL_RENDERBUFFER, state->depthStencilFormat(), w, h);
+
+    glGenFramebuffers(1, &fbo);
+    state->bindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colorTexture, 0);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depthStencil);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        std::cout << "ERROR::RESOLUTION::FRAMEBUFFER_INCOMPLETE" << std::endl;
+    state->bindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void DynamicResolution::bindTarget() {
+    state->bindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glViewport(0, 0, width, height);
+}
+
+// Stretch the rendered area over the whole window
+void DynamicResolution::present() {
+    state->bindFramebuffer(GL_READ_FRAMEBUFFER, fbo);
+    state->bindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    glBlitFramebuffer(0, 0, width, height, 0, 0, outputWidth, outputHeight,
+                      GL_COLOR_BUFFER_BIT, GL_LINEAR);
+    state->bindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(0, 0, outputWidth, outputHeight);
+}
+
+// Move the scale toward the one that would have met the budget
+void DynamicResolution::update(float gpuMs) {
+    if (gpuMs <= 0.0f) return;
+    ++samples;
+    if (gpuMs > budgetMs) ++misses;
+
+    float target = scale * std::sqrt(budgetMs * BUDGET_HEADROOM / gpuMs);
+    float delta = std::min(std::max(target - scale, -SCALE_STEP_DOWN), SCALE_STEP_UP);
+    scale = std::min(std::max(scale + delta, minScale), maxScale);
+}
+
+int DynamicResolution::renderWidth() const {
+    return width;
+}
+
+int DynamicResolution::renderHeight() const {
+    return height;
+}
+
+float DynamicResolution::getScale() const {
+    return scale;
+}
+
+unsigned int DynamicResolution::framebuffer() const {
+    return fbo;
+}
+
+// Release GL objects
+void DynamicResolution::terminate() {
+    glDeleteFramebuffers(1, &fbo);
+    glDeleteTextures(1, &colorTexture);
+    glDeleteRenderbuffers(1, &depthStencil);
+}
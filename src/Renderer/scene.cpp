@@ -0,0 +1,274 @@
+#include "Renderer/scene.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const char     SCENE_MAGIC[8] = {'S', 'P', 'H', 'S', 'C', 'E', 'N', 'E'};
+static const uint32_t SCENE_BYTE_ORDER = 0x01020304u;
+static const char*    SCENE_SECTION_NAMES[SCENE_SECTION_COUNT] = {
+    "prototypes", "positions", "rotations", "scales", "parents", "prototype index", "colors", "opacity",
+    "light range", "flags"
+};
+static const uint32_t SCENE_ELEMENT_SIZE[SCENE_SECTION_COUNT] = {
+    sizeof(ScenePrototype), sizeof(glm::dvec3), sizeof(glm::quat), sizeof(glm::vec3), sizeof(uint32_t),
+    sizeof(uint32_t), sizeof(glm::vec3), sizeof(float), sizeof(float), sizeof(uint32_t)
+};
+
+struct SceneHeader {
+    char     magic[8];
+    uint32_t version;
+    uint32_t byteOrder;         // SCENE_BYTE_ORDER as written
+    uint64_t sphereCount;
+    uint32_t prototypeCount;
+    uint32_t lightSphere;
+    uint32_t sectionCount;
+    uint32_t reserved;
+    uint64_t checksum;          // Header (this field 0) + section table
+    uint8_t  padding[16];
+};
+static_assert(sizeof(SceneHeader) == 64, "scene header is 64 bytes");
+
+struct SceneSectionEntry {
+    uint32_t id;
+    uint32_t elementSize;
+    uint64_t offset;            // From the start of the file, ALIGNMENT aligned
+    uint64_t size;              // Bytes
+    uint64_t checksum;
+};
+
+static uint64_t rotl(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+// 64-bit checksum, four independent multiply-rotate lanes over 32-byte
+// blocks (the xxHash64 round) so it runs at memory speed
+static uint64_t checksum(const void* data, size_t size, uint64_t seed = 0) {
+    const uint64_t P1 = 0x9E3779B185EBCA87ull, P2 = 0xC2B2AE3D27D4EB4Full;
+    uint64_t lane[4] = {seed + P1 + P2, seed + P2, seed, seed - P1};
+    const unsigned char* p = (const unsigned char*)data;
+    size_t blocks = size / 32;
+    for (size_t b = 0; b < blocks; ++b, p += 32) {
+        for (int k = 0; k < 4; ++k) {
+            uint64_t word;
+            std::memcpy(&word, p + 8 * k, sizeof(word));
+            lane[k] = rotl(lane[k] + word * P2, 31) * P1;
+        }
+    }
+    uint64_t h = rotl(lane[0], 1) + rotl(lane[1], 7) + rotl(lane[2], 12) + rotl(lane[3], 18) + size;
+    for (size_t i = blocks * 32; i < size; ++i, ++p) h = rotl(h ^ (*p * P1), 11) * P2;
+    h ^= h >> 33;
+    h *= P2;
+    h ^= h >> 29;
+    return h;
+}
+
+static uint64_t headerChecksum(SceneHeader header, const SceneSectionEntry* sections) {
+    header.checksum = 0;
+    return checksum(sections, sizeof(SceneSectionEntry) * SCENE_SECTION_COUNT, checksum(&header, sizeof(header)));
+}
+
+static uint64_t alignUp(uint64_t offset) {
+    return (offset + SceneFile::ALIGNMENT - 1) / SceneFile::ALIGNMENT * SceneFile::ALIGNMENT;
+}
+
+SceneFile::~SceneFile() {
+    close();
+}
+
+// Map the file, then check header, section table, every section checksum
+// and the references (parents before children, known prototypes)
+bool SceneFile::open(const std::string& path) {
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cout << "ERROR::SCENE::FILE_NOT_FOUND " << path << std::endl;
+        return false;
+    }
+    struct stat info;
+    size_t size = fstat(fd, &info) == 0 ? (size_t)info.st_size : 0;
+    size_t tableEnd = sizeof(SceneHeader) + sizeof(SceneSectionEntry) * SCENE_SECTION_COUNT;
+    if (size < tableEnd) {
+        ::close(fd);
+        std::cout << "ERROR::SCENE::TRUNCATED " << path << std::endl;
+        return false;
+    }
+    // Private + writable: edits to adopted columns copy the page, never reach the file
+    void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    ::close(fd);                        // The mapping keeps the file
+    if (data == MAP_FAILED) {
+        std::cout << "ERROR::SCENE::MAP_FAILED " << path << std::endl;
+        return false;
+    }
+    madvise(data, size, MADV_WILLNEED);
+    mapping.reset(data, [size](void* p) { munmap(p, size); });
+
+    const unsigned char* bytes = (const unsigned char*)data;
+    SceneHeader header;
+    std::memcpy(&header, bytes, sizeof(header));
+    const SceneSectionEntry* sections = (const SceneSectionEntry*)(bytes + sizeof(SceneHeader));
+    auto fail = [&](const char* what, const char* detail) {
+        std::cout << "ERROR::SCENE::" << what << " " << path << (detail ? " " : "") << (detail ? detail : "") << std::endl;
+        close();
+        return false;
+    };
+    if (std::memcmp(header.magic, SCENE_MAGIC, sizeof(SCENE_MAGIC)) != 0 || header.byteOrder != SCENE_BYTE_ORDER)
+        return fail("BAD_HEADER", nullptr);
+    if (header.version != VERSION) return fail("VERSION", nullptr);
+    if (header.sectionCount != SCENE_SECTION_COUNT || header.checksum != headerChecksum(header, sections))
+        return fail("CHECKSUM", "header");
+
+    const void* columns[SCENE_SECTION_COUNT];
+    for (uint32_t s = 0; s < SCENE_SECTION_COUNT; ++s) {
+        const SceneSectionEntry& section = sections[s];
+        uint64_t elements = s == SCENE_PROTOTYPES ? header.prototypeCount : header.sphereCount;
+        if (section.id != s || section.elementSize != SCENE_ELEMENT_SIZE[s] || section.offset % ALIGNMENT != 0 ||
+            section.size != elements * section.elementSize || section.offset > size || section.size > size - section.offset)
+            return fail("BAD_SECTION", SCENE_SECTION_NAMES[s]);
+        if (checksum(bytes + section.offset, section.size) != section.checksum)
+            return fail("CHECKSUM", SCENE_SECTION_NAMES[s]);
+        columns[s] = bytes + section.offset;
+    }
+
+    size_t count = header.sphereCount;
+    view.count = count;
+    view.positions = (const glm::dvec3*)columns[SCENE_POSITIONS];
+    view.rotations = (const glm::quat*)columns[SCENE_ROTATIONS];
+    view.scales = (const glm::vec3*)columns[SCENE_SCALES];
+    view.parents = (const uint32_t*)columns[SCENE_PARENTS];
+    view.prototypes = (const uint32_t*)columns[SCENE_PROTOTYPE_INDEX];
+    view.colors = (const glm::vec3*)columns[SCENE_COLORS];
+    view.opacity = (const float*)columns[SCENE_OPACITY];
+    view.lightRange = (const float*)columns[SCENE_LIGHT_RANGE];
+    view.flags = (const uint32_t*)columns[SCENE_FLAGS];
+    prototypeView = (const ScenePrototype*)columns[SCENE_PROTOTYPES];
+    prototypeTotal = header.prototypeCount;
+    light = header.lightSphere;
+
+    // The checksums prove the bytes are as written, not that the writer was sane
+    for (uint32_t p = 0; p < prototypeTotal; ++p) {
+        const ScenePrototype& prototype = prototypeView[p];
+        if (!(prototype.radius > 0.0f) || prototype.subdivisions < 1 || prototype.subdivisions > 512)
+            return fail("BAD_PROTOTYPE", nullptr);
+    }
+    bool references = light == NONE || light < count;
+    for (size_t i = 0; i < count && references; ++i)
+        references = (view.parents[i] == NONE || view.parents[i] < i) && view.prototypes[i] < prototypeTotal;
+    if (!references) return fail("BAD_REFERENCE", nullptr);
+    return true;
+}
+
+void SceneFile::close() {
+    mapping.reset();
+    view = SceneColumns();
+    prototypeView = nullptr;
+    prototypeTotal = 0;
+    light = NONE;
+}
+
+const SceneColumns& SceneFile::columns() const {
+    return view;
+}
+
+const ScenePrototype* SceneFile::prototypes() const {
+    return prototypeView;
+}
+
+uint32_t SceneFile::prototypeCount() const {
+    return prototypeTotal;
+}
+
+uint32_t SceneFile::lightSphere() const {
+    return light;
+}
+
+// Columns into freshly appended rows, one createBatch() for the nodes
+// (world positions follow in the next transform update: every node is
+// dirty). Into an empty scene the columns are adopted from the mapping, so
+// only the pages written later get copied; otherwise they are appended.
+uint32_t SceneFile::instantiate(EntityStore& entities, TransformHierarchy& transforms,
+                                std::vector<EntityHandle>& nodeEntity) const {
+    size_t count = view.count;
+    if (entities.size() == 0) {
+        entities.color.adopt(const_cast<glm::vec3*>(view.colors), count, mapping);
+        entities.opacity.adopt(const_cast<float*>(view.opacity), count, mapping);
+        entities.lightRange.adopt(const_cast<float*>(view.lightRange), count, mapping);
+        entities.flags.adopt(const_cast<uint32_t*>(view.flags), count, mapping);
+    } else {
+        entities.color.append(view.colors, count);
+        entities.opacity.append(view.opacity, count);
+        entities.lightRange.append(view.lightRange, count);
+        entities.flags.append(view.flags, count);
+    }
+    uint32_t first = entities.append(count);    // Leaves the columns filled above
+    for (size_t i = 0; i < count; ++i)
+        if (entities.flags[first + i] & ~FLAGS) entities.flags[first + i] &= FLAGS;
+
+    uint32_t firstNode = transforms.createBatch(view.positions, view.rotations, view.scales, view.parents,
+                                                count, mapping);
+    if (nodeEntity.size() < firstNode + count) nodeEntity.resize(firstNode + count);
+    for (uint32_t i = 0; i < count; ++i) {
+        entities.transform[first + i] = firstNode + i;
+        nodeEntity[firstNode + i] = entities.handle(first + i);
+    }
+    return first;
+}
+
+// Header + table first (placeholders), sections at aligned offsets, then the
+// finished header + table over the placeholders; renamed into place at the end
+bool SceneFile::save(const std::string& path, const SceneColumns& columns,
+                     const ScenePrototype* prototypes, uint32_t prototypeCount, uint32_t lightSphere) {
+    const void* data[SCENE_SECTION_COUNT] = {
+        prototypes, columns.positions, columns.rotations, columns.scales, columns.parents,
+        columns.prototypes, columns.colors, columns.opacity, columns.lightRange, columns.flags
+    };
+    SceneHeader header = {};
+    std::memcpy(header.magic, SCENE_MAGIC, sizeof(SCENE_MAGIC));
+    header.version = VERSION;
+    header.byteOrder = SCENE_BYTE_ORDER;
+    header.sphereCount = columns.count;
+    header.prototypeCount = prototypeCount;
+    header.lightSphere = lightSphere;
+    header.sectionCount = SCENE_SECTION_COUNT;
+
+    SceneSectionEntry sections[SCENE_SECTION_COUNT] = {};
+    uint64_t offset = alignUp(sizeof(SceneHeader) + sizeof(sections));
+    for (uint32_t s = 0; s < SCENE_SECTION_COUNT; ++s) {
+        uint64_t elements = s == SCENE_PROTOTYPES ? prototypeCount : columns.count;
+        sections[s].id = s;
+        sections[s].elementSize = SCENE_ELEMENT_SIZE[s];
+        sections[s].offset = offset;
+        sections[s].size = elements * SCENE_ELEMENT_SIZE[s];
+        sections[s].checksum = checksum(data[s], sections[s].size);
+        offset = alignUp(offset + sections[s].size);
+    }
+    header.checksum = headerChecksum(header, sections);
+
+    std::string temporary = path + ".tmp";
+    std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        std::cout << "ERROR::SCENE::WRITE_FAILED " << temporary << std::endl;
+        return false;
+    }
+    out.write((const char*)&header, sizeof(header));
+    out.write((const char*)sections, sizeof(sections));
+    static const char zeros[ALIGNMENT] = {};
+    for (uint32_t s = 0; s < SCENE_SECTION_COUNT; ++s) {
+        out.write(zeros, sections[s].offset - (uint64_t)out.tellp());
+        if (sections[s].size) out.write((const char*)data[s], sections[s].size);
+    }
+    out.close();
+    if (!out || std::rename(temporary.c_str(), path.c_str()) != 0) {
+        std::remove(temporary.c_str());
+        std::cout << "ERROR::SCENE::WRITE_FAILED " << path << std::endl;
+        return false;
+    }
+    return true;
+}
@@ -1,104 +1,303 @@
 #include "Renderer/shader.h"
 
-// Loads, compiles, and links a vertex + fragment shader into a program
-void Shader::load(const char* vertexPath, const char* fragmentPath) {
-    std::string vertexCode;
-    std::string fragmentCode;
+#include <cstring>
+#include <algorithm>
+#include <iterator>
 
-    std::ifstream vShaderFile;
-    std::ifstream fShaderFile;
+// Enables the persistent binary cache (and parallel compile, if the driver has it)
+void Shader::setCache(ProgramCache* programCache) {
+    cache = programCache;
+}
 
-    // Enable exception flags on the file streams
-    vShaderFile.exceptions (std::ifstream::failbit | std::ifstream::badbit);
-    fShaderFile.exceptions (std::ifstream::failbit | std::ifstream::badbit);        
+// Loads, compiles, and links a vertex + fragment shader into a program.
+// Sources are preprocessed (#include resolved, `defines` injected after #version).
+// With a cache, a stored binary for the same sources + driver skips compilation.
+// With async, compile/link are issued and isReady() polls for completion.
+void Shader::load(const char* vertexPath, const char* fragmentPath,
+                  const std::vector<std::string>& defines, bool async) {
+    build({
+        {GL_VERTEX_SHADER,   "VERTEX",   preprocess(vertexPath, defines)},
+        {GL_FRAGMENT_SHADER, "FRAGMENT", preprocess(fragmentPath, defines)}
+    }, async);
+}
 
-    try {
-        // Open shader source files
-        vShaderFile.open(vertexPath);
-        fShaderFile.open(fragmentPath);
+// Loads, compiles, and links vertex + geometry + fragment shaders
+void Shader::loadWithGeometry(const char* vertexPath, const char* geometryPath, const char* fragmentPath,
+                              const std::vector<std::string>& defines, bool async) {
+    build({
+        {GL_VERTEX_SHADER,   "VERTEX",   preprocess(vertexPath, defines)},
+        {GL_GEOMETRY_SHADER, "GEOMETRY", preprocess(geometryPath, defines)},
+        {GL_FRAGMENT_SHADER, "FRAGMENT", preprocess(fragmentPath, defines)}
+    }, async);
+}
 
-        std::stringstream vertexStream, fragmentStream;
+// Loads, compiles, and links a compute shader into a program (same pipeline as load())
+void Shader::loadCompute(const char* computePath, const std::vector<std::string>& defines, bool async) {
+    build({
+        {GL_COMPUTE_SHADER, "COMPUTE", preprocess(computePath, defines)}
+    }, async);
+}
 
-        // Read entire contents into string streams
-        vertexStream   << vShaderFile.rdbuf();
-        fragmentStream << fShaderFile.rdbuf();
+// Restores the program from the binary cache or compiles + links every stage
+void Shader::build(const std::vector<StageSource>& sources, bool async) {
+    ID = glCreateProgram();
+    cached = false;
+    locations.clear();
+    locationNames.clear();
 
-        // Close files
-        vShaderFile.close();
-        fShaderFile.close();
+    // Try the stored binary first (no compiler involvement at all)
+    if (cache) {
+        std::vector<std::string> codes;
+        for (const StageSource& src : sources) codes.push_back(src.code);
+        cacheKey = cache->makeKey(codes);
+        if (cache->load(cacheKey, ID)) {
+            cached = true;
+            pending = false;
+            return;
+        }
+        // A rejected binary leaves the program unusable; start from a fresh object
+        glDeleteProgram(ID);
+        ID = glCreateProgram();
+        ++cache->misses;
+        glProgramParameteri(ID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
 
-        // Convert stream data to std::string
-        vertexCode   = vertexStream.str();
-        fragmentCode = fragmentStream.str();
-    } catch (std::ifstream::failure e) {
-        std::cout << "ERROR::SHADER_FILE::NOT_SUCCESSFULLY_READ" << std::endl;
+    // Create, compile and attach each stage
+    for (const StageSource& src : sources) {
+        const char* code = src.code.c_str();
+        unsigned int shader = glCreateShader(src.type);
+        glShaderSource(shader, 1, &code, NULL);
+        glCompileShader(shader);
+        glAttachShader(ID, shader);
+        stages.push_back({shader, src.name});
     }
 
-    // Raw C-string pointers for OpenGL
-    const char* vCode = vertexCode.c_str();
-    const char* fCode = fragmentCode.c_str();
+    // Link (status queries are what block, so defer them)
+    glLinkProgram(ID);
+
+    pending = true;
+    if (!async) finishLink();
+}
 
-    unsigned int vertex, fragment;
+// Non-blocking readiness check. Without parallel compile support the status
+// query would stall anyway, so the link is simply finished here.
+bool Shader::isReady() {
+    if (!pending) return true;
 
-    // Create and compile vertex shader
-    vertex = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertex, 1, &vCode, NULL);
-    glCompileShader(vertex);
-    checkCompileErrors(vertex, "VERTEX");
+    if (cache && cache->hasParallelCompile()) {
+        int done = 0;
+        glGetProgramiv(ID, GL_COMPLETION_STATUS_KHR, &done);
+        if (!done) return false;
+    }
 
-    // Create and compile fragment shader
-    fragment = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragment, 1, &fCode, NULL);
-    glCompileShader(fragment);
-    checkCompileErrors(fragment, "FRAGMENT");
+    finishLink();
+    return true;
+}
 
-    // Create program and attach compiled shaders
-    ID = glCreateProgram();
-    glAttachShader(ID, vertex);
-    glAttachShader(ID, fragment);
+// True if the last load() was satisfied by the binary cache
+bool Shader::fromCache() const {
+    return cached;
+}
 
-    // Link program
-    glLinkProgram(ID);
+// Completes a build: reports errors, stores the binary and frees the shader objects
+void Shader::finishLink() {
+    for (const auto& stage : stages) checkCompileErrors(stage.first, stage.second);
     checkCompileErrors(ID, "PROGRAM");
 
+    int success = 0;
+    glGetProgramiv(ID, GL_LINK_STATUS, &success);
+    if (success && cache) cache->store(cacheKey, ID);
+
     // Delete individual shader objects (no longer needed after linking)
-    glDeleteShader(vertex);
-    glDeleteShader(fragment);
+    for (const auto& stage : stages) {
+        glDetachShader(ID, stage.first);
+        glDeleteShader(stage.first);
+    }
+    stages.clear();
+    pending = false;
+}
+
+// Produces the final stage source: the root file's #version line, then one
+// #define per entry ("NAME" or "NAME VALUE"), then the body with every
+// #include "file" expanded (paths relative to the including file, each file
+// included once). #line directives keep compiler errors pointing at the
+// original file (source-string number = include order).
+std::string Shader::preprocess(const std::string& path, const std::vector<std::string>& defines) {
+    std::string source = readFile(path.c_str());
+    std::ostringstream out;
+
+    // #version must stay first; defines go right after it
+    std::istringstream in(source);
+    std::string line;
+    int lineNumber = 0;
+    if (source.compare(0, 8, "#version") == 0 && std::getline(in, line)) {
+        out << line << "\n";
+        ++lineNumber;
+    }
+    for (const std::string& define : defines) {
+        out << "#define " << define << "\n";
+    }
+    if (state && state->reversedDepth()) out << "#define REVERSE_Z\n";   // Depth convention (depth.glsl)
+
+    std::unordered_set<std::string> included{path};
+    int fileIndex = 0;
+    out << "#line " << lineNumber + 1 << " 0\n";
+
+    std::string rest((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    std::istringstream body(rest);
+    std::string dir = path.substr(0, path.find_last_of("/\\") + 1);
+    while (std::getline(body, line)) {
+        ++lineNumber;
+        size_t q1, q2;
+        if (line.compare(0, 8, "#include") == 0 &&
+            (q1 = line.find('"')) != std::string::npos &&
+            (q2 = line.find('"', q1 + 1)) != std::string::npos) {
+            expandIncludes(dir + line.substr(q1 + 1, q2 - q1 - 1), out, included, fileIndex);
+            out << "#line " << lineNumber + 1 << " 0\n";
+            continue;
+        }
+        out << line << "\n";
+    }
+    return out.str();
+}
+
+// Appends an included file (recursively) to `out`
+void Shader::expandIncludes(const std::string& path, std::ostringstream& out,
+                            std::unordered_set<std::string>& included,
+                            int& fileIndex) {
+    if (!included.insert(path).second) return;  // already included (implicit #pragma once)
+
+    int index = ++fileIndex;
+    std::string dir = path.substr(0, path.find_last_of("/\\") + 1);
+    std::istringstream in(readFile(path.c_str()));
+    std::string line;
+    int lineNumber = 0;
+
+    out << "#line 1 " << index << "\n";
+    while (std::getline(in, line)) {
+        ++lineNumber;
+        if (line.compare(0, 8, "#version") == 0) {
+            out << "\n";                        // only the root file declares a version
+            continue;
+        }
+        size_t q1, q2;
+        if (line.compare(0, 8, "#include") == 0 &&
+            (q1 = line.find('"')) != std::string::npos &&
+            (q2 = line.find('"', q1 + 1)) != std::string::npos) {
+            expandIncludes(dir + line.substr(q1 + 1, q2 - q1 - 1), out, included, fileIndex);
+            out << "#line " << lineNumber + 1 << " " << index << "\n";
+            continue;
+        }
+        out << line << "\n";
+    }
+}
+
+// Reads an entire shader source file into a string
+std::string Shader::readFile(const char* path) {
+    std::ifstream file;
+
+    // Enable exception flags on the file stream
+    file.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+
+    try {
+        file.open(path);
+        std::stringstream stream;
+        stream << file.rdbuf();
+        file.close();
+        return stream.str();
+    } catch (const std::ifstream::failure& e) {
+        std::cout << "ERROR::SHADER_FILE::NOT_SUCCESSFULLY_READ " << path << std::endl;
+    }
+    return std::string();
+}
+
+// Routes binds and uniform accounting through the renderer's GL state cache
+void Shader::setState(GLState* glState) {
+    state = glState;
 }
 
 // Activates the shader program
 void Shader::use() {
-    glUseProgram(ID);
+    if (state) state->useProgram(ID);
+    else glUseProgram(ID);
 }
 
 // Deletes the shader program
 void Shader::terminate() {
+    if (state && ID) state->invalidate();   // the deleted name may be reused
     glDeleteProgram(ID);
+    locations.clear();
+    locationNames.clear();
 }
 
 // Sets a boolean (int) uniform
 void Shader::setBool(const char* name, int value) const {
-    glUniform1i(glGetUniformLocation(ID, name), (int)value);
+    glUniform1i(location(name), (int)value);
+    if (state) state->countUniform(sizeof(int));
 }
 
 // Sets an integer uniform
 void Shader::setInt(std::string &name, int value) const {
-    glUniform1i(glGetUniformLocation(ID, name.c_str()), value);
+    glUniform1i(location(name.c_str()), value);
+    if (state) state->countUniform(sizeof(int));
+}
+
+// Sets an integer uniform
+void Shader::setInt(const char* name, int value) const {
+    glUniform1i(location(name), value);
+    if (state) state->countUniform(sizeof(int));
+}
+
+// Sets an unsigned integer uniform
+void Shader::setUint(const char* name, unsigned int value) const {
+    glUniform1ui(location(name), value);
+    if (state) state->countUniform(sizeof(unsigned int));
 }
 
 // Sets a float uniform
 void Shader::setFloat(std::string &name, float value) const {
-    glUniform1f(glGetUniformLocation(ID, name.c_str()), value);
+    glUniform1f(location(name.c_str()), value);
+    if (state) state->countUniform(sizeof(float));
+}
+
+// Sets a float uniform
+void Shader::setFloat(const char* name, float value) const {
+    glUniform1f(location(name), value);
+    if (state) state->countUniform(sizeof(float));
+}
+
+// Sets a vec2 uniform
+void Shader::setVec2(const char* name, const glm::vec2& vec2) const {
+    glUniform2fv(location(name), 1, &vec2[0]);
+    if (state) state->countUniform(sizeof(glm::vec2));
 }
 
 // Sets a vec3 uniform
 void Shader::setVec3(const char* name, const glm::vec3& vec3) const {
-    glUniform3fv(glGetUniformLocation(ID, name), 1, &vec3[0]);
+    glUniform3fv(location(name), 1, &vec3[0]);
+    if (state) state->countUniform(sizeof(glm::vec3));
+}
+
+// Sets a vec4 uniform
+void Shader::setVec4(const char* name, const glm::vec4& vec4) const {
+    glUniform4fv(location(name), 1, &vec4[0]);
+    if (state) state->countUniform(sizeof(glm::vec4));
 }
 
 // Sets a mat4 uniform
 void Shader::setMat4(const char* name, glm::mat4 mat) const {
-    glUniformMatrix4fv(glGetUniformLocation(ID, name), 1, GL_FALSE, &mat[0][0]);
+    glUniformMatrix4fv(location(name), 1, GL_FALSE, &mat[0][0]);
+    if (state) state->countUniform(sizeof(glm::mat4));
+}
+
+// Cached uniform location lookup (one glGetUniformLocation per name per program)
+int Shader::location(const char* name) const {
+    auto it = locations.find(std::string_view(name));
+    if (it != locations.end()) return it->second;
+    int loc = glGetUniformLocation(ID, name);
+    locationNames.emplace_back(name);
+    locations.emplace(locationNames.back(), loc);
+    return loc;
 }
 
 // Checks compile or link errors for a shader or program
@@ -107,7 +306,7 @@ void Shader::checkCompileErrors(unsigned int shader, const char* type) {
     char infoLog[1024];
 
     // Shader object error path
-    if (type != "PROGRAM") {
+    if (std::strcmp(type, "PROGRAM") != 0) {
         glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
         if (!success) {
             glGetShaderInfoLog(shader, 1024, NULL, infoLog);
@@ -123,4 +322,98 @@ void Shader::checkCompileErrors(unsigned int shader, const char* type) {
                       << "\n" << infoLog << std::endl;
         }
     }
+}
+
+// Binary cache handed to every variant built from now on
+void ShaderVariants::setCache(ProgramCache* programCache) {
+    cache = programCache;
+}
+
+// GL state cache handed to every variant built from now on
+void ShaderVariants::setState(GLState* glState) {
+    state = glState;
+}
+
+// Looks up (or builds) the program for a source pair + define set.
+// Define order does not matter: the key uses the sorted list.
+Shader& ShaderVariants::get(const char* vertexPath, const char* fragmentPath,
+                            const std::vector<std::string>& defines, bool async) {
+    std::vector<std::string> sorted = defines;
+    std::string key = makeKey({vertexPath, fragmentPath}, sorted);
+
+    auto it = variants.find(key);
+    if (it != variants.end()) return *programs.get(it->second);
+
+    PoolHandle<Shader> handle = programs.create();
+    variants[key] = handle;
+    Shader& shader = *programs.get(handle);
+    shader.setCache(cache);
+    shader.setState(state);
+    shader.load(vertexPath, fragmentPath, sorted, async);
+    return shader;
+}
+
+// Looks up (or builds) a program with a geometry stage
+Shader& ShaderVariants::getWithGeometry(const char* vertexPath, const char* geometryPath,
+                                        const char* fragmentPath,
+                                        const std::vector<std::string>& defines, bool async) {
+    std::vector<std::string> sorted = defines;
+    std::string key = makeKey({vertexPath, geometryPath, fragmentPath}, sorted);
+
+    auto it = variants.find(key);
+    if (it != variants.end()) return *programs.get(it->second);
+
+    PoolHandle<Shader> handle = programs.create();
+    variants[key] = handle;
+    Shader& shader = *programs.get(handle);
+    shader.setCache(cache);
+    shader.setState(state);
+    shader.loadWithGeometry(vertexPath, geometryPath, fragmentPath, sorted, async);
+    return shader;
+}
+
+// Looks up (or builds) a compute program for a source + define set
+Shader& ShaderVariants::getCompute(const char* computePath,
+                                   const std::vector<std::string>& defines, bool async) {
+    std::vector<std::string> sorted = defines;
+    std::string key = makeKey({computePath}, sorted);
+
+    auto it = variants.find(key);
+    if (it != variants.end()) return *programs.get(it->second);
+
+    PoolHandle<Shader> handle = programs.create();
+    variants[key] = handle;
+    Shader& shader = *programs.get(handle);
+    shader.setCache(cache);
+    shader.setState(state);
+    shader.loadCompute(computePath, sorted, async);
+    return shader;
+}
+
+// "path|path|DEFINE|DEFINE" with defines sorted
+std::string ShaderVariants::makeKey(const std::vector<const char*>& paths, std::vector<std::string>& defines) {
+    std::sort(defines.begin(), defines.end());
+    std::string key;
+    for (const char* path : paths) key += std::string(path) + "|";
+    for (const std::string& define : defines) key += "|" + define;
+    return key;
+}
+
+// Polls every pending variant (all of them, so they keep progressing)
+bool ShaderVariants::isReady() {
+    bool ready = true;
+    programs.forEach([&](PoolHandle<Shader>, Shader& shader) { ready = shader.isReady() && ready; });
+    return ready;
+}
+
+// Number of distinct compiled permutations
+size_t ShaderVariants::size() const {
+    return variants.size();
+}
+
+// Deletes all variant programs
+void ShaderVariants::terminate() {
+    programs.forEach([](PoolHandle<Shader>, Shader& shader) { shader.terminate(); });
+    programs.clear();
+    variants.clear();
 }
\ No newline at end of file
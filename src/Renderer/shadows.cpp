@@ -0,0 +1,133 @@
+#include "Renderer/shadows.h"
+#include "config.h"
+
+// Near plane of the cube faces (casters closer than this to the light are clipped)
+static const float SHADOW_NEAR = 0.05f;
+
+// Create both cube maps, their layered framebuffers and the caster program
+void PointShadowMap::init(ShaderVariants& shaders, GLState& glState) {
+    state = &glState;
+    shader = &shaders.getWithGeometry(SHADOW_VSHADER_PATH, SHADOW_GSHADER_PATH, SHADOW_FSHADER_PATH, {}, true);
+
+    auto makeCube = [&](unsigned int& map, unsigned int& fbo) {
+        glGenTextures(1, &map);
+        state->bindTexture(0, GL_TEXTURE_CUBE_MAP, map);
+        glTexStorage2D(GL_TEXTURE_CUBE_MAP, 1, GL_DEPTH_COMPONENT32F, SIZE, SIZE);
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+
+        // Whole cube attached as a layered target (layer = face)
+        glGenFramebuffers(1, &fbo);
+        state->bindFramebuffer(GL_FRAMEBUFFER, fbo);
+        glFramebufferTexture(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, map, 0);
+        glDrawBuffer(GL_NONE);
+        glReadBuffer(GL_NONE);
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+            std::cout << "ERROR::SHADOWS::FRAMEBUFFER_INCOMPLETE" << std::endl;
+    };
+    makeCube(staticMap, staticFbo);
+    makeCube(frameMap, frameFbo);
+    state->bindFramebuffer(GL_FRAMEBUFFER, 0);
+    sampled = staticMap;
+}
+
+// Rebuild the static cache only when the light or a static caster changed
+bool PointShadowMap::beginStatic(const glm::vec3& light, float lightRange,
+                                 const std::vector<glm::vec4>& staticCasters) {
+    lightPos = light;
+    range = lightRange;
+    glm::vec4 key(light, lightRange);
+
+    hit = cacheValid && key == cachedLight && staticCasters == cachedCasters;
+    if (hit) return false;
+
+    cachedLight = key;
+    cachedCasters = staticCasters;
+    cacheValid = true;
+    ++staticRenders;
+
+    setupPass(staticFbo);
+    glClear(GL_DEPTH_BUFFER_BIT);
+    return true;
+}
+
+void PointShadowMap::endStatic() {
+    state->bindFramebuffer(GL_FRAMEBUFFER, 0);
+    state->setStandardDepth(false);
+}
+
+// Start the frame map from the static cache, then let dynamic casters draw on top
+bool PointShadowMap::beginDynamic(size_t dynamicCasters) {
+    if (dynamicCasters == 0) {
+        sampled = staticMap;
+        return false;
+    }
+    glCopyImageSubData(staticMap, GL_TEXTURE_CUBE_MAP, 0, 0, 0, 0,
+                       frameMap, GL_TEXTURE_CUBE_MAP, 0, 0, 0, 0, SIZE, SIZE, 6);
+    setupPass(frameFbo);
+    sampled = frameMap;
+    return true;
+}
+
+void PointShadowMap::endDynamic() {
+    state->bindFramebuffer(GL_FRAMEBUFFER, 0);
+    state->setStandardDepth(false);
+}
+
+// Bind a layered target and upload the six face view-projections. The faces
+// use a standard finite projection, so the pass runs in standard depth even
+// when the camera's depth is reversed (endStatic / endDynamic switch back)
+void PointShadowMap::setupPass(unsigned int fbo) {
+    state->bindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glViewport(0, 0, SIZE, SIZE);
+    state->setStandardDepth(true);
+    state->setDepthTest(true);
+    state->setDepthWrite(true);
+    state->setDepthFunc(GL_LESS);
+
+    // GL cube face order: +X, -X, +Y, -Y, +Z, -Z
+    static const glm::vec3 dirs[6] = {
+        { 1, 0, 0}, {-1, 0, 0}, {0,  1, 0}, {0, -1, 0}, {0, 0,  1}, {0, 0, -1}
+    };
+    static const glm::vec3 ups[6] = {
+        {0, -1, 0}, {0, -1, 0}, {0, 0,  1}, {0, 0, -1}, {0, -1, 0}, {0, -1, 0}
+    };
+    glm::mat4 projection = glm::perspective(glm::radians(90.0f), 1.0f, SHADOW_NEAR, range);
+
+    shader->use();
+    for (int face = 0; face < 6; ++face) {
+        std::string name = "faceMatrices[" + std::to_string(face) + "]";
+        shader->setMat4(name.c_str(), projection * glm::lookAt(lightPos, lightPos + dirs[face], ups[face]));
+    }
+    shader->setVec3("lightPos", lightPos);
+    shader->setFloat("range", range);
+}
+
+Shader& PointShadowMap::casterShader() {
+    return *shader;
+}
+
+// Sampler + light uniforms read by shadow.glsl
+void PointShadowMap::bind(Shader& lit, unsigned int unit) {
+    state->bindTexture(unit, GL_TEXTURE_CUBE_MAP, sampled);
+    lit.setInt("shadowMap", (int)unit);
+    lit.setVec3("shadowLightPos", lightPos);
+    lit.setFloat("shadowRange", range);
+}
+
+bool PointShadowMap::cacheHit() const {
+    return hit;
+}
+
+// Release GL objects
+void PointShadowMap::terminate() {
+    glDeleteFramebuffers(1, &staticFbo);
+    glDeleteFramebuffers(1, &frameFbo);
+    glDeleteTextures(1, &staticMap);
+    glDeleteTextures(1, &frameMap);
+}
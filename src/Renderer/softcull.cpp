@@ -0,0 +1,288 @@
+#include "Renderer/softcull.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+// Bounds covering at most this many pixels are refined per pixel after the tile test
+static const int PIXEL_TEST_AREA = 1024;
+
+SoftwareOcclusion::SoftwareOcclusion()
+    : depth(WIDTH * HEIGHT, 1.0f), tileMax(TILES_X * TILES_Y, 1.0f) {
+    buildHull();
+}
+
+SoftwareOcclusion::~SoftwareOcclusion() {
+    terminate();
+}
+
+// Start the band workers (no more than there are tile rows)
+void SoftwareOcclusion::init(unsigned int count) {
+    if (count == 0) count = WorkerPool::defaultSize();
+    workers.init(std::min<unsigned int>(count, TILES_Y));
+}
+
+// Unit icosahedron: every vertex triple at edge length is a face, wound outward
+void SoftwareOcclusion::buildHull() {
+    const float phi = (1.0f + std::sqrt(5.0f)) * 0.5f;
+    std::vector<glm::vec3> v;
+    for (float a : {-1.0f, 1.0f})
+        for (float b : {-phi, phi}) {
+            v.push_back(glm::vec3(0.0f, a, b));
+            v.push_back(glm::vec3(a, b, 0.0f));
+            v.push_back(glm::vec3(b, 0.0f, a));
+        }
+
+    auto isEdge = [&](size_t i, size_t j) {
+        glm::vec3 d = v[i] - v[j];
+        return std::fabs(glm::dot(d, d) - 4.0f) < 1e-3f;
+    };
+
+    hull.clear();
+    for (size_t i = 0; i < v.size(); ++i)
+        for (size_t j = i + 1; j < v.size(); ++j)
+            for (size_t k = j + 1; k < v.size(); ++k) {
+                if (!isEdge(i, j) || !isEdge(j, k) || !isEdge(i, k)) continue;
+                glm::vec3 a = glm::normalize(v[i]), b = glm::normalize(v[j]), c = glm::normalize(v[k]);
+                if (glm::dot(glm::cross(b - a, c - a), a + b + c) < 0.0f) std::swap(b, c);
+                hull.push_back(a);
+                hull.push_back(b);
+                hull.push_back(c);
+            }
+}
+
+// Rasterise the occluders, then test every bound against the result
+void SoftwareOcclusion::cull(const std::vector<glm::vec4>& occluders,
+                             const std::vector<glm::vec4>& bounds,
+                             const glm::mat4& viewProjection) {
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point start = Clock::now();
+
+    setupTriangles(occluders, viewProjection);
+
+    unsigned int bands = workers.size();
+    if (bands == 0) {
+        rasterizeBand(0, TILES_Y);
+    } else {
+        workers.run([this, bands](unsigned int index) {
+            rasterizeBand((int)(index * TILES_Y / bands), (int)((index + 1) * TILES_Y / bands));
+        });
+    }
+    Clock::time_point rastered = Clock::now();
+
+    stats.tested = (unsigned int)bounds.size();
+    stats.drawn = stats.occluded = stats.frustumCulled = 0;
+    visible.resize(bounds.size());
+    for (size_t i = 0; i < bounds.size(); ++i) {
+        visible[i] = testBounds(bounds[i], viewProjection);
+        if (visible[i]) ++stats.drawn;
+    }
+
+    stats.rasterMs = std::chrono::duration<float, std::milli>(rastered - start).count();
+    stats.testMs   = std::chrono::duration<float, std::milli>(Clock::now() - rastered).count();
+}
+
+// Project every occluder's hull; occluders crossing the near plane are skipped
+void SoftwareOcclusion::setupTriangles(const std::vector<glm::vec4>& occluders,
+                                       const glm::mat4& viewProjection) {
+    triangles.clear();
+    std::vector<glm::vec3> screen(hull.size());
+
+    for (const glm::vec4& o : occluders) {
+        bool clipped = false;
+        for (size_t i = 0; i < hull.size() && !clipped; ++i) {
+            glm::vec4 clip = viewProjection * glm::vec4(glm::vec3(o) + hull[i] * o.w, 1.0f);
+            if (clip.w <= 1e-5f || clip.z < -clip.w) { clipped = true; break; }
+            glm::vec3 ndc = glm::vec3(clip) / clip.w;
+            screen[i] = glm::vec3((ndc.x * 0.5f + 0.5f) * WIDTH,
+                                  (ndc.y * 0.5f + 0.5f) * HEIGHT,
+                                  ndc.z * 0.5f + 0.5f);
+        }
+        if (clipped) continue;
+
+        for (size_t i = 0; i < hull.size(); i += 3) {
+            const glm::vec3& v0 = screen[i];
+            const glm::vec3& v1 = screen[i + 1];
+            const glm::vec3& v2 = screen[i + 2];
+
+            // Back-facing or degenerate in window space (y up, CCW front)
+            float area = (v1.x - v0.x) * (v2.y - v0.y) - (v2.x - v0.x) * (v1.y - v0.y);
+            if (area <= 0.0f) continue;
+
+            Triangle t;
+            t.minX = std::max(0, (int)std::floor(std::min({v0.x, v1.x, v2.x})));
+            t.maxX = std::min(WIDTH - 1, (int)std::ceil(std::max({v0.x, v1.x, v2.x})));
+            t.minY = std::max(0, (int)std::floor(std::min({v0.y, v1.y, v2.y})));
+            t.maxY = std::min(HEIGHT - 1, (int)std::ceil(std::max({v0.y, v1.y, v2.y})));
+            if (t.minX > t.maxX || t.minY > t.maxY) continue;
+
+            const glm::vec3* v[3] = {&v0, &v1, &v2};
+            for (int e = 0; e < 3; ++e) {
+                const glm::vec3& a = *v[e];
+                const glm::vec3& b = *v[(e + 1) % 3];
+                t.edgeA[e] = a.y - b.y;
+                t.edgeB[e] = b.x - a.x;
+                t.edgeC[e] = a.x * b.y - a.y * b.x;
+            }
+
+            t.zA = ((v1.z - v0.z) * (v2.y - v0.y) - (v2.z - v0.z) * (v1.y - v0.y)) / area;
+            t.zB = ((v2.z - v0.z) * (v1.x - v0.x) - (v1.z - v0.z) * (v2.x - v0.x)) / area;
+            t.zC = v0.z - t.zA * v0.x - t.zB * v0.y;
+            triangles.push_back(t);
+        }
+    }
+    stats.triangles = (unsigned int)triangles.size();
+}
+
+// Clear, rasterise and reduce tile rows [firstTileRow, lastTileRow)
+void SoftwareOcclusion::rasterizeBand(int firstTileRow, int lastTileRow) {
+    int y0 = firstTileRow * TILE, y1 = lastTileRow * TILE;
+    std::fill(depth.begin() + y0 * WIDTH, depth.begin() + y1 * WIDTH, 1.0f);
+
+    for (const Triangle& t : triangles)
+        if (t.maxY >= y0 && t.minY < y1) rasterizeRows(t, y0, y1);
+
+    for (int ty = firstTileRow; ty < lastTileRow; ++ty)
+        for (int tx = 0; tx < TILES_X; ++tx) {
+            float farthest = 0.0f;
+            for (int y = ty * TILE; y < (ty + 1) * TILE; ++y) {
+                const float* row = &depth[y * WIDTH + tx * TILE];
+                for (int x = 0; x < TILE; ++x) farthest = std::max(farthest, row[x]);
+            }
+            tileMax[ty * TILES_X + tx] = farthest;
+        }
+}
+
+// Depth-tested (keep nearest) coverage of one triangle over rows [y0, y1),
+// sampled at pixel centres, 8 pixels per step from an 8-aligned start
+void SoftwareOcclusion::rasterizeRows(const Triangle& t, int y0, int y1) {
+    int rowStart = std::max(t.minY, y0);
+    int rowEnd   = std::min(t.maxY + 1, y1);
+    int xStart   = t.minX & ~(TILE - 1);
+
+#if defined(__AVX2__)
+    const __m256 lane = _mm256_setr_ps(0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 a0 = _mm256_set1_ps(t.edgeA[0]);
+    const __m256 a1 = _mm256_set1_ps(t.edgeA[1]);
+    const __m256 a2 = _mm256_set1_ps(t.edgeA[2]);
+    const __m256 za = _mm256_set1_ps(t.zA);
+
+    for (int y = rowStart; y < rowEnd; ++y) {
+        float py = (float)y + 0.5f;
+        const __m256 r0 = _mm256_set1_ps(t.edgeB[0] * py + t.edgeC[0]);
+        const __m256 r1 = _mm256_set1_ps(t.edgeB[1] * py + t.edgeC[1]);
+        const __m256 r2 = _mm256_set1_ps(t.edgeB[2] * py + t.edgeC[2]);
+        const __m256 rz = _mm256_set1_ps(t.zB * py + t.zC);
+        float* row = &depth[y * WIDTH];
+
+        for (int x = xStart; x <= t.maxX; x += 8) {
+            __m256 px = _mm256_add_ps(_mm256_set1_ps((float)x), lane);
+            __m256 e0 = _mm256_add_ps(_mm256_mul_ps(a0, px), r0);
+            __m256 e1 = _mm256_add_ps(_mm256_mul_ps(a1, px), r1);
+            __m256 e2 = _mm256_add_ps(_mm256_mul_ps(a2, px), r2);
+            __m256 inside = _mm256_and_ps(_mm256_and_ps(_mm256_cmp_ps(e0, zero, _CMP_GE_OQ),
+                                                        _mm256_cmp_ps(e1, zero, _CMP_GE_OQ)),
+                                          _mm256_cmp_ps(e2, zero, _CMP_GE_OQ));
+            if (_mm256_testz_ps(inside, inside)) continue;
+
+            __m256 z = _mm256_add_ps(_mm256_mul_ps(za, px), rz);
+            __m256 old = _mm256_loadu_ps(row + x);
+            _mm256_storeu_ps(row + x, _mm256_blendv_ps(old, _mm256_min_ps(old, z), inside));
+        }
+    }
+#else
+    for (int y = rowStart; y < rowEnd; ++y) {
+        float py = (float)y + 0.5f;
+        float* row = &depth[y * WIDTH];
+        for (int x = xStart; x <= t.maxX; ++x) {
+            float px = (float)x + 0.5f;
+            if (t.edgeA[0] * px + t.edgeB[0] * py + t.edgeC[0] < 0.0f) continue;
+            if (t.edgeA[1] * px + t.edgeB[1] * py + t.edgeC[1] < 0.0f) continue;
+            if (t.edgeA[2] * px + t.edgeB[2] * py + t.edgeC[2] < 0.0f) continue;
+            row[x] = std::min(row[x], t.zA * px + t.zB * py + t.zC);
+        }
+    }
+#endif
+}
+
+// Frustum + occlusion test of one bound (xyz centre, w radius), same rules as
+// the Hi-Z cull shader: projected AABB corners, nearest corner vs farthest depth
+bool SoftwareOcclusion::testBounds(const glm::vec4& b, const glm::mat4& viewProjection) {
+    glm::vec3 ndcMin(1e30f), ndcMax(-1e30f);
+    for (int c = 0; c < 8; ++c) {
+        glm::vec3 corner = glm::vec3(b) + b.w * glm::vec3((c & 1) ? 1.0f : -1.0f,
+                                                         (c & 2) ? 1.0f : -1.0f,
+                                                         (c & 4) ? 1.0f : -1.0f);
+        glm::vec4 clip = viewProjection * glm::vec4(corner, 1.0f);
+        if (clip.w <= 1e-5f) return true;       // Crosses the camera plane
+        glm::vec3 ndc = glm::vec3(clip) / clip.w;
+        ndcMin = glm::min(ndcMin, ndc);
+        ndcMax = glm::max(ndcMax, ndc);
+    }
+
+    if (ndcMax.x < -1.0f || ndcMin.x > 1.0f || ndcMax.y < -1.0f || ndcMin.y > 1.0f || ndcMin.z > 1.0f) {
+        ++stats.frustumCulled;
+        return false;
+    }
+    if (ndcMin.z <= -1.0f) return true;
+
+    int x0 = std::min(std::max((int)((ndcMin.x * 0.5f + 0.5f) * WIDTH), 0), WIDTH - 1);
+    int x1 = std::min(std::max((int)((ndcMax.x * 0.5f + 0.5f) * WIDTH), 0), WIDTH - 1);
+    int y0 = std::min(std::max((int)((ndcMin.y * 0.5f + 0.5f) * HEIGHT), 0), HEIGHT - 1);
+    int y1 = std::min(std::max((int)((ndcMax.y * 0.5f + 0.5f) * HEIGHT), 0), HEIGHT - 1);
+    float nearest = ndcMin.z * 0.5f + 0.5f;
+
+    // Tiles first: their farthest depth covers the rectangle and more
+    float farthest = 0.0f;
+    for (int ty = y0 / TILE; ty <= y1 / TILE; ++ty)
+        for (int tx = x0 / TILE; tx <= x1 / TILE; ++tx)
+            farthest = std::max(farthest, tileMax[ty * TILES_X + tx]);
+
+    // Small rectangles: exact farthest depth over the covered pixels
+    if (nearest <= farthest && (x1 - x0 + 1) * (y1 - y0 + 1) <= PIXEL_TEST_AREA) {
+        farthest = 0.0f;
+        for (int y = y0; y <= y1; ++y)
+            for (int x = x0; x <= x1; ++x)
+                farthest = std::max(farthest, depth[y * WIDTH + x]);
+    }
+
+    if (nearest > farthest) {
+        ++stats.occluded;
+        return false;
+    }
+    return true;
+}
+
+bool SoftwareOcclusion::isVisible(size_t index) const {
+    return index >= visible.size() || visible[index];
+}
+
+const SoftCullStats& SoftwareOcclusion::getStats() const {
+    return stats;
+}
+
+const float* SoftwareOcclusion::depthBuffer() const {
+    return depth.data();
+}
+
+unsigned int SoftwareOcclusion::workerCount() const {
+    return workers.size();
+}
+
+bool SoftwareOcclusion::simd() const {
+#if defined(__AVX2__)
+    return true;
+#else
+    return false;
+#endif
+}
+
+// Stop and join the workers
+void SoftwareOcclusion::terminate() {
+    workers.terminate();
+}
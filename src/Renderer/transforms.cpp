@@ -0,0 +1,533 @@
+#include "Renderer/transforms.h"
+
+#include <algorithm>
+#include <chrono>
+
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
+// out = a * b (column-major, out must not alias a or b)
+static void multiply(const glm::mat4& a, const glm::mat4& b, glm::mat4& out) {
+#if defined(__SSE__)
+    const float* pa = &a[0][0];
+    const float* pb = &b[0][0];
+    float* po = &out[0][0];
+    __m128 a0 = _mm_loadu_ps(pa);
+    __m128 a1 = _mm_loadu_ps(pa + 4);
+    __m128 a2 = _mm_loadu_ps(pa + 8);
+    __m128 a3 = _mm_loadu_ps(pa + 12);
+    for (int j = 0; j < 4; ++j) {
+        const float* column = pb + 4 * j;
+        __m128 r = _mm_mul_ps(a0, _mm_set1_ps(column[0]));
+        r = _mm_add_ps(r, _mm_mul_ps(a1, _mm_set1_ps(column[1])));
+        r = _mm_add_ps(r, _mm_mul_ps(a2, _mm_set1_ps(column[2])));
+        r = _mm_add_ps(r, _mm_mul_ps(a3, _mm_set1_ps(column[3])));
+        _mm_storeu_ps(po + 4 * j, r);
+    }
+#else
+    out = a * b;
+#endif
+}
+
+TransformHierarchy::~TransformHierarchy() {
+    terminate();
+}
+
+// Start the chunk workers
+void TransformHierarchy::init(unsigned int count) {
+    workers.init(count);
+    workerChanged.assign(workers.size(), {});
+}
+
+// New node at the end of its level (appended when a re-sort is pending)
+uint32_t TransformHierarchy::create(const glm::dvec3& position, uint32_t parent) {
+    uint32_t id;
+    if (!freeIds.empty()) {
+        id = freeIds.back();
+        freeIds.pop_back();
+    } else {
+        id = (uint32_t)idIndex.size();
+        idIndex.push_back(NONE);
+        idParent.push_back(NONE);
+        idFirstChild.push_back(NONE);
+        idNextSibling.push_back(NONE);
+        idPrevSibling.push_back(NONE);
+    }
+    uint32_t level = parent == NONE ? 0 : depth[idIndex[parent]] + 1;
+    idParent[id] = parent;
+    idFirstChild[id] = NONE;
+    if (parent != NONE) link(id, parent);
+
+    Slot slot{parent, level, position, glm::quat(1.0f, 0.0f, 0.0f, 0.0f), glm::vec3(1.0f),
+              position, glm::mat4(1.0f), 0, 0, id};
+    uint32_t index = insertSlot(level);
+    writeSlot(index, slot);
+    markDirty(index);
+    return id;
+}
+
+// Append a batch with fresh ids (free ids are left to create()); stays
+// sorted when the batch's depths never decrease from the current last node.
+// Only what the first update() reads is written here: world results and
+// stamps wait for it (every batch node is dirty), sibling links exist only
+// under a parent, and adopted columns are not copied at all.
+uint32_t TransformHierarchy::createBatch(const glm::dvec3* positions, const glm::quat* rotations,
+                                         const glm::vec3* scales, const uint32_t* parents, size_t count,
+                                         std::shared_ptr<void> owner) {
+    uint32_t first = (uint32_t)idIndex.size();
+    uint32_t base = (uint32_t)sortedId.size();
+    size_t total = base + count;
+    if (count == 0) return first;
+
+    // Empty: ids and positions both start at 0, so batch-relative parents are node ids
+    bool adopt = owner && first == 0 && base == 0;
+    if (adopt) {
+        localPosition.adopt(const_cast<glm::dvec3*>(positions), count, owner);
+        if (rotations) localRotation.adopt(const_cast<glm::quat*>(rotations), count, owner);
+        if (scales) localScale.adopt(const_cast<glm::vec3*>(scales), count, owner);
+        if (parents) idParent.adopt(const_cast<uint32_t*>(parents), count, owner);
+    } else {
+        localPosition.append(positions, count);
+        if (rotations) localRotation.append(rotations, count);
+        if (scales) localScale.append(scales, count);
+    }
+    localRotation.resize(total, glm::quat(1.0f, 0.0f, 0.0f, 0.0f));
+    localScale.resize(total, glm::vec3(1.0f));
+    bool parentsAdopted = idParent.size() == first + count;
+    idParent.resize(first + count, NONE);
+
+    idIndex.resizeUninitialized(first + count);
+    idFirstChild.resize(first + count, NONE);
+    idNextSibling.resizeUninitialized(first + count);
+    idPrevSibling.resizeUninitialized(first + count);
+    sortedId.resizeUninitialized(total);
+    parentId.resizeUninitialized(total);
+    depth.resizeUninitialized(total);
+    worldTranslation.resizeUninitialized(total);
+    worldMatrix.resizeUninitialized(total);
+    dirty.resize(total, 1);
+    stamp.resizeUninitialized(total);
+
+    bool sorted = !orderDirty;
+    uint32_t previous = base > 0 ? depth[base - 1] : 0;
+    uint32_t deepest = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        uint32_t index = base + i;
+        uint32_t id = first + i;
+        uint32_t parent = parents ? parents[i] : NONE;
+        uint32_t level = 0;
+        parentId[index] = NONE;
+        if (parent != NONE) {
+            if (!parentsAdopted) idParent[id] = first + parent;    // A write would copy the page
+            link(id, first + parent);
+            parentId[index] = first + parent;
+            level = depth[base + parent] + 1;
+        }
+        idIndex[id] = index;
+        sortedId[index] = id;
+        depth[index] = level;
+        sorted = sorted && level >= previous;
+        previous = level;
+        deepest = std::max(deepest, level);
+    }
+
+    if (sorted) {
+        for (uint32_t index = base; index < total; ++index) {
+            while (levelStart.size() < depth[index] + 2) levelStart.push_back(index);
+            levelStart.back() = index + 1;
+        }
+    } else {
+        orderDirty = true;
+    }
+    lastDirtyLevel = anyDirty ? std::max(lastDirtyLevel, deepest) : deepest;
+    firstDirtyLevel = 0;        // Batch node 0 is a root
+    anyDirty = true;
+    return first;
+}
+
+// Children become roots (their subtrees move up in place, or wait for a
+// pending re-sort), then the node's position closes
+void TransformHierarchy::destroy(uint32_t node) {
+    uint32_t levels = depth[idIndex[node]] + 1;
+    while (idFirstChild[node] != NONE) {
+        uint32_t child = idFirstChild[node];
+        unlink(child);
+        idParent[child] = NONE;
+        parentId[idIndex[child]] = NONE;
+        if (!orderDirty) reroot(child, levels);
+        markDirty(idIndex[child]);
+    }
+    unlink(node);
+    removeSlot(idIndex[node]);
+
+    idIndex[node] = NONE;
+    idParent[node] = NONE;
+    freeIds.push_back(node);
+}
+
+// Grow every column by one, then walk the opening up from the end: the
+// first node of each deeper level moves to that level's end. Appends when a
+// re-sort is pending (levelStart is stale then).
+uint32_t TransformHierarchy::insertSlot(uint32_t level) {
+    uint32_t hole = (uint32_t)sortedId.size();
+    sortedId.push_back(NONE);
+    parentId.push_back(NONE);
+    depth.push_back(0);
+    localPosition.resizeUninitialized(hole + 1);
+    localRotation.resizeUninitialized(hole + 1);
+    localScale.resizeUninitialized(hole + 1);
+    worldTranslation.resizeUninitialized(hole + 1);
+    worldMatrix.resizeUninitialized(hole + 1);
+    dirty.push_back(0);
+    stamp.push_back(0);
+    if (orderDirty) return hole;
+
+    while (levelStart.size() < level + 2) levelStart.push_back(hole);
+    for (uint32_t l = (uint32_t)levelStart.size() - 2; l > level; --l) {
+        uint32_t first = levelStart[l];
+        if (first != hole) writeSlot(hole, readSlot(first));
+        levelStart[l + 1] = hole + 1;
+        hole = first;
+    }
+    levelStart[level + 1] = hole + 1;
+    return hole;
+}
+
+// Walk the gap down to the end: the last node of each level from the removed
+// one's moves into it, then every column shrinks by one. Swap-removes with
+// the last node when a re-sort is pending.
+void TransformHierarchy::removeSlot(uint32_t index) {
+    uint32_t hole = index;
+    uint32_t last = (uint32_t)sortedId.size() - 1;
+    if (orderDirty) {
+        if (hole != last) writeSlot(hole, readSlot(last));
+    } else {
+        for (uint32_t l = depth[index]; l + 1 < levelStart.size(); ++l) {
+            uint32_t end = levelStart[l + 1] - 1;
+            if (hole != end) writeSlot(hole, readSlot(end));
+            levelStart[l + 1] = end;
+            hole = end;
+        }
+        while (levelStart.size() > 1 && levelStart[levelStart.size() - 2] == levelStart.back()) levelStart.pop_back();
+    }
+    sortedId.pop_back();
+    parentId.pop_back();
+    depth.pop_back();
+    localPosition.pop_back();
+    localRotation.pop_back();
+    localScale.pop_back();
+    worldTranslation.pop_back();
+    worldMatrix.pop_back();
+    dirty.pop_back();
+    stamp.pop_back();
+}
+
+// Every node of the subtree leaves its level and reopens `levels` higher up;
+// levels are independent ranges, so any visiting order keeps them valid
+void TransformHierarchy::reroot(uint32_t node, uint32_t levels) {
+    std::vector<uint32_t> stack(1, node);
+    while (!stack.empty()) {
+        uint32_t id = stack.back();
+        stack.pop_back();
+        for (uint32_t child = idFirstChild[id]; child != NONE; child = idNextSibling[child]) stack.push_back(child);
+
+        uint32_t index = idIndex[id];
+        Slot slot = readSlot(index);
+        slot.depth -= levels;
+        removeSlot(index);
+        writeSlot(insertSlot(slot.depth), slot);
+    }
+}
+
+TransformHierarchy::Slot TransformHierarchy::readSlot(uint32_t index) const {
+    return {parentId[index], depth[index], localPosition[index], localRotation[index], localScale[index],
+            worldTranslation[index], worldMatrix[index], dirty[index], stamp[index], sortedId[index]};
+}
+
+void TransformHierarchy::writeSlot(uint32_t index, const Slot& slot) {
+    parentId[index] = slot.parentId;
+    depth[index] = slot.depth;
+    localPosition[index] = slot.localPosition;
+    localRotation[index] = slot.localRotation;
+    localScale[index] = slot.localScale;
+    worldTranslation[index] = slot.worldTranslation;
+    worldMatrix[index] = slot.worldMatrix;
+    dirty[index] = slot.dirty;
+    stamp[index] = slot.stamp;
+    sortedId[index] = slot.sortedId;
+    idIndex[slot.sortedId] = index;
+}
+
+// Push onto the front of the parent's child list
+void TransformHierarchy::link(uint32_t node, uint32_t parent) {
+    uint32_t next = idFirstChild[parent];
+    idPrevSibling[node] = NONE;
+    idNextSibling[node] = next;
+    if (next != NONE) idPrevSibling[next] = node;
+    idFirstChild[parent] = node;
+}
+
+void TransformHierarchy::unlink(uint32_t node) {
+    uint32_t parent = idParent[node];
+    if (parent == NONE) return;
+    uint32_t previous = idPrevSibling[node], next = idNextSibling[node];
+    if (previous != NONE) idNextSibling[previous] = next;
+    else idFirstChild[parent] = next;
+    if (next != NONE) idPrevSibling[next] = previous;
+}
+
+void TransformHierarchy::clear() {
+    parentId.clear();
+    depth.clear();
+    localPosition.clear();
+    localRotation.clear();
+    localScale.clear();
+    worldTranslation.clear();
+    worldMatrix.clear();
+    dirty.clear();
+    stamp.clear();
+    sortedId.clear();
+    idIndex.clear();
+    idParent.clear();
+    idFirstChild.clear();
+    idNextSibling.clear();
+    idPrevSibling.clear();
+    freeIds.clear();
+    levelStart.clear();
+    changed.clear();
+    orderDirty = false;
+    anyDirty = false;
+    firstDirtyLevel = lastDirtyLevel = 0;
+}
+
+// Re-parent (keeps the local transform, so the node moves with its new parent)
+bool TransformHierarchy::setParent(uint32_t node, uint32_t parent) {
+    for (uint32_t p = parent; p != NONE; p = idParent[p])
+        if (p == node) return false;
+    unlink(node);
+    idParent[node] = parent;
+    if (parent != NONE) link(node, parent);
+    parentId[idIndex[node]] = parent;
+    orderDirty = true;
+    markDirty(idIndex[node]);
+    return true;
+}
+
+void TransformHierarchy::setPosition(uint32_t node, const glm::dvec3& position) {
+    uint32_t index = idIndex[node];
+    localPosition[index] = position;
+    markDirty(index);
+}
+
+void TransformHierarchy::setRotation(uint32_t node, const glm::quat& rotation) {
+    uint32_t index = idIndex[node];
+    localRotation[index] = rotation;
+    markDirty(index);
+}
+
+void TransformHierarchy::setScale(uint32_t node, const glm::vec3& scale) {
+    uint32_t index = idIndex[node];
+    localScale[index] = scale;
+    markDirty(index);
+}
+
+const glm::dvec3& TransformHierarchy::getPosition(uint32_t node) const {
+    return localPosition[idIndex[node]];
+}
+
+const glm::quat& TransformHierarchy::getRotation(uint32_t node) const {
+    return localRotation[idIndex[node]];
+}
+
+const glm::vec3& TransformHierarchy::getScale(uint32_t node) const {
+    return localScale[idIndex[node]];
+}
+
+uint32_t TransformHierarchy::getParent(uint32_t node) const {
+    return idParent[node];
+}
+
+// Flag a node and widen the range of levels update() has to visit
+void TransformHierarchy::markDirty(uint32_t index) {
+    dirty[index] = 1;
+    if (!anyDirty || depth[index] < firstDirtyLevel) firstDirtyLevel = depth[index];
+    if (!anyDirty || depth[index] > lastDirtyLevel) lastDirtyLevel = depth[index];
+    anyDirty = true;
+}
+
+// Recompute depths from the parent links, then counting-sort every array by
+// depth. World results move with their nodes, so only dirty nodes recompute.
+void TransformHierarchy::reorder() {
+    size_t count = sortedId.size();
+    std::vector<uint32_t> idDepth(idIndex.size(), NONE);
+    std::vector<uint32_t> chain;
+    uint32_t levels = 0;
+    for (uint32_t id : sortedId) {
+        uint32_t node = id;
+        while (node != NONE && idDepth[node] == NONE) {
+            chain.push_back(node);
+            node = idParent[node];
+        }
+        uint32_t d = node == NONE ? 0 : idDepth[node] + 1;
+        while (!chain.empty()) {
+            idDepth[chain.back()] = d++;
+            chain.pop_back();
+        }
+        levels = std::max(levels, idDepth[id] + 1);
+    }
+
+    levelStart.assign(levels + 1, 0);
+    for (uint32_t id : sortedId) ++levelStart[idDepth[id] + 1];
+    for (uint32_t d = 0; d < levels; ++d) levelStart[d + 1] += levelStart[d];
+
+    std::vector<uint32_t> next(levelStart.begin(), levelStart.end() - 1);
+    std::vector<uint32_t> order(count);           // New position -> old position
+    for (uint32_t i = 0; i < count; ++i) order[next[idDepth[sortedId[i]]]++] = i;
+
+    auto permute = [&](auto& column) {
+        std::decay_t<decltype(column)> sorted;
+        sorted.resizeUninitialized(count);
+        for (size_t i = 0; i < count; ++i) sorted[i] = column[order[i]];
+        column.swap(sorted);
+    };
+    permute(sortedId);
+    permute(localPosition);
+    permute(localRotation);
+    permute(localScale);
+    permute(worldTranslation);
+    permute(worldMatrix);
+    permute(dirty);
+    permute(stamp);
+
+    for (uint32_t i = 0; i < count; ++i) idIndex[sortedId[i]] = i;
+    for (uint32_t i = 0; i < count; ++i) {
+        uint32_t id = sortedId[i];
+        depth[i] = idDepth[id];
+        parentId[i] = idParent[id];
+    }
+
+    orderDirty = false;
+    firstDirtyLevel = 0;
+    lastDirtyLevel = levels;
+    ++stats.reorders;
+}
+
+// Recompute every node in [begin, end) that is dirty or whose parent was
+// recomputed this update; record their ids in `out`
+void TransformHierarchy::updateRange(uint32_t begin, uint32_t end, std::vector<uint32_t>& out) {
+    for (uint32_t i = begin; i < end; ++i) {
+        uint32_t parent = parentId[i];
+        uint32_t p = parent == NONE ? NONE : idIndex[parent];
+        if (!dirty[i] && (p == NONE || stamp[p] != updateCount)) continue;
+
+        glm::mat4 local = glm::mat4_cast(localRotation[i]);
+        local[0] *= localScale[i].x;
+        local[1] *= localScale[i].y;
+        local[2] *= localScale[i].z;
+
+        glm::mat4& world = worldMatrix[i];
+        if (p == NONE) {
+            worldTranslation[i] = localPosition[i];
+            world = local;
+        } else {
+            const glm::mat4& parent = worldMatrix[p];
+            worldTranslation[i] = worldTranslation[p] + glm::dmat3(glm::mat3(parent)) * localPosition[i];
+            multiply(parent, local, world);
+        }
+        world[3] = glm::vec4(glm::vec3(worldTranslation[i] - origin), 1.0f);
+
+        dirty[i] = 0;
+        stamp[i] = updateCount;
+        out.push_back(sortedId[i]);
+    }
+}
+
+// Level by level from the shallowest dirty one: a level only depends on the
+// previous one, so its range is split across the workers when large enough
+bool TransformHierarchy::update(const glm::dvec3& renderOrigin) {
+    using Clock = std::chrono::steady_clock;
+    changed.clear();
+    stats.nodes = (unsigned int)sortedId.size();
+    stats.updated = 0;
+    stats.updateMs = 0.0f;
+
+    bool moved = renderOrigin != origin;
+    origin = renderOrigin;
+    if (!anyDirty && !moved) return false;
+
+    Clock::time_point start = Clock::now();
+    if (orderDirty) reorder();
+    uint32_t levels = levelStart.empty() ? 0 : (uint32_t)levelStart.size() - 1;
+    stats.levels = levels;
+    if (moved && levels > 0) {
+        for (uint32_t i = levelStart[0]; i < levelStart[1]; ++i) dirty[i] = 1;
+        firstDirtyLevel = 0;
+    }
+
+    ++updateCount;
+    size_t levelChanged = 0;     // Recomputed in the previous level
+    for (uint32_t level = firstDirtyLevel; level < levels; ++level) {
+        if (level > lastDirtyLevel && changed.size() == levelChanged) break;    // Nothing left to reach
+        levelChanged = changed.size();
+        uint32_t begin = levelStart[level], end = levelStart[level + 1];
+        size_t count = workers.size();
+        if (end - begin < PARALLEL_MIN || count == 0) {
+            updateRange(begin, end, changed);
+            continue;
+        }
+        workers.run([&](unsigned int index) {
+            uint32_t first = begin + (uint32_t)((uint64_t)(end - begin) * index / count);
+            uint32_t last  = begin + (uint32_t)((uint64_t)(end - begin) * (index + 1) / count);
+            updateRange(first, last, workerChanged[index]);
+        });
+        for (std::vector<uint32_t>& part : workerChanged) {
+            changed.insert(changed.end(), part.begin(), part.end());
+            part.clear();
+        }
+    }
+    anyDirty = false;
+
+    stats.updated = (unsigned int)changed.size();
+    stats.updateMs = std::chrono::duration<float, std::milli>(Clock::now() - start).count();
+    return !changed.empty();
+}
+
+const std::vector<uint32_t>& TransformHierarchy::updated() const {
+    return changed;
+}
+
+const glm::mat4& TransformHierarchy::world(uint32_t node) const {
+    return worldMatrix[idIndex[node]];
+}
+
+const glm::dvec3& TransformHierarchy::worldPosition(uint32_t node) const {
+    return worldTranslation[idIndex[node]];
+}
+
+// Longest basis vector of the world matrix
+float TransformHierarchy::worldScale(uint32_t node) const {
+    const glm::mat4& m = worldMatrix[idIndex[node]];
+    return std::max(glm::length(glm::vec3(m[0])), std::max(glm::length(glm::vec3(m[1])), glm::length(glm::vec3(m[2]))));
+}
+
+const TransformStats& TransformHierarchy::getStats() const {
+    return stats;
+}
+
+unsigned int TransformHierarchy::workerCount() const {
+    return workers.size();
+}
+
+bool TransformHierarchy::simd() const {
+#if defined(__SSE__)
+    return true;
+#else
+    return false;
+#endif
+}
+
+// Stop and join the workers
+void TransformHierarchy::terminate() {
+    workers.terminate();
+}
@@ -0,0 +1,486 @@
+#include "Renderer/virtualtexture.h"
+#include "Renderer/cubesphere.h"
+#include "config.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <unordered_set>
+
+// Mip levels down to one tile per face
+static uint32_t levelCount(uint32_t faceTiles) {
+    uint32_t levels = 1;
+    while ((1u << (levels - 1)) < faceTiles) ++levels;
+    return levels;
+}
+
+VirtualTexture::~VirtualTexture() {
+    stopLoader();
+}
+
+// Open (or generate) the tile file, allocate the page table + cache, pin the
+// coarsest level and start the loader
+bool VirtualTexture::init(const char* tilePath, ShaderVariants& shaders, GLState& glState) {
+    state = &glState;
+    feedbackShader = &shaders.get(VSHADER_PATH, VIRTUAL_FEEDBACK_FSHADER_PATH, defines(), true);
+
+    file.open(tilePath, std::ios::binary);
+    if (!file.is_open()) {
+        std::cout << "Generating virtual texture tiles: " << tilePath << std::endl;
+        if (!writeDemo(tilePath, DEMO_FACE_TILES)) return false;
+        file.open(tilePath, std::ios::binary);
+    }
+    if (!file.read((char*)&header, sizeof(header)) || std::memcmp(header.magic, "VTEX", 4) != 0 ||
+        header.version != 1 || header.tileSize != TILE_SIZE || header.border != BORDER ||
+        header.faceTiles == 0 || header.faceTiles > MAX_FACE_TILES ||
+        (header.faceTiles & (header.faceTiles - 1)) != 0 || header.levels != levelCount(header.faceTiles)) {
+        std::cout << "ERROR::VIRTUAL_TEXTURE::BAD_TILE_FILE " << tilePath << std::endl;
+        file.close();
+        return false;
+    }
+
+    // Page table: nothing resident yet
+    int faceTiles = (int)header.faceTiles;
+    glGenTextures(1, &pageTable);
+    state->bindTexture(0, GL_TEXTURE_2D_ARRAY, pageTable);
+    glTexStorage3D(GL_TEXTURE_2D_ARRAY, header.levels, GL_RGBA8UI, faceTiles, faceTiles, 6);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    std::vector<unsigned char> empty(faceTiles * faceTiles * 6 * 4, 0);
+    for (int level = 0; level < (int)header.levels; ++level) {
+        int n = faceTiles >> level;
+        glTexSubImage3D(GL_TEXTURE_2D_ARRAY, level, 0, 0, 0, n, n, 6, GL_RGBA_INTEGER, GL_UNSIGNED_BYTE, empty.data());
+    }
+
+    // Physical cache: fixed size whatever the file holds
+    glGenTextures(1, &cache);
+    state->bindTexture(0, GL_TEXTURE_2D, cache);
+    glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, CACHE_SLOTS * SLOT_SIZE, CACHE_SLOTS * SLOT_SIZE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    slots.assign(CACHE_SLOTS * CACHE_SLOTS, Slot());
+
+    glGenBuffers(FEEDBACK_RING, readbackBuffers);
+
+    // One tile per face: the fallback every lookup ends on
+    for (int face = 0; face < 6; ++face) {
+        LoadedTile tile{tileKey(face, (int)header.levels - 1, 0, 0),
+                        std::vector<unsigned char>(SLOT_SIZE * SLOT_SIZE * 4)};
+        if (readTile(tile.key, tile.texels.data())) upload(tile, true);
+    }
+
+    open = true;
+    quit = false;
+    loader = std::thread(&VirtualTexture::loaderLoop, this);
+    return true;
+}
+
+// Cache layout of the sampling programs
+std::vector<std::string> VirtualTexture::defines() {
+    return {
+        "VIRTUAL_TEXTURE",
+        "VT_TILE_SIZE " + std::to_string(TILE_SIZE),
+        "VT_BORDER " + std::to_string(BORDER),
+        "VT_SLOT_SIZE " + std::to_string(SLOT_SIZE),
+        "VT_CACHE_SIZE " + std::to_string(CACHE_SLOTS * SLOT_SIZE)
+    };
+}
+
+// 3 bits face, 4 bits level, 8 bits row, 8 bits column
+uint32_t VirtualTexture::tileKey(int face, int level, int x, int y) {
+    return (uint32_t)face << 20 | (uint32_t)level << 16 | (uint32_t)y << 8 | (uint32_t)x;
+}
+
+// Seek to the tile and read it with its border
+bool VirtualTexture::readTile(uint32_t key, unsigned char* texels) {
+    uint64_t face = key >> 20, level = (key >> 16) & 15, y = (key >> 8) & 255, x = key & 255;
+    uint64_t index = 0;
+    for (uint64_t l = 0; l < level; ++l) {
+        uint64_t n = header.faceTiles >> l;
+        index += 6 * n * n;
+    }
+    uint64_t n = header.faceTiles >> level;
+    index += (face * n + y) * n + x;
+
+    const uint64_t tileBytes = SLOT_SIZE * SLOT_SIZE * 4;
+    file.clear();
+    file.seekg((std::streamoff)(sizeof(TileFileHeader) + index * tileBytes));
+    return (bool)file.read((char*)texels, (std::streamsize)tileBytes);
+}
+
+// Copy a tile into a free slot, or the least recently used one the newest
+// readback did not ask for; false = every slot is in use (the coarser tile stays)
+bool VirtualTexture::upload(const LoadedTile& tile, bool pin) {
+    if (slotOf.count(tile.key)) return true;    // Read twice
+
+    int best = -1;
+    for (int i = 0; i < (int)slots.size(); ++i) {
+        const Slot& slot = slots[i];
+        if (!slot.used) { best = i; break; }
+        if (slot.pinned || slot.lastUsed >= readbacks) continue;
+        if (best < 0 || slot.lastUsed < slots[best].lastUsed) best = i;
+    }
+    if (best < 0) return false;
+
+    Slot& slot = slots[best];
+    if (slot.used) {
+        setPage(slot.key, -1);
+        slotOf.erase(slot.key);
+        ++stats.evicted;
+    }
+
+    state->bindTexture(0, GL_TEXTURE_2D, cache);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, (best % CACHE_SLOTS) * SLOT_SIZE, (best / CACHE_SLOTS) * SLOT_SIZE,
+                    SLOT_SIZE, SLOT_SIZE, GL_RGBA, GL_UNSIGNED_BYTE, tile.texels.data());
+    slot.key = tile.key;
+    slot.used = true;
+    slot.pinned = pin;
+    slot.lastUsed = readbacks;
+    slotOf[tile.key] = best;
+    setPage(tile.key, best);
+    ++stats.streamed;
+    return true;
+}
+
+// Point the tile's page table texel at a slot, or mark it absent
+void VirtualTexture::setPage(uint32_t key, int slot) {
+    unsigned char page[4] = {0, 0, 0, 0};
+    if (slot >= 0) {
+        page[0] = (unsigned char)(slot % CACHE_SLOTS);
+        page[1] = (unsigned char)(slot / CACHE_SLOTS);
+        page[3] = 1;
+    }
+    int face = key >> 20, level = (key >> 16) & 15, y = (key >> 8) & 255, x = key & 255;
+    state->bindTexture(0, GL_TEXTURE_2D_ARRAY, pageTable);
+    glTexSubImage3D(GL_TEXTURE_2D_ARRAY, level, x, y, face, 1, 1, 1, GL_RGBA_INTEGER, GL_UNSIGNED_BYTE, page);
+}
+
+// Bind the low-resolution feedback target and its program
+Shader& VirtualTexture::beginFeedback(int renderWidth, int renderHeight) {
+    int w = std::max(renderWidth / FEEDBACK_DIVISOR, 1);
+    int h = std::max(renderHeight / FEEDBACK_DIVISOR, 1);
+    if (w != feedbackWidth || h != feedbackHeight) resizeFeedback(w, h);
+
+    state->bindFramebuffer(GL_FRAMEBUFFER, feedbackFbo);
+    glViewport(0, 0, w, h);
+    state->setDepthTest(true);
+    state->setDepthFunc(GL_LESS);
+    state->setDepthWrite(true);
+    const GLuint none[4] = {0, 0, 0, 0};
+    glClearBufferuiv(GL_COLOR, 0, none);
+    glClear(GL_DEPTH_BUFFER_BIT);
+
+    // Pixels are FEEDBACK_DIVISOR times larger: ask for the full-resolution level
+    feedbackShader->use();
+    feedbackShader->setInt("vtFaceTiles", (int)header.faceTiles);
+    feedbackShader->setInt("vtLevels", (int)header.levels);
+    feedbackShader->setFloat("vtLodBias", -std::log2((float)FEEDBACK_DIVISOR));
+    return *feedbackShader;
+}
+
+// Queue the asynchronous readback of this frame's feedback
+void VirtualTexture::endFeedback() {
+    int slot = readbackHead;
+    readbackHead = (readbackHead + 1) % FEEDBACK_RING;
+    if (readbackFences[slot]) glDeleteSync(readbackFences[slot]);
+
+    state->bindBuffer(GL_PIXEL_PACK_BUFFER, readbackBuffers[slot]);
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
+    glReadPixels(0, 0, feedbackWidth, feedbackHeight, GL_RGBA_INTEGER, GL_UNSIGNED_BYTE, 0);
+    state->bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    readbackFences[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    readbackSizes[slot][0] = feedbackWidth;
+    readbackSizes[slot][1] = feedbackHeight;
+}
+
+// (Re)create the feedback target and readback buffers; readbacks in flight are dropped
+void VirtualTexture::resizeFeedback(int width, int height) {
+    state->invalidate();    // deleted names may be reused
+    if (feedbackFbo) {
+        glDeleteFramebuffers(1, &feedbackFbo);
+        glDeleteTextures(1, &feedbackTexture);
+        glDeleteRenderbuffers(1, &feedbackDepth);
+    }
+    feedbackWidth = width;
+    feedbackHeight = height;
+
+    glGenTextures(1, &feedbackTexture);
+    state->bindTexture(0, GL_TEXTURE_2D, feedbackTexture);
+    glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8UI, width, height);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+    glGenRenderbuffers(1, &feedbackDepth);
+    glBindRenderbuffer(GL_RENDERBUFFER, feedbackDepth);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+
+    glGenFramebuffers(1, &feedbackFbo);
+    state->bindFramebuffer(GL_FRAMEBUFFER, feedbackFbo);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, feedbackTexture, 0);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, feedbackDepth);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        std::cout << "ERROR::VIRTUAL_TEXTURE::FEEDBACK_FRAMEBUFFER_INCOMPLETE" << std::endl;
+
+    for (int i = 0; i < FEEDBACK_RING; ++i) {
+        if (readbackFences[i]) glDeleteSync(readbackFences[i]);
+        readbackFences[i] = 0;
+        state->bindBuffer(GL_PIXEL_PACK_BUFFER, readbackBuffers[i]);
+        state->bufferData(GL_PIXEL_PACK_BUFFER, (size_t)width * height * 4, NULL, GL_STREAM_READ);
+    }
+    state->bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+// Decode the newest finished readback (never waits) into the wanted tiles,
+// each with the coarser tiles covering it
+bool VirtualTexture::readFeedback(std::vector<uint32_t>& keys) {
+    int newest = -1;
+    for (int i = 0; i < FEEDBACK_RING; ++i) {
+        int slot = (readbackHead + i) % FEEDBACK_RING;     // oldest -> newest
+        if (!readbackFences[slot]) continue;
+
+        GLenum status = glClientWaitSync(readbackFences[slot], 0, 0);
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) break;
+        glDeleteSync(readbackFences[slot]);
+        readbackFences[slot] = 0;
+        newest = slot;                                      // older ones are superseded
+    }
+    if (newest < 0) return false;
+
+    size_t count = (size_t)readbackSizes[newest][0] * readbackSizes[newest][1];
+    state->bindBuffer(GL_PIXEL_PACK_BUFFER, readbackBuffers[newest]);
+    const unsigned char* texels = (const unsigned char*)glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, count * 4, GL_MAP_READ_BIT);
+    if (texels) {
+        std::unordered_set<uint32_t> wanted;
+        for (size_t i = 0; i < count; ++i) {
+            const unsigned char* t = texels + 4 * i;
+            if (t[3] == 0) continue;
+
+            // A tile already seen brought its ancestors with it
+            int x = t[0], y = t[1];
+            for (int level = t[2]; level < (int)header.levels; ++level, x >>= 1, y >>= 1)
+                if (!wanted.insert(tileKey(t[3] - 1, level, x, y)).second) break;
+        }
+        keys.assign(wanted.begin(), wanted.end());
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    state->bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    return texels != nullptr;
+}
+
+// Refresh the wanted tiles, hand the misses to the loader and upload what it read
+void VirtualTexture::update() {
+    if (!open) return;
+
+    std::vector<uint32_t> wanted;
+    if (readFeedback(wanted)) {
+        ++readbacks;
+        std::vector<uint32_t> misses;
+        for (uint32_t key : wanted) {
+            auto it = slotOf.find(key);
+            if (it != slotOf.end()) slots[it->second].lastUsed = readbacks;
+            else misses.push_back(key);
+        }
+        misses.erase(std::remove_if(misses.begin(), misses.end(), [&](uint32_t key) {
+                         return std::any_of(waiting.begin(), waiting.end(),
+                                            [key](const LoadedTile& t) { return t.key == key; });
+                     }), misses.end());
+
+        // Coarse first: every level that lands sharpens what is on screen
+        std::sort(misses.begin(), misses.end(), [](uint32_t a, uint32_t b) {
+            return ((a >> 16) & 15) > ((b >> 16) & 15);
+        });
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            requests.assign(misses.begin(), misses.end());  // Misses of older readbacks are dropped
+            if (loading) requests.erase(std::remove(requests.begin(), requests.end(), loading - 1), requests.end());
+        }
+        wake.notify_one();
+        stats.requested = (unsigned int)wanted.size();
+        stats.queued = (unsigned int)misses.size();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (LoadedTile& tile : loaded) waiting.push_back(std::move(tile));
+        loaded.clear();
+    }
+
+    // A bounded number per frame; tiles finding every slot in use are dropped
+    // (the next readback asks again)
+    size_t count = std::min<size_t>(waiting.size(), UPLOADS_PER_FRAME);
+    for (size_t i = 0; i < count; ++i) upload(waiting[i], false);
+    waiting.erase(waiting.begin(), waiting.begin() + count);
+    stats.resident = (unsigned int)slotOf.size();
+}
+
+// Page table + cache and the file's layout uniforms (program must be in use)
+void VirtualTexture::bind(Shader& shader, unsigned int unit) const {
+    state->bindTexture(unit, GL_TEXTURE_2D_ARRAY, pageTable);
+    state->bindTexture(unit + 1, GL_TEXTURE_2D, cache);
+    shader.setInt("pageTable", (int)unit);
+    shader.setInt("tileCache", (int)unit + 1);
+    shader.setInt("vtFaceTiles", (int)header.faceTiles);
+    shader.setInt("vtLevels", (int)header.levels);
+    shader.setFloat("vtLodBias", 0.0f);
+}
+
+bool VirtualTexture::ready() const {
+    return open;
+}
+
+const VirtualTextureStats& VirtualTexture::getStats() const {
+    return stats;
+}
+
+// Read requested tiles one at a time, coarse first, off the render thread
+void VirtualTexture::loaderLoop() {
+    while (true) {
+        uint32_t key;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this] { return quit || !requests.empty(); });
+            if (quit) return;
+            key = requests.front();
+            requests.pop_front();
+            loading = key + 1;
+        }
+
+        LoadedTile tile{key, std::vector<unsigned char>(SLOT_SIZE * SLOT_SIZE * 4)};
+        bool ok = readTile(key, tile.texels.data());
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (ok) loaded.push_back(std::move(tile));
+        loading = 0;
+    }
+}
+
+// Wake the loader and wait for it to exit
+void VirtualTexture::stopLoader() {
+    if (!loader.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        quit = true;
+    }
+    wake.notify_all();
+    loader.join();
+}
+
+// Release GL objects
+void VirtualTexture::terminate() {
+    stopLoader();
+    if (!state) return;
+    state->invalidate();    // deleted names may be reused
+    for (int i = 0; i < FEEDBACK_RING; ++i) {
+        if (readbackFences[i]) glDeleteSync(readbackFences[i]);
+        readbackFences[i] = 0;
+    }
+    glDeleteBuffers(FEEDBACK_RING, readbackBuffers);
+    glDeleteFramebuffers(1, &feedbackFbo);
+    glDeleteRenderbuffers(1, &feedbackDepth);
+    unsigned int textures[3] = {pageTable, cache, feedbackTexture};
+    glDeleteTextures(3, textures);
+    pageTable = cache = feedbackTexture = feedbackFbo = feedbackDepth = 0;
+    file.close();
+    open = false;
+}
+
+// --- Demo imagery ---
+
+// Lattice hash in [0, 1]
+static float latticeValue(int x, int y, int z) {
+    uint32_t h = (uint32_t)x * 73856093u ^ (uint32_t)y * 19349663u ^ (uint32_t)z * 83492791u;
+    h ^= h >> 13;
+    h *= 0x5bd1e995u;
+    h ^= h >> 15;
+    return (float)(h & 0xffffff) / 16777215.0f;
+}
+
+// Trilinear value noise with smoothstep weights
+static float valueNoise(const glm::vec3& p) {
+    glm::vec3 cell = glm::floor(p);
+    glm::vec3 f = p - cell;
+    glm::vec3 w = f * f * (3.0f - 2.0f * f);
+    int x = (int)cell.x, y = (int)cell.y, z = (int)cell.z;
+
+    float result = 0.0f;
+    for (int corner = 0; corner < 8; ++corner) {
+        int dx = corner & 1, dy = (corner >> 1) & 1, dz = corner >> 2;
+        float weight = (dx ? w.x : 1.0f - w.x) * (dy ? w.y : 1.0f - w.y) * (dz ? w.z : 1.0f - w.z);
+        result += weight * latticeValue(x + dx, y + dy, z + dz);
+    }
+    return result;
+}
+
+// Ocean, land and ice from fractal noise on the unit sphere; coarser levels
+// sum fewer octaves (a cheap prefilter)
+static void demoTexel(const float dir[3], int octaves, unsigned char out[4]) {
+    glm::vec3 d(dir[0], dir[1], dir[2]);
+    float height = 0.0f, amplitude = 0.5f, frequency = 2.0f;
+    for (int i = 0; i < octaves; ++i) {
+        height += amplitude * valueNoise(d * frequency + glm::vec3(17.0f * i));
+        amplitude *= 0.5f;
+        frequency *= 2.0f;
+    }
+
+    glm::vec3 color;
+    if (std::fabs(d.y) + 0.15f * height > 0.9f) {
+        color = glm::vec3(0.75f, 0.78f, 0.8f);                                  // Ice
+    } else if (height < 0.5f) {
+        color = glm::mix(glm::vec3(0.01f, 0.03f, 0.12f), glm::vec3(0.03f, 0.12f, 0.22f),
+                         height / 0.5f);                                        // Deep -> shallow water
+    } else {
+        color = glm::mix(glm::vec3(0.06f, 0.16f, 0.04f), glm::vec3(0.28f, 0.22f, 0.12f),
+                         std::min((height - 0.5f) * 4.0f, 1.0f));               // Lowland -> highland
+    }
+    for (int c = 0; c < 3; ++c) out[c] = (unsigned char)(glm::clamp(color[c], 0.0f, 1.0f) * 255.0f + 0.5f);
+    out[3] = 255;
+}
+
+// Write every level of every face in file order (borders clamp at face edges)
+bool VirtualTexture::writeDemo(const char* path, int faceTiles) {
+    std::ofstream out(path, std::ios::binary);
+    if (!out.is_open()) {
+        std::cout << "ERROR::VIRTUAL_TEXTURE::TILE_FILE_NOT_WRITTEN " << path << std::endl;
+        return false;
+    }
+
+    TileFileHeader header{};
+    std::memcpy(header.magic, "VTEX", 4);
+    header.version = 1;
+    header.tileSize = TILE_SIZE;
+    header.border = BORDER;
+    header.faceTiles = (uint32_t)faceTiles;
+    header.levels = levelCount(header.faceTiles);
+    out.write((const char*)&header, sizeof(header));
+
+    int finest = (int)std::log2((float)(faceTiles * TILE_SIZE));
+    std::vector<unsigned char> texels(SLOT_SIZE * SLOT_SIZE * 4);
+    for (int level = 0; level < (int)header.levels; ++level) {
+        int n = faceTiles >> level;
+        int octaves = std::max(2, finest - 3 - level);
+        float faceTexels = (float)(n * TILE_SIZE);
+        for (int face = 0; face < 6; ++face)
+            for (int ty = 0; ty < n; ++ty)
+                for (int tx = 0; tx < n; ++tx) {
+                    for (int py = 0; py < SLOT_SIZE; ++py)
+                        for (int px = 0; px < SLOT_SIZE; ++px) {
+                            float u = (tx * TILE_SIZE + px - BORDER + 0.5f) / faceTexels;
+                            float v = (ty * TILE_SIZE + py - BORDER + 0.5f) / faceTexels;
+                            float dir[3];
+                            CubeSphere::faceDirection(face, glm::clamp(u, 0.0f, 1.0f), glm::clamp(v, 0.0f, 1.0f), dir);
+                            demoTexel(dir, octaves, &texels[(py * SLOT_SIZE + px) * 4]);
+                        }
+                    out.write((const char*)texels.data(), (std::streamsize)texels.size());
+                }
+    }
+
+    if (!out) {
+        std::cout << "ERROR::VIRTUAL_TEXTURE::TILE_FILE_NOT_WRITTEN " << path << std::endl;
+        return false;
+    }
+    return true;
+}
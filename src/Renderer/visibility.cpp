@@ -0,0 +1,133 @@
+#include "Renderer/visibility.h"
+#include "config.h"
+
+#include <algorithm>
+
+// Build the raster + resolve programs and the pool buffers
+void VisibilityBuffer::init(ShaderVariants& shaders, GLState& glState,
+                            const std::vector<std::string>& clusteredDefines) {
+    state = &glState;
+
+    rasterShader = &shaders.get(VSHADER_PATH, VISIBILITY_FSHADER_PATH, {"DEPTH_ONLY"}, true);
+    resolveShader = &shaders.get(FULLSCREEN_VSHADER_PATH, VISIBILITY_RESOLVE_FSHADER_PATH, {}, true);
+    resolveClusteredShader = &shaders.get(FULLSCREEN_VSHADER_PATH, VISIBILITY_RESOLVE_FSHADER_PATH,
+                                          clusteredDefines, true);
+
+    glGenBuffers(1, &positionBuffer);
+    glGenBuffers(1, &indexBuffer);
+    glGenBuffers(1, &instanceBuffer);
+    glGenVertexArrays(1, &fullscreenVAO);
+}
+
+// Set the render size; targets are only recreated when they must grow
+void VisibilityBuffer::resize(int w, int h) {
+    width = w;
+    height = h;
+    if (w <= allocWidth && h <= allocHeight) return;
+    releaseTargets();
+    allocWidth = std::max(w, allocWidth);
+    allocHeight = std::max(h, allocHeight);
+
+    glGenTextures(1, &idTexture);
+    state->bindTexture(0, GL_TEXTURE_2D, idTexture);
+    glTexStorage2D(GL_TEXTURE_2D, 1, GL_RG32UI, allocWidth, allocHeight);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+    glGenTextures(1, &depthTexture);
+    state->bindTexture(0, GL_TEXTURE_2D, depthTexture);
+    glTexStorage2D(GL_TEXTURE_2D, 1, state->depthStencilFormat(), allocWidth, allocHeight);
+
+    glGenFramebuffers(1, &fbo);
+    state->bindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, idTexture, 0);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_TEXTURE_2D, depthTexture, 0);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        std::cout << "ERROR::VISIBILITY::FRAMEBUFFER_INCOMPLETE" << std::endl;
+    state->bindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+// Replace the pooled geometry (only when meshes change)
+void VisibilityBuffer::uploadGeometry(const std::vector<float>& positions,
+                                      const std::vector<unsigned int>& indices) {
+    state->bindBuffer(GL_SHADER_STORAGE_BUFFER, positionBuffer);
+    state->bufferData(GL_SHADER_STORAGE_BUFFER, positions.size() * sizeof(float), positions.data(), GL_STATIC_DRAW);
+    state->bindBuffer(GL_SHADER_STORAGE_BUFFER, indexBuffer);
+    state->bufferData(GL_SHADER_STORAGE_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
+}
+
+// Upload this frame's per-draw data (buffer grows by doubling)
+void VisibilityBuffer::uploadInstances(const std::vector<VisInstance>& instances) {
+    if (instances.empty()) return;
+    state->bindBuffer(GL_SHADER_STORAGE_BUFFER, instanceBuffer);
+    if (instances.size() > instanceCapacity) {
+        instanceCapacity = std::max(instances.size(), instanceCapacity * 2);
+        state->bufferData(GL_SHADER_STORAGE_BUFFER, instanceCapacity * sizeof(VisInstance), NULL, GL_DYNAMIC_DRAW);
+    }
+    state->bufferSubData(GL_SHADER_STORAGE_BUFFER, 0, instances.size() * sizeof(VisInstance), instances.data());
+}
+
+// Bind + clear the ID target and return the raster program
+Shader& VisibilityBuffer::beginRaster() {
+    state->bindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glViewport(0, 0, width, height);
+    state->setDepthWrite(true);
+    state->setDepthFunc(GL_LESS);
+
+    const GLuint empty[4] = {EMPTY, EMPTY, 0, 0};
+    glClearBufferuiv(GL_COLOR, 0, empty);
+    glClear(GL_DEPTH_BUFFER_BIT);
+
+    rasterShader->use();
+    return *rasterShader;
+}
+
+// Copy the raster depth to the scene target (for later depth-tested passes) and bind it
+void VisibilityBuffer::endRaster(unsigned int target) {
+    state->bindFramebuffer(GL_READ_FRAMEBUFFER, fbo);
+    state->bindFramebuffer(GL_DRAW_FRAMEBUFFER, target);
+    glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+    state->bindFramebuffer(GL_FRAMEBUFFER, target);
+}
+
+// Bind the IDs and pools for the resolve program
+Shader& VisibilityBuffer::beginResolve(bool clustered) {
+    Shader& shader = clustered ? *resolveClusteredShader : *resolveShader;
+    shader.use();
+
+    state->bindTexture(0, GL_TEXTURE_2D, idTexture);
+    shader.setInt("visibility", 0);
+    shader.setVec2("screenSize", glm::vec2(width, height));
+
+    state->bindBufferBase(GL_SHADER_STORAGE_BUFFER, POSITIONS_BINDING, positionBuffer);
+    state->bindBufferBase(GL_SHADER_STORAGE_BUFFER, INDICES_BINDING, indexBuffer);
+    state->bindBufferBase(GL_SHADER_STORAGE_BUFFER, INSTANCES_BINDING, instanceBuffer);
+    return shader;
+}
+
+// One full-screen triangle; background pixels are discarded
+void VisibilityBuffer::resolve() {
+    state->setDepthTest(false);
+    state->bindVertexArray(fullscreenVAO);
+    state->drawArrays(GL_TRIANGLES, 0, 3);
+    state->setDepthTest(true);
+}
+
+// Delete screen-sized targets
+void VisibilityBuffer::releaseTargets() {
+    if (!fbo) return;
+    state->invalidate();    // deleted names may be reused
+    glDeleteFramebuffers(1, &fbo);
+    glDeleteTextures(1, &idTexture);
+    glDeleteTextures(1, &depthTexture);
+    fbo = idTexture = depthTexture = 0;
+}
+
+// Release GL objects
+void VisibilityBuffer::terminate() {
+    releaseTargets();
+    glDeleteBuffers(1, &positionBuffer);
+    glDeleteBuffers(1, &indexBuffer);
+    glDeleteBuffers(1, &instanceBuffer);
+    glDeleteVertexArrays(1, &fullscreenVAO);
+}
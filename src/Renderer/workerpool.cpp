@@ -0,0 +1,70 @@
+#include "Renderer/workerpool.h"
+
+WorkerPool::~WorkerPool() {
+    terminate();
+}
+
+// One thread per core, leaving one for the caller
+unsigned int WorkerPool::defaultSize() {
+    unsigned int cores = std::thread::hardware_concurrency();
+    return cores > 1 ? cores - 1 : 1;
+}
+
+// Start the workers
+void WorkerPool::init(unsigned int count) {
+    terminate();
+    if (count == 0) count = defaultSize();
+
+    quit = false;
+    for (unsigned int i = 0; i < count; ++i)
+        workers.emplace_back(&WorkerPool::workerLoop, this, i, generation);
+}
+
+// Publish the job, wake every worker and wait until the last one reports back
+void WorkerPool::run(const std::function<void(unsigned int)>& work) {
+    if (workers.empty()) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        job = &work;
+        ++generation;
+        pending = (unsigned int)workers.size();
+    }
+    wake.notify_all();
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [this] { return pending == 0; });
+    job = nullptr;
+}
+
+// Wait for a new job, run this worker's part of it, report back
+void WorkerPool::workerLoop(unsigned int index, unsigned long long seen) {
+    while (true) {
+        const std::function<void(unsigned int)>* work;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return quit || generation != seen; });
+            if (quit) return;
+            seen = generation;
+            work = job;
+        }
+
+        (*work)(index);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--pending == 0) done.notify_one();
+    }
+}
+
+unsigned int WorkerPool::size() const {
+    return (unsigned int)workers.size();
+}
+
+// Stop and join the workers
+void WorkerPool::terminate() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        quit = true;
+    }
+    wake.notify_all();
+    for (std::thread& worker : workers) worker.join();
+    workers.clear();
+}
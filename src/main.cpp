@@ -1,8 +1,9 @@
 #include "application.h"
 
-int main() {
+// Optional argument: a scene file to start from instead of the built-in scene
+int main(int argc, char** argv) {
     // Initiate the app.
-    App app;
+    App app(argc > 1 ? argv[1] : "");
 
     // Run the application.
     app.run();
@@ -0,0 +1,20 @@
+#ifndef TESTS_CHECK_H
+#define TESTS_CHECK_H
+
+#include <iostream>
+
+// Minimal assertions for the headless tests (no framework dependency):
+// every failed CHECK prints its location, main() returns CHECK_RESULT()
+static int checkFailures = 0;
+
+#define CHECK(condition)                                                              \
+    do {                                                                              \
+        if (!(condition)) {                                                           \
+            ++checkFailures;                                                          \
+            std::cout << "FAILED::" << __FILE__ << ":" << __LINE__ << " " #condition << std::endl; \
+        }                                                                             \
+    } while (0)
+
+#define CHECK_RESULT() (checkFailures == 0 ? 0 : 1)
+
+#endif
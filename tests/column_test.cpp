@@ -0,0 +1,81 @@
+#include "check.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "Renderer/column.h"
+
+// The std::vector operations the stores use
+static void checkVectorLike() {
+    Column<uint32_t> column;
+    CHECK(column.empty());
+    for (uint32_t i = 0; i < 100; ++i) column.push_back(i);
+    CHECK(column.size() == 100 && column.back() == 99);
+    column.push_back(column[0]);                        // Element of the column itself, across a regrow
+    CHECK(column.back() == 0);
+    column.pop_back();
+
+    column.resize(110, 7u);
+    CHECK(column[99] == 99 && column[100] == 7 && column[109] == 7);
+    const uint32_t more[3] = {1, 2, 3};
+    column.append(more, 3);
+    CHECK(column.size() == 113 && column[112] == 3);
+
+    Column<uint32_t> copy = column;
+    copy[0] = 42;
+    CHECK(column[0] == 0 && copy.size() == column.size());
+    copy.swap(column);
+    CHECK(column[0] == 42 && copy[0] == 0);
+
+    uint32_t sum = 0;
+    for (uint32_t value : copy) sum += value;
+    CHECK(sum == 99 * 100 / 2 + 70 + 6);
+
+    size_t capacity = column.capacity();
+    column.clear();
+    CHECK(column.empty() && column.capacity() == capacity);
+}
+
+// An adopted column reads and writes the owner's memory until it has to
+// grow, then continues on the heap and leaves that memory alone
+static void checkAdopt() {
+    auto owner = std::make_shared<std::vector<float>>(4, 1.0f);
+    std::weak_ptr<void> alive = owner;
+    Column<float> column;
+    column.adopt(owner->data(), owner->size(), owner);
+    float* memory = owner->data();
+    owner.reset();                                      // The column keeps it
+    CHECK(!alive.expired() && column.adopted());
+
+    column[1] = 2.0f;
+    CHECK(memory[1] == 2.0f);
+    column.push_back(3.0f);
+    CHECK(!column.adopted() && alive.expired());
+    CHECK(column.size() == 5 && column[1] == 2.0f && column[4] == 3.0f);
+
+    Column<float> view;
+    auto second = std::make_shared<std::vector<float>>(2, 5.0f);
+    view.adopt(second->data(), second->size(), second);
+    view.clear();                                       // Drops the view, not the memory
+    CHECK(!view.adopted() && view.empty() && (*second)[0] == 5.0f);
+    view.resize(3, 1.0f);
+    CHECK(view[2] == 1.0f && (*second)[1] == 5.0f);
+}
+
+// Large columns come from huge-page aligned blocks
+static void checkLarge() {
+    Column<uint64_t> column;
+    column.resizeUninitialized(1u << 20);
+    CHECK((uintptr_t)column.data() % (2u << 20) == 0);
+    column[(1u << 20) - 1] = 1;
+    column.reserve(3u << 20);
+    CHECK(column.size() == (1u << 20) && column.back() == 1);
+}
+
+int main() {
+    checkVectorLike();
+    checkAdopt();
+    checkLarge();
+    return CHECK_RESULT();
+}
@@ -0,0 +1,106 @@
+// Per-sphere frame passes over EntityStore columns vs heap objects shaped
+// like Sphere. Usage: entities_benchmark [count]
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Renderer/entities.h"
+
+// Heap object shaped like Sphere: the hot fields sit between CPU geometry,
+// GL handles, a name and the atmosphere parameters
+struct PointerSphere {
+    std::vector<float>        vertices;
+    std::vector<unsigned int> indices;
+    Mesh                      mesh;
+    glm::vec3                 color{1.0f};
+    glm::dvec3                worldPosition{0.0};
+    glm::vec3                 position{0.0f};
+    std::string               name;
+    bool                      source = false;
+    float                     lightRange = 10.0f;
+    bool                      dynamic = false;
+    float                     opacity = 1.0f;
+    float                     atmosphere[20] = {};
+    float                     radius = 1.0f;
+};
+
+// One frame's per-sphere passes (rebase, bounds of opaque lit spheres,
+// lights) both ways, best of a few runs each
+int main(int argc, char** argv) {
+    using Clock = std::chrono::steady_clock;
+    size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : (size_t)1 << 20;
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> coord(-1.0e4, 1.0e4);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    EntityStore store;
+    std::vector<std::unique_ptr<PointerSphere>> objects;
+    objects.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        glm::dvec3 p(coord(rng), coord(rng), coord(rng));
+        float r = 0.1f + unit(rng);
+        float a = unit(rng) < 0.1f ? 0.5f : 1.0f;
+        bool source = unit(rng) < 0.01f;
+
+        uint32_t row = store.row(store.create(PoolHandle<Sphere>()));
+        store.worldPosition[row] = p;
+        store.radius[row] = r;
+        store.opacity[row] = a;
+        store.flags[row] = source ? ENTITY_SOURCE : 0u;
+
+        objects.emplace_back(new PointerSphere());
+        PointerSphere& o = *objects.back();
+        o.name = "Benchmark sphere #" + std::to_string(i);  // Heap allocated between the objects
+        o.worldPosition = p;
+        o.radius = r;
+        o.opacity = a;
+        o.source = source;
+    }
+
+    glm::dvec3 origin(128.0, 0.0, -64.0);
+    std::vector<glm::vec4> bounds, lights;
+    bounds.reserve(count);
+    lights.reserve(count);
+    auto bestMs = [&](auto pass) {
+        double best = 1e30;
+        for (int run = 0; run < 5; ++run) {
+            bounds.clear();
+            lights.clear();
+            Clock::time_point start = Clock::now();
+            pass();
+            best = std::min(best, std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+        }
+        return best;
+    };
+
+    double storeMs = bestMs([&] {
+        size_t n = store.size();
+        for (size_t i = 0; i < n; ++i) store.position[i] = glm::vec3(store.worldPosition[i] - origin);
+        for (size_t i = 0; i < n; ++i) {
+            if (store.flags[i] & ENTITY_SOURCE) lights.push_back(glm::vec4(store.position[i], store.lightRange[i]));
+            else if (store.opacity[i] >= 1.0f) bounds.push_back(glm::vec4(store.position[i], store.radius[i]));
+        }
+    });
+    size_t storeBounds = bounds.size();
+
+    double pointerMs = bestMs([&] {
+        for (const std::unique_ptr<PointerSphere>& o : objects) o->position = glm::vec3(o->worldPosition - origin);
+        for (const std::unique_ptr<PointerSphere>& o : objects) {
+            if (o->source) lights.push_back(glm::vec4(o->position, o->lightRange));
+            else if (o->opacity >= 1.0f) bounds.push_back(glm::vec4(o->position, o->radius));
+        }
+    });
+
+    auto perEntity = [count](double ms) { return ms * 1.0e6 / (double)count; };
+    std::cout << "ENTITIES: n " << count
+              << " | store " << storeMs << " ms (" << perEntity(storeMs) << " ns/entity)"
+              << " | pointers " << pointerMs << " ms (" << perEntity(pointerMs) << " ns/entity)"
+              << " | x" << (storeMs > 0.0 ? pointerMs / storeMs : 0.0)
+              << (storeBounds == bounds.size() ? "" : " | MISMATCH") << std::endl;
+    return storeBounds == bounds.size() ? 0 : 1;
+}
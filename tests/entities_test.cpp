@@ -0,0 +1,62 @@
+#include "check.h"
+
+#include <vector>
+
+#include "Renderer/entities.h"
+
+// Handles survive swap-removal and go stale on destroy
+static void checkHandles() {
+    EntityStore store;
+    std::vector<EntityHandle> handles;
+    for (int i = 0; i < 4; ++i) {
+        handles.push_back(store.create(PoolHandle<Sphere>()));
+        store.radius[store.row(handles.back())] = (float)i;
+    }
+    store.destroy(handles[1]);
+    CHECK(!store.alive(handles[1]));
+    CHECK(store.size() == 3);
+    CHECK(store.row(handles[3]) == 1);                  // Last row moved into the hole
+    CHECK(store.radius[store.row(handles[3])] == 3.0f);
+    CHECK(store.radius[store.row(handles[2])] == 2.0f);
+    CHECK(!store.alive(EntityHandle()));
+}
+
+// Bulk rows take retired slots first, with newer generations than the old handles
+static void checkAppendReuse() {
+    EntityStore store;
+    std::vector<EntityHandle> old;
+    for (int i = 0; i < 8; ++i) old.push_back(store.create(PoolHandle<Sphere>()));
+    store.clear();
+
+    uint32_t first = store.append(10);
+    CHECK(first == 0);
+    CHECK(store.size() == 10);
+    uint32_t reused = 0, highest = 0;
+    for (uint32_t row = 0; row < 10; ++row) {
+        EntityHandle handle = store.handle(row);
+        CHECK(store.alive(handle));
+        CHECK(store.row(handle) == row);
+        if (handle.slot < 8) {
+            ++reused;
+            CHECK(handle.generation > old[handle.slot].generation);
+        }
+        highest = handle.slot > highest ? handle.slot : highest;
+    }
+    CHECK(reused == 8);
+    CHECK(highest == 9);                                // Only two fresh slots
+    for (const EntityHandle& handle : old) CHECK(!store.alive(handle));
+
+    // Partly reused: one retired slot, then fresh ones
+    store.destroy(store.handle(4));
+    first = store.append(3);
+    CHECK(first == 9);
+    CHECK(store.handle(9).slot < 10);
+    CHECK(store.handle(10).slot == 10 && store.handle(11).slot == 11);
+    CHECK(store.create(PoolHandle<Sphere>()).slot == 12);
+}
+
+int main() {
+    checkHandles();
+    checkAppendReuse();
+    return CHECK_RESULT();
+}
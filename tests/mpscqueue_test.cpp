@@ -0,0 +1,75 @@
+#include "check.h"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "Renderer/mpscqueue.h"
+
+static std::atomic<int> payloads{0};      // Touched by the producer threads too
+
+// Move-only item whose payload is counted (leaks and double frees show up)
+struct Item {
+    int producer = -1;
+    int sequence = 0;
+    std::unique_ptr<int, void (*)(int*)> payload{nullptr, [](int* p) { --payloads; delete p; }};
+
+    void fill(int p, int s) {
+        producer = p;
+        sequence = s;
+        payload.reset(new int(s));
+        ++payloads;
+    }
+};
+
+int main() {
+    const int PRODUCERS = 4;
+    const int ITEMS = 100000;
+
+    {
+        MpscQueue<Item> queue;
+        Item item;
+        CHECK(!queue.pop(item));                    // Empty
+
+        // Every item arrives once, in push order per producer
+        std::vector<std::thread> producers;
+        for (int p = 0; p < PRODUCERS; ++p)
+            producers.emplace_back([&queue, p] {
+                for (int i = 0; i < ITEMS; ++i) {
+                    Item pushed;
+                    pushed.fill(p, i);
+                    queue.push(std::move(pushed));
+                }
+            });
+
+        std::vector<int> next(PRODUCERS, 0);
+        long received = 0;
+        bool ordered = true;
+        while (received < (long)PRODUCERS * ITEMS) {
+            if (!queue.pop(item)) {
+                std::this_thread::yield();
+                continue;
+            }
+            if (item.sequence != next[item.producer] || *item.payload != item.sequence) ordered = false;
+            next[item.producer] = item.sequence + 1;
+            ++received;
+        }
+        for (std::thread& producer : producers) producer.join();
+        CHECK(ordered);
+        CHECK(!queue.pop(item));
+
+        // Single thread: FIFO, then leftovers freed by the destructor
+        for (int i = 0; i < 3; ++i) {
+            Item pushed;
+            pushed.fill(0, i);
+            queue.push(std::move(pushed));
+        }
+        CHECK(queue.pop(item) && item.sequence == 0);
+        CHECK(queue.pop(item) && item.sequence == 1);
+        item.payload.reset();
+    }
+    CHECK(payloads == 0);
+
+    return CHECK_RESULT();
+}
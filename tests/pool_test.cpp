@@ -0,0 +1,63 @@
+#include "check.h"
+
+#include <string>
+#include <vector>
+
+#include "Renderer/pool.h"
+
+static int live = 0;
+
+// Counts constructions / destructions so leaks and double frees show up
+struct Tracked {
+    std::string name;
+    explicit Tracked(std::string text) : name(std::move(text)) { ++live; }
+    ~Tracked() { --live; }
+};
+
+int main() {
+    {
+        Pool<Tracked, 4> pool;
+        std::vector<PoolHandle<Tracked>> handles;
+        for (int i = 0; i < 10; ++i) handles.push_back(pool.create("object " + std::to_string(i)));
+        CHECK(pool.size() == 10);
+        CHECK(pool.capacity() == 12);               // Three blocks of four
+
+        // Growing never moves an object
+        Tracked* kept = pool.get(handles[1]);
+        for (int i = 0; i < 100; ++i) pool.create("grow");
+        CHECK(pool.get(handles[1]) == kept);
+        CHECK(kept->name == "object 1");
+
+        // A destroyed handle goes stale, and stays stale once its slot is reused
+        pool.destroy(handles[3]);
+        CHECK(!pool.alive(handles[3]));
+        CHECK(pool.get(handles[3]) == nullptr);
+        PoolHandle<Tracked> reused = pool.create("reuse");
+        CHECK(reused.index == handles[3].index);
+        CHECK(reused.generation != handles[3].generation);
+        CHECK(!pool.alive(handles[3]));
+        pool.destroy(handles[3]);                   // Stale: ignored
+        CHECK(pool.alive(reused));
+        CHECK(!pool.alive(PoolHandle<Tracked>()));
+
+        size_t visited = 0;
+        pool.forEach([&](PoolHandle<Tracked> handle, Tracked& object) {
+            CHECK(pool.get(handle) == &object);
+            ++visited;
+        });
+        CHECK(visited == pool.size());
+        CHECK(visited == 110);
+
+        // clear() destroys everything but keeps the blocks
+        size_t capacity = pool.capacity();
+        pool.clear();
+        CHECK(pool.size() == 0);
+        CHECK(live == 0);
+        CHECK(pool.capacity() == capacity);
+        CHECK(!pool.alive(reused));
+        pool.create("after clear");
+    }
+    CHECK(live == 0);                               // The destructor frees what is left
+
+    return CHECK_RESULT();
+}
@@ -0,0 +1,113 @@
+// Save a random scene, then time loading it up to the first renderable frame
+// (open, instantiate, first transform update and the entity column refresh).
+// Usage: scene_benchmark [count] [path]
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <sys/stat.h>
+
+#include "Renderer/scene.h"
+
+// Random scene: 4 prototypes, 1 in 10 spheres parented to an earlier one,
+// 1 in 4 rotated and scaled, 1 in 100 a light source. The load is timed from a warm page cache.
+int main(int argc, char** argv) {
+    using Clock = std::chrono::steady_clock;
+    size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+    std::string path = argc > 2 ? argv[2] : "scene_benchmark.bin";
+    auto ms = [](Clock::time_point since) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - since).count();
+    };
+
+    double saveMs;
+    {
+        std::mt19937 rng(5);
+        std::uniform_real_distribution<double> coord(-1.0e4, 1.0e4);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        std::vector<glm::dvec3> positions(count);
+        std::vector<glm::quat> rotations(count, glm::quat(1.0f, 0.0f, 0.0f, 0.0f));
+        std::vector<glm::vec3> scales(count, glm::vec3(1.0f));
+        std::vector<uint32_t> parents(count, SceneFile::NONE), prototypeIndex(count), flags(count, 0);
+        std::vector<glm::vec3> colors(count);
+        std::vector<float> opacity(count, 1.0f), lightRange(count, 10.0f);
+        for (size_t i = 0; i < count; ++i) {
+            positions[i] = glm::dvec3(coord(rng), coord(rng), coord(rng));
+            if (i > 0 && rng() % 10 == 0) {
+                parents[i] = (uint32_t)(rng() % i);
+                positions[i] *= 1.0e-3;
+            }
+            if (rng() % 4 == 0) {
+                rotations[i] = glm::angleAxis(unit(rng) * 6.28f, glm::vec3(0.0f, 1.0f, 0.0f));
+                scales[i] = glm::vec3(0.5f + unit(rng));
+            }
+            prototypeIndex[i] = rng() % 4;
+            colors[i] = glm::vec3(unit(rng), unit(rng), unit(rng));
+            if (rng() % 100 == 0) flags[i] = ENTITY_SOURCE;
+        }
+        ScenePrototype prototypes[4];
+        for (uint32_t p = 0; p < 4; ++p) {
+            prototypes[p].radius = 0.25f * (p + 1);
+            std::snprintf(prototypes[p].name, sizeof(prototypes[p].name), "Benchmark %u", p);
+        }
+        SceneColumns columns;
+        columns.count = count;
+        columns.positions = positions.data();
+        columns.rotations = rotations.data();
+        columns.scales = scales.data();
+        columns.parents = parents.data();
+        columns.prototypes = prototypeIndex.data();
+        columns.colors = colors.data();
+        columns.opacity = opacity.data();
+        columns.lightRange = lightRange.data();
+        columns.flags = flags.data();
+
+        Clock::time_point start = Clock::now();
+        if (!SceneFile::save(path, columns, prototypes, 4, 0)) return 1;
+        saveMs = ms(start);
+    }
+    struct stat info;
+    double megabytes = stat(path.c_str(), &info) == 0 ? info.st_size / (1024.0 * 1024.0) : 0.0;
+
+    SceneFile file;
+    EntityStore entities;
+    TransformHierarchy transforms;
+    std::vector<EntityHandle> nodeEntity;
+    Clock::time_point start = Clock::now();
+    bool opened = file.open(path);
+    double openMs = ms(start);
+    double instantiateMs = 0.0, updateMs = 0.0, refreshMs = 0.0;
+    if (opened) {
+        start = Clock::now();
+        file.instantiate(entities, transforms, nodeEntity);
+        instantiateMs = ms(start);
+        start = Clock::now();
+        transforms.update(glm::dvec3(0.0));
+        updateMs = ms(start);
+        // Copy the world results into the entity columns, as Renderer::updateRenderOrigin() does
+        start = Clock::now();
+        for (uint32_t node : transforms.updated()) {
+            EntityHandle handle = nodeEntity[node];
+            if (!entities.alive(handle)) continue;
+            uint32_t row = entities.row(handle);
+            entities.worldPosition[row] = transforms.worldPosition(node);
+            entities.position[row] = glm::vec3(transforms.world(node)[3]);
+            entities.scale[row] = transforms.worldScale(node);
+        }
+        refreshMs = ms(start);
+    }
+    file.close();
+    std::remove(path.c_str());
+
+    bool ok = opened && entities.size() == count;
+    std::cout << "SCENE: n " << count << " | " << megabytes << " MB"
+              << " | save " << saveMs << " ms"
+              << " | first renderable " << openMs + instantiateMs + updateMs + refreshMs << " ms"
+              << " (map + verify " << openMs << ", instantiate " << instantiateMs
+              << ", transform update " << updateMs << ", entity refresh " << refreshMs << ")"
+              << (ok ? "" : " | FAILED") << std::endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,181 @@
+#include "check.h"
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "Renderer/scene.h"
+
+static const char* PATH = "scene_test.bin";
+
+// Three spheres: a light far from the origin, a child of it, a grandchild
+struct TestScene {
+    glm::dvec3     positions[3] = {{1.0e9, 2.0, 3.0}, {1.0, 0.0, 0.0}, {0.0, 1.0, 0.0}};
+    glm::quat      rotations[3] = {glm::quat(1.0f, 0.0f, 0.0f, 0.0f), glm::quat(0.0f, 0.0f, 0.0f, 1.0f),
+                                   glm::quat(1.0f, 0.0f, 0.0f, 0.0f)};     // 180 degrees about z
+    glm::vec3      scales[3] = {glm::vec3(1.0f), glm::vec3(2.0f), glm::vec3(0.5f, 1.0f, 1.0f)};
+    uint32_t       parents[3] = {SceneFile::NONE, 0, 1};
+    uint32_t       prototypeIndex[3] = {0, 1, 0};
+    glm::vec3      colors[3] = {{1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 1.0f}};
+    float          opacity[3] = {1.0f, 0.5f, 1.0f};
+    float          lightRange[3] = {7.0f, 10.0f, 10.0f};
+    uint32_t       flags[3] = {ENTITY_SOURCE | ENTITY_REMESH, 0, ENTITY_DYNAMIC};   // REMESH is not saved
+    ScenePrototype prototypes[2];
+
+    TestScene() {
+        prototypes[0].radius = 0.3f;
+        prototypes[1].radius = 8.0f;
+        prototypes[1].hasAtmosphere = 1;
+    }
+
+    SceneColumns columns() const {
+        SceneColumns c;
+        c.count = 3;
+        c.positions = positions;
+        c.rotations = rotations;
+        c.scales = scales;
+        c.parents = parents;
+        c.prototypes = prototypeIndex;
+        c.colors = colors;
+        c.opacity = opacity;
+        c.lightRange = lightRange;
+        c.flags = flags;
+        return c;
+    }
+
+    bool save() const { return SceneFile::save(PATH, columns(), prototypes, 2, 0); }
+};
+
+// Overwrite one byte at `offset` from the start (or the end when negative)
+static void corrupt(long offset, char byte = 0x55) {
+    std::fstream file(PATH, std::ios::in | std::ios::out | std::ios::binary);
+    file.seekp(offset, offset < 0 ? std::ios::end : std::ios::beg);
+    file.write(&byte, 1);
+}
+
+// Save, open, then instantiate next to an existing entity
+static void checkRoundTrip() {
+    TestScene scene;
+    CHECK(scene.save());
+
+    SceneFile file;
+    CHECK(file.open(PATH));
+    const SceneColumns& view = file.columns();
+    CHECK(view.count == 3);
+    CHECK(view.positions[0].x == 1.0e9);
+    CHECK(view.rotations[1] == glm::quat(0.0f, 0.0f, 0.0f, 1.0f));
+    CHECK(view.scales[2] == glm::vec3(0.5f, 1.0f, 1.0f));
+    CHECK(view.parents[2] == 1);
+    CHECK(view.colors[2].z == 1.0f);
+    CHECK(view.opacity[1] == 0.5f);
+    CHECK(view.lightRange[0] == 7.0f);
+    CHECK((uintptr_t)view.positions % SceneFile::ALIGNMENT == 0);
+    CHECK(file.lightSphere() == 0);
+    CHECK(file.prototypeCount() == 2);
+    CHECK(file.prototypes()[1].radius == 8.0f);
+    CHECK(file.prototypes()[1].hasAtmosphere == 1);
+
+    EntityStore entities;
+    TransformHierarchy transforms;
+    std::vector<EntityHandle> nodeEntity;
+    entities.create(PoolHandle<Sphere>());
+    uint32_t first = file.instantiate(entities, transforms, nodeEntity);
+    transforms.update(glm::dvec3(0.0));
+    CHECK(first == 1);
+    CHECK(entities.size() == 4);
+    CHECK(entities.flags[first] == ENTITY_SOURCE);
+    CHECK(entities.flags[first + 2] == ENTITY_DYNAMIC);
+    CHECK(entities.color[first + 1] == glm::vec3(0.0f, 1.0f, 0.0f));
+    CHECK(entities.opacity[first + 1] == 0.5f);
+    // Grandchild: (0, 1, 0) under a parent turned 180 degrees about z and scaled 2
+    CHECK(transforms.worldPosition(entities.transform[first + 2]) == glm::dvec3(1.0e9 + 1.0, 0.0, 3.0));
+    CHECK(transforms.getScale(entities.transform[first + 2]) == glm::vec3(0.5f, 1.0f, 1.0f));
+    CHECK(transforms.worldScale(entities.transform[first + 2]) == 2.0f);
+    CHECK(entities.row(nodeEntity[entities.transform[first + 1]]) == first + 1);
+    file.close();
+}
+
+// Into an empty scene the columns stay in the mapping: they outlive close(),
+// and edits and growth never reach the file
+static void checkAdoption() {
+    TestScene scene;
+    CHECK(scene.save());
+
+    EntityStore entities;
+    TransformHierarchy transforms;
+    std::vector<EntityHandle> nodeEntity;
+    {
+        SceneFile file;
+        CHECK(file.open(PATH));
+        CHECK(file.instantiate(entities, transforms, nodeEntity) == 0);
+    }
+    CHECK(entities.color.adopted() && entities.flags.adopted());
+    CHECK(entities.flags[0] == ENTITY_SOURCE);          // Masked in place
+    CHECK(entities.color[2] == glm::vec3(0.0f, 0.0f, 1.0f));
+    CHECK(transforms.getParent(2) == 1);
+    CHECK(transforms.getRotation(1) == glm::quat(0.0f, 0.0f, 0.0f, 1.0f));
+
+    entities.color[1] = glm::vec3(0.25f);
+    transforms.setPosition(0, glm::dvec3(5.0, 0.0, 0.0));
+    EntityHandle added = entities.create(PoolHandle<Sphere>());   // Grows: copied out of the mapping
+    uint32_t node = transforms.create(glm::dvec3(0.0, 0.0, 1.0), 2);
+    transforms.update(glm::dvec3(0.0));
+    CHECK(!entities.color.adopted());
+    CHECK(entities.color[1] == glm::vec3(0.25f) && entities.color[2] == glm::vec3(0.0f, 0.0f, 1.0f));
+    CHECK(entities.row(added) == 3);
+    // Under the child turned 180 degrees about z and scaled 2
+    CHECK(transforms.worldPosition(2) == glm::dvec3(6.0, -2.0, 0.0));
+    CHECK(transforms.worldPosition(node) == glm::dvec3(6.0, -2.0, 2.0));
+
+    SceneFile reopened;
+    CHECK(reopened.open(PATH));
+    CHECK(reopened.columns().flags[0] == (ENTITY_SOURCE | ENTITY_REMESH));
+    CHECK(reopened.columns().colors[1] == glm::vec3(0.0f, 1.0f, 0.0f));
+    CHECK(reopened.columns().positions[0].x == 1.0e9);
+}
+
+// Damaged or inconsistent files are refused
+static void checkRejection() {
+    TestScene scene;
+    SceneFile file;
+
+    CHECK(!file.open("scene_test_missing.bin"));
+
+    CHECK(scene.save());
+    corrupt(-5);                                    // Inside the last section
+    CHECK(!file.open(PATH));
+
+    CHECK(scene.save());
+    corrupt(20);                                    // Inside the header
+    CHECK(!file.open(PATH));
+
+    CHECK(scene.save());
+    corrupt(8, 1);                                  // Version 1 (no rotation / scale sections)
+    CHECK(!file.open(PATH));
+
+    CHECK(scene.save());
+    { std::ofstream truncated(PATH, std::ios::binary | std::ios::trunc); truncated << "SPHSCENE"; }
+    CHECK(!file.open(PATH));
+
+    scene.parents[1] = 2;                           // Parent after its child
+    CHECK(scene.save());
+    CHECK(!file.open(PATH));
+    scene.parents[1] = 0;
+
+    scene.prototypeIndex[2] = 5;                    // Missing prototype
+    CHECK(scene.save());
+    CHECK(!file.open(PATH));
+    scene.prototypeIndex[2] = 0;
+
+    CHECK(scene.save());                            // Still readable after the failures
+    CHECK(file.open(PATH));
+}
+
+int main() {
+    checkRoundTrip();
+    checkAdoption();
+    checkRejection();
+    std::remove(PATH);
+    return CHECK_RESULT();
+}
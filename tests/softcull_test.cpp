@@ -0,0 +1,70 @@
+#include "check.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "Renderer/softcull.h"
+
+// One occluder at the origin seen from +z: bounds behind it are occluded,
+// bounds outside the frustum are frustum culled, the rest stay visible.
+// Bounds reaching the camera plane are kept, like the Hi-Z pass does
+static void checkCull(SoftwareOcclusion& occlusion) {
+    glm::mat4 projection = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 100.0f);
+    glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 0.0f, 10.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    glm::mat4 viewProjection = projection * view;
+
+    std::vector<glm::vec4> occluders = {{0.0f, 0.0f, 0.0f, 2.0f}};
+    std::vector<glm::vec4> bounds = {
+        {0.0f, 0.0f, 0.0f, 2.0f},       // 0: the occluder itself
+        {0.0f, 0.0f, -10.0f, 1.0f},     // 1: straight behind it
+        {8.0f, 0.0f, -10.0f, 1.0f},     // 2: behind, off to the side
+        {0.0f, 0.0f, 4.0f, 1.0f},       // 3: in front of it
+        {0.0f, 0.0f, -3.0f, 0.5f},      // 4: just behind it
+        {0.0f, 30.0f, 0.0f, 1.0f},      // 5: above the frustum
+        {0.0f, 0.0f, 20.0f, 1.0f},      // 6: behind the camera (kept: not projectable)
+        {0.0f, 0.0f, -200.0f, 1.0f}     // 7: beyond the far plane
+    };
+
+    occlusion.cull(occluders, bounds, viewProjection);
+
+    CHECK(occlusion.isVisible(0));
+    CHECK(!occlusion.isVisible(1));
+    CHECK(occlusion.isVisible(2));
+    CHECK(occlusion.isVisible(3));
+    CHECK(!occlusion.isVisible(4));
+    CHECK(!occlusion.isVisible(5));
+    CHECK(occlusion.isVisible(6));
+    CHECK(!occlusion.isVisible(7));
+    CHECK(occlusion.isVisible(bounds.size()));          // Past the end
+
+    const SoftCullStats& stats = occlusion.getStats();
+    CHECK(stats.tested == bounds.size());
+    CHECK(stats.occluded == 2);
+    CHECK(stats.frustumCulled == 2);
+    CHECK(stats.drawn == 4);
+    CHECK(stats.triangles > 0);
+
+    // Occluder depth at the centre, cleared depth in the corner
+    const float* depth = occlusion.depthBuffer();
+    int centre = (SoftwareOcclusion::HEIGHT / 2) * SoftwareOcclusion::WIDTH + SoftwareOcclusion::WIDTH / 2;
+    CHECK(depth[centre] < 1.0f);
+    CHECK(depth[0] == 1.0f);
+}
+
+int main() {
+    SoftwareOcclusion occlusion;
+
+    checkCull(occlusion);           // Main thread only (no workers)
+
+    occlusion.init(4);
+    CHECK(occlusion.workerCount() == 4);
+    checkCull(occlusion);
+    checkCull(occlusion);           // Second frame through the same workers
+
+    occlusion.terminate();
+    occlusion.init(2);              // Restart with another band count
+    checkCull(occlusion);
+    occlusion.terminate();
+    CHECK(occlusion.workerCount() == 0);
+
+    return CHECK_RESULT();
+}
@@ -0,0 +1,225 @@
+#include "check.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <cmath>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "Renderer/transforms.h"
+
+// Reference model: one record per node, world matrices by recursion in double
+struct Reference {
+    uint32_t   parent = TransformHierarchy::NONE;
+    glm::dvec3 position{0.0};
+    glm::quat  rotation{1.0f, 0.0f, 0.0f, 0.0f};
+    glm::vec3  scale{1.0f};
+};
+
+static std::map<uint32_t, Reference> reference;
+
+static glm::dmat4 referenceWorld(uint32_t node) {
+    const Reference& r = reference[node];
+    glm::dmat4 local = glm::translate(glm::dmat4(1.0), r.position) *
+                       glm::dmat4(glm::mat4_cast(r.rotation)) *
+                       glm::scale(glm::dmat4(1.0), glm::dvec3(r.scale));
+    return r.parent == TransformHierarchy::NONE ? local : referenceWorld(r.parent) * local;
+}
+
+// Every node's results against the reference
+static bool matches(const TransformHierarchy& hierarchy, const std::vector<uint32_t>& nodes, const glm::dvec3& origin) {
+    for (uint32_t node : nodes) {
+        glm::dmat4 expected = referenceWorld(node);
+        const glm::mat4& world = hierarchy.world(node);
+        for (int c = 0; c < 3; ++c)
+            for (int r = 0; r < 3; ++r)
+                if (std::abs(expected[c][r] - world[c][r]) > 1e-3) return false;
+        glm::dvec3 translation(expected[3]);
+        if (glm::length(translation - hierarchy.worldPosition(node)) > 1e-6) return false;
+        if (glm::length(glm::dvec3(glm::vec3(world[3])) - (translation - origin)) > 1e-2) return false;
+    }
+    return true;
+}
+
+// Random creates, destroys, reparents (optional) and edits, checked against the reference
+static void checkRandomEdits(unsigned int workers, bool reparent) {
+    reference.clear();
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+    TransformHierarchy hierarchy;
+    hierarchy.init(workers);
+    std::vector<uint32_t> nodes;
+    bool ok = true;
+    for (int step = 0; step < 4000 && ok; ++step) {
+        int op = (int)(rng() % 10);
+        if (op < 4 || nodes.size() < 3) {
+            uint32_t parent = nodes.empty() || rng() % 3 == 0 ? TransformHierarchy::NONE : nodes[rng() % nodes.size()];
+            glm::dvec3 position(unit(rng), unit(rng), unit(rng));
+            uint32_t node = hierarchy.create(position, parent);
+            Reference& r = reference[node];
+            r = Reference();
+            r.parent = parent;
+            r.position = position;
+            nodes.push_back(node);
+        } else if (op < 6) {
+            uint32_t node = nodes[rng() % nodes.size()];
+            glm::vec3 axis = glm::normalize(glm::vec3(unit(rng), unit(rng), unit(rng)) + glm::vec3(0.0f, 0.0f, 0.01f));
+            glm::quat rotation = glm::angleAxis(unit(rng) * 3.0f, axis);
+            glm::vec3 scale(1.0f + 0.5f * unit(rng));
+            hierarchy.setRotation(node, rotation);
+            hierarchy.setScale(node, scale);
+            reference[node].rotation = rotation;
+            reference[node].scale = scale;
+        } else if (op < 7) {
+            size_t k = rng() % nodes.size();
+            uint32_t node = nodes[k];
+            hierarchy.destroy(node);
+            for (auto& entry : reference)
+                if (entry.second.parent == node) entry.second.parent = TransformHierarchy::NONE;
+            reference.erase(node);
+            nodes.erase(nodes.begin() + k);
+        } else if (op < 8 && reparent) {
+            uint32_t node = nodes[rng() % nodes.size()], parent = nodes[rng() % nodes.size()];
+            if (hierarchy.setParent(node, parent)) reference[node].parent = parent;
+        } else {
+            uint32_t node = nodes[rng() % nodes.size()];
+            glm::dvec3 position(unit(rng), unit(rng), unit(rng));
+            hierarchy.setPosition(node, position);
+            reference[node].position = position;
+        }
+
+        if (step % 7 == 0 || step > 3990) {
+            glm::dvec3 origin = rng() % 5 == 0 ? glm::dvec3(unit(rng) * 100.0f, 0.0, 0.0) : glm::dvec3(0.0);
+            hierarchy.update(origin);
+            ok = matches(hierarchy, nodes, origin);
+        }
+    }
+    CHECK(ok);
+    CHECK(hierarchy.getStats().nodes == nodes.size());
+    if (!reparent) CHECK(hierarchy.getStats().reorders == 0);     // Creates and destroys sort in place
+}
+
+// Structure rules: cycles are refused, orphans keep their local transform
+static void checkStructure() {
+    TransformHierarchy hierarchy;
+    uint32_t root = hierarchy.create(glm::dvec3(1.0, 0.0, 0.0));
+    uint32_t child = hierarchy.create(glm::dvec3(0.0, 2.0, 0.0), root);
+    uint32_t grandchild = hierarchy.create(glm::dvec3(0.0, 0.0, 3.0), child);
+    hierarchy.update(glm::dvec3(0.0));
+    CHECK(hierarchy.worldPosition(grandchild) == glm::dvec3(1.0, 2.0, 3.0));
+    CHECK(hierarchy.getStats().levels == 3);
+
+    CHECK(!hierarchy.setParent(root, grandchild));  // Would form a cycle
+    CHECK(!hierarchy.setParent(root, root));
+    CHECK(hierarchy.getParent(root) == TransformHierarchy::NONE);
+
+    // Nothing dirty: no work, nothing reported
+    CHECK(!hierarchy.update(glm::dvec3(0.0)));
+    CHECK(hierarchy.updated().empty());
+
+    // Moving a parent recomputes its subtree only
+    uint32_t other = hierarchy.create(glm::dvec3(5.0, 0.0, 0.0));
+    hierarchy.update(glm::dvec3(0.0));
+    hierarchy.setPosition(child, glm::dvec3(0.0, 4.0, 0.0));
+    CHECK(hierarchy.update(glm::dvec3(0.0)));
+    CHECK(hierarchy.updated().size() == 2);
+    CHECK(hierarchy.worldPosition(grandchild) == glm::dvec3(1.0, 4.0, 3.0));
+
+    // Destroying the middle node turns its child into a root (local transform kept)
+    hierarchy.destroy(child);
+    hierarchy.update(glm::dvec3(0.0));
+    CHECK(hierarchy.getParent(grandchild) == TransformHierarchy::NONE);
+    CHECK(hierarchy.worldPosition(grandchild) == glm::dvec3(0.0, 0.0, 3.0));
+    CHECK(hierarchy.worldPosition(other) == glm::dvec3(5.0, 0.0, 0.0));
+
+    // Freed ids are reused
+    uint32_t reused = hierarchy.create(glm::dvec3(0.0), grandchild);
+    CHECK(reused == child);
+
+    // A moved render origin shifts every render-space matrix, not the double positions
+    hierarchy.update(glm::dvec3(100.0, 0.0, 0.0));
+    CHECK(hierarchy.worldPosition(other) == glm::dvec3(5.0, 0.0, 0.0));
+    CHECK(hierarchy.world(other)[3] == glm::vec4(-95.0f, 0.0f, 0.0f, 1.0f));
+
+    hierarchy.clear();
+    CHECK(hierarchy.create(glm::dvec3(0.0)) == 0);
+}
+
+// Bulk creation matches one-by-one creation
+static void checkBatch() {
+    std::vector<glm::dvec3> positions = {{1.0, 0.0, 0.0}, {0.0, 1.0, 0.0}, {0.0, 0.0, 1.0}, {2.0, 0.0, 0.0}};
+    std::vector<uint32_t> parents = {TransformHierarchy::NONE, 0, 1, TransformHierarchy::NONE};
+
+    TransformHierarchy hierarchy;
+    hierarchy.create(glm::dvec3(9.0));                     // Existing node before the batch
+    uint32_t first = hierarchy.createBatch(positions.data(), nullptr, nullptr, parents.data(), positions.size());
+    CHECK(first == 1);
+    hierarchy.update(glm::dvec3(0.0));
+    CHECK(hierarchy.getParent(first + 2) == first + 1);
+    CHECK(hierarchy.worldPosition(first + 2) == glm::dvec3(1.0, 1.0, 1.0));
+    CHECK(hierarchy.worldPosition(first + 3) == glm::dvec3(2.0, 0.0, 0.0));
+    CHECK(hierarchy.worldPosition(0) == glm::dvec3(9.0));
+
+    // Local rotations and scales come along (180 degrees about z is exact in float)
+    std::vector<glm::quat> rotations = {glm::quat(0.0f, 0.0f, 0.0f, 1.0f), glm::quat(1.0f, 0.0f, 0.0f, 0.0f)};
+    std::vector<glm::vec3> scales = {glm::vec3(2.0f), glm::vec3(1.0f)};
+    std::vector<uint32_t> pair = {TransformHierarchy::NONE, 0};
+    uint32_t rotated = hierarchy.createBatch(positions.data(), rotations.data(), scales.data(), pair.data(), 2);
+    hierarchy.update(glm::dvec3(0.0));
+    CHECK(hierarchy.getRotation(rotated) == rotations[0]);
+    CHECK(hierarchy.getScale(rotated) == scales[0]);
+    CHECK(hierarchy.worldPosition(rotated + 1) == glm::dvec3(1.0, -2.0, 0.0));
+    CHECK(hierarchy.worldScale(rotated + 1) == 2.0f);
+}
+
+// Levels large enough for the workers give the same results as one thread
+static void checkParallel() {
+    TransformHierarchy pooled, single;
+    pooled.init(4);
+    single.init(1);
+    std::vector<uint32_t> nodes;
+    for (int i = 0; i < (1 << 15); ++i) {
+        uint32_t root = pooled.create(glm::dvec3(i, 0.0, 0.0));
+        single.create(glm::dvec3(i, 0.0, 0.0));
+        nodes.push_back(root);
+        for (int c = 0; c < 3; ++c) {
+            nodes.push_back(pooled.create(glm::dvec3(0.0, c, 0.0), root));
+            single.create(glm::dvec3(0.0, c, 0.0), root);
+        }
+    }
+    pooled.setRotation(nodes[0], glm::angleAxis(1.0f, glm::vec3(0.0f, 0.0f, 1.0f)));
+    single.setRotation(nodes[0], glm::angleAxis(1.0f, glm::vec3(0.0f, 0.0f, 1.0f)));
+    pooled.update(glm::dvec3(64.0, 0.0, 0.0));
+    single.update(glm::dvec3(64.0, 0.0, 0.0));
+    CHECK(pooled.workerCount() == 4);
+    CHECK(pooled.getStats().updated == nodes.size());
+    CHECK(pooled.updated().size() == nodes.size());
+
+    bool same = true;
+    for (uint32_t node : nodes)
+        same = same && pooled.world(node) == single.world(node) && pooled.worldPosition(node) == single.worldPosition(node);
+    CHECK(same);
+}
+
+// Local offsets keep double precision below a float parent matrix
+static void checkPrecision() {
+    TransformHierarchy hierarchy;
+    uint32_t root = hierarchy.create(glm::dvec3(1.0e9, 0.0, 0.0));
+    hierarchy.setScale(root, glm::vec3(2.0f));
+    uint32_t child = hierarchy.create(glm::dvec3(1.0e7 + 0.25, 0.0, 0.125), root);  // Not representable as float
+    hierarchy.update(glm::dvec3(1.0e9, 0.0, 0.0));
+    CHECK(hierarchy.worldPosition(child) == glm::dvec3(1.0e9 + 2.0e7 + 0.5, 0.0, 0.25));
+    CHECK(hierarchy.world(child)[3] == glm::vec4(2.0e7f + 0.5f, 0.0f, 0.25f, 1.0f));
+}
+
+int main() {
+    checkRandomEdits(1, true);
+    checkRandomEdits(4, true);
+    checkRandomEdits(1, false);
+    checkStructure();
+    checkPrecision();
+    checkBatch();
+    checkParallel();
+    return CHECK_RESULT();
+}